@@ -0,0 +1,287 @@
+#include "arena.h"
+
+/**
+ * Arena Chunk is a single contiguous block of memory from which the objects of
+ * one kind are handed out. The usable memory starts right after the header.
+ * @param   size    Usable size of this chunk in bytes.
+ * @param   used    Bytes already handed out from this chunk.
+ * @param   next    Previously filled chunk of the same kind.
+ */
+// typedef struct arena_chunk {
+//     size_t size;
+//     size_t used;
+//     struct arena_chunk * next;
+// } arena_chunk;
+
+/**
+ * Arena Pool is a single reservation of ARENA_POOL_SIZE bytes of address
+ * space, committed a chunk at a time as objects are handed out. Objects of a
+ * pooled kind never move and are all in one block, so they can be addressed
+ * by their index from the base.
+ * @param   base        Start of the reservation, NULL until the first object.
+ * @param   used        Bytes handed out.
+ * @param   committed   Bytes that can be read and written.
+ */
+// typedef struct arena_pool {
+//     char * base;
+//     size_t used;
+//     size_t committed;
+// } arena_pool;
+
+/**
+ * Arena owns every node, parameter, identifier string and function of a
+ * program.
+ * Each kind of object gets its own list of chunks so that objects of the same
+ * kind end up next to each other, and everything is released in one call.
+ * The nodes and their lines are pooled instead.
+ * @param   chunks      Current chunk of each kind of object.
+ * @param   pools       Pool of each pooled kind of object.
+ * @param   counts      Amount of objects handed out of each kind.
+ * @param   bytes       Bytes handed out of each kind.
+ * @param   reserved    Bytes reserved from the system for each kind.
+ * @param   interned    Amount of interned strings.
+ * @param   buckets     Amount of buckets of the interned strings.
+ * @param   strings     Interned strings, an open addressing hash table.
+ */
+// typedef struct arena {
+//     struct arena_chunk * chunks[ARENA_KINDS];
+//     struct arena_pool pools[ARENA_POOLS];
+//     size_t counts[ARENA_KINDS];
+//     size_t bytes[ARENA_KINDS];
+//     size_t reserved[ARENA_KINDS];
+//     size_t interned;
+//     size_t buckets;
+//     char ** strings;
+// } arena;
+
+// Global Values. Each thread allocates in its own arena, such as a parser.
+_Thread_local arena * global_arena;
+
+/**
+ * Arena Initialize returns an empty arena, chunks are reserved on demand.
+ * @return  Initialized arena pointer.
+ */
+arena * arena_initialize() {
+    arena * region;
+    region = (arena *)calloc(1, sizeof(arena));
+    return region;
+}
+
+/**
+ * Arena Chunk Create reserves a zeroed chunk with room for size bytes.
+ * @param   size    Usable size of the chunk.
+ * @return  Chunk created.
+ */
+arena_chunk * arena_chunk_create(size_t size) {
+    arena_chunk * chunk;
+    chunk = (arena_chunk *)calloc(1, sizeof(arena_chunk) + size);
+    if (chunk == NULL) {
+        printf("Arena: Out of memory.\n");
+        exit(EXIT_FAILURE);
+    }
+    chunk->size = size;
+    chunk->used = 0;
+    chunk->next = NULL;
+    return chunk;
+}
+
+/**
+ * Arena Allocate hands out zeroed memory of the kind given. Objects are bump
+ * allocated from the current chunk of their kind, and a new chunk is reserved
+ * once it is full. Requests larger than a chunk get a chunk of their own.
+ * @param   region  Arena to allocate from.
+ * @param   kind    Kind of the object, used for the statistics.
+ * @param   size    Size of the object.
+ * @return  Pointer to the object.
+ */
+void * arena_allocate(arena * region, int kind, size_t size) {
+    if (kind != ARENA_STRING && kind != ARENA_LINE)
+        size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    if (kind < ARENA_POOLS) return arena_pool_allocate(region, kind, size);
+
+    arena_chunk * chunk = region->chunks[kind];
+    if (chunk == NULL || chunk->used + size > chunk->size) {
+        size_t reserve = size > ARENA_CHUNK_SIZE ? size : ARENA_CHUNK_SIZE;
+        chunk = arena_chunk_create(reserve);
+        chunk->next = region->chunks[kind];
+        region->chunks[kind] = chunk;
+        region->reserved[kind] += reserve;
+    }
+
+    void * pointer = (char *)(chunk + 1) + chunk->used;
+    chunk->used += size;
+    region->counts[kind] ++;
+    region->bytes[kind] += size;
+    return pointer;
+}
+
+/**
+ * Arena Pool Allocate hands out zeroed memory from the pool of a kind. The
+ * address space is reserved without memory the first time, and the pages
+ * that are fresh from the system are already zero.
+ * @param   region  Arena to allocate from.
+ * @param   kind    Pooled kind of the object.
+ * @param   size    Size of the object, already aligned.
+ * @return  Pointer to the object.
+ */
+void * arena_pool_allocate(arena * region, int kind, size_t size) {
+    arena_pool * pool = &region->pools[kind];
+    if (pool->base == NULL) {
+        void * base = mmap(NULL, ARENA_POOL_SIZE, PROT_NONE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (base == MAP_FAILED) {
+            printf("Arena: Out of memory.\n");
+            exit(EXIT_FAILURE);
+        }
+        pool->base = (char *)base;
+    }
+
+    if (pool->used + size > pool->committed) {
+        size_t commit = (pool->used + size - pool->committed
+            + ARENA_CHUNK_SIZE - 1) & ~(size_t)(ARENA_CHUNK_SIZE - 1);
+        if (pool->committed + commit > ARENA_POOL_SIZE
+            || mprotect(pool->base + pool->committed, commit,
+                PROT_READ | PROT_WRITE) != 0) {
+            printf("Arena: Out of memory.\n");
+            exit(EXIT_FAILURE);
+        }
+        pool->committed += commit;
+        region->reserved[kind] += commit;
+    }
+
+    void * pointer = pool->base + pool->used;
+    pool->used += size;
+    region->counts[kind] ++;
+    region->bytes[kind] += size;
+    return pointer;
+}
+
+/**
+ * Arena Strdup copies a string into the arena.
+ * @param   region  Arena to allocate from.
+ * @param   string  String to copy.
+ * @return  Copy of the string.
+ */
+char * arena_strdup(arena * region, const char * string) {
+    size_t length = strlen(string) + 1;
+    char * copy = (char *)arena_allocate(region, ARENA_STRING, length);
+    memcpy(copy, string, length);
+    return copy;
+}
+
+/**
+ * Arena Intern returns the single copy in the arena of a string that is not
+ * terminated, copying it the first time it is seen. The scanner uses it for
+ * identifiers, so a name used many times takes the memory of one, and every
+ * use of it is the same pointer. The table of strings doubles once it would
+ * be half full.
+ * @param   region  Arena to allocate from.
+ * @param   string  Characters of the string.
+ * @param   length  Amount of characters.
+ * @return  Interned copy of the string.
+ */
+char * arena_intern(arena * region, const char * string, size_t length) {
+    size_t i;
+    unsigned int key = ARENA_FNV_BASIS;
+    for (i=0; i<length; i++)
+        key = (key ^ (unsigned char)string[i]) * ARENA_FNV_PRIME;
+
+    if (2 * (region->interned + 1) > region->buckets) {
+        size_t buckets = region->buckets;
+        char ** strings = region->strings;
+        region->buckets = buckets == 0 ? ARENA_INTERN_SIZE : 2 * buckets;
+        region->strings = (char **)calloc(region->buckets, sizeof(char *));
+        if (region->strings == NULL) {
+            printf("Arena: Out of memory.\n");
+            exit(EXIT_FAILURE);
+        }
+        for (i=0; i<buckets; i++) {
+            if (strings[i] == NULL) continue;
+            unsigned int old = ARENA_FNV_BASIS;
+            char * c;
+            for (c = strings[i]; *c != '\0'; c++)
+                old = (old ^ (unsigned char)*c) * ARENA_FNV_PRIME;
+            size_t curr = old & (region->buckets - 1);
+            while (region->strings[curr] != NULL)
+                curr = (curr + 1) & (region->buckets - 1);
+            region->strings[curr] = strings[i];
+        }
+        free(strings);
+    }
+
+    size_t curr = key & (region->buckets - 1);
+    while (region->strings[curr] != NULL) {
+        char * interned = region->strings[curr];
+        if (strncmp(interned, string, length) == 0
+            && interned[length] == '\0') return interned;
+        curr = (curr + 1) & (region->buckets - 1);
+    }
+
+    char * copy = (char *)arena_allocate(region, ARENA_STRING, length + 1);
+    memcpy(copy, string, length);
+    copy[length] = '\0';
+    region->strings[curr] = copy;
+    region->interned ++;
+    return copy;
+}
+
+/**
+ * Arena Release frees every chunk and pool of every kind and the arena
+ * itself.
+ * @param   region  Arena to release.
+ */
+void arena_release(arena * region) {
+    if (region == NULL) return;
+
+    int i;
+    for (i=0; i<ARENA_KINDS; i++) {
+        arena_chunk * chunk = region->chunks[i];
+        while (chunk != NULL) {
+            arena_chunk * next = chunk->next;
+            free(chunk);
+            chunk = next;
+        }
+    }
+    for (i=0; i<ARENA_POOLS; i++)
+        if (region->pools[i].base != NULL)
+            munmap(region->pools[i].base, ARENA_POOL_SIZE);
+    free(region->strings);
+    free(region);
+}
+
+/**
+ * Simple print function to format and print the usage of the arena.
+ * @param   region  Arena.
+ */
+void arena_print(arena * region) {
+    int i;
+    size_t counts = 0;
+    size_t bytes = 0;
+    size_t reserved = 0;
+    char * names[ARENA_KINDS] = {
+        "node", "line", "param", "string", "function", "list"
+    };
+    char headerk[] = "kind";
+    char headerc[] = "count";
+    char headerb[] = "bytes";
+    char headerr[] = "reserved";
+    char footert[] = "total";
+
+    printf("\n");
+    printf("Memory Statistics:\n");
+    printf("%10s%12s%12s%12s", headerk, headerc, headerb, headerr);
+    printf("\n\n");
+
+    for (i=0; i<ARENA_KINDS; i++) {
+        printf("%10s", names[i]);
+        printf("%12zu", region->counts[i]);
+        printf("%12zu", region->bytes[i]);
+        printf("%12zu", region->reserved[i]);
+        printf("\n");
+        counts += region->counts[i];
+        bytes += region->bytes[i];
+        reserved += region->reserved[i];
+    }
+    printf("%10s%12zu%12zu%12zu\n", footert, counts, bytes, reserved);
+    printf("\n");
+}
@@ -0,0 +1,63 @@
+#ifndef _ARENAH_
+#define _ARENAH_
+
+// Imports
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <sys/mman.h>
+
+// Definitions
+#define ARENA_CHUNK_SIZE    65536
+#define ARENA_POOL_SIZE     ((size_t)1 << 34)
+#define ARENA_ALIGNMENT     8
+#define ARENA_INTERN_SIZE   256
+#define ARENA_FNV_BASIS     2166136261u
+#define ARENA_FNV_PRIME     16777619u
+
+// Object Kinds, the pooled ones first.
+#define ARENA_NODE          0
+#define ARENA_LINE          1
+#define ARENA_POOLS         2
+#define ARENA_PARAM         2
+#define ARENA_STRING        3
+#define ARENA_FUNCTION      4
+#define ARENA_LIST          5
+#define ARENA_KINDS         6
+
+// Declarations
+typedef struct arena_chunk {
+    size_t size;
+    size_t used;
+    struct arena_chunk * next;
+} arena_chunk;
+typedef struct arena_pool {
+    char * base;
+    size_t used;
+    size_t committed;
+} arena_pool;
+typedef struct arena {
+    struct arena_chunk * chunks[ARENA_KINDS];
+    struct arena_pool pools[ARENA_POOLS];
+    size_t counts[ARENA_KINDS];
+    size_t bytes[ARENA_KINDS];
+    size_t reserved[ARENA_KINDS];
+    size_t interned;
+    size_t buckets;
+    char ** strings;
+} arena;
+
+// Global Values.
+extern _Thread_local arena * global_arena;
+
+arena * arena_initialize();
+arena_chunk * arena_chunk_create(size_t);
+void * arena_allocate(arena *, int, size_t);
+void * arena_pool_allocate(arena *, int, size_t);
+char * arena_strdup(arena *, const char *);
+char * arena_intern(arena *, const char *, size_t);
+void arena_release(arena *);
+void arena_print(arena *);
+
+#endif
@@ -0,0 +1,285 @@
+#include "batch.h"
+
+/**
+ * Batch Job is a program of a manifest with the input it reads, and what was
+ * captured once it ran.
+ * @param   program     Program file.
+ * @param   input       Input file of the reads, NULL for an empty input.
+ * @param   output      Prints and errors of the job.
+ * @param   length      Length of the output.
+ * @param   accepted    Whether the program was parsed and run.
+ * @param   seconds     Time from opening the program to the end of its run.
+ */
+// typedef struct batch_job {
+//     char * program;
+//     char * input;
+//     char * output;
+//     size_t length;
+//     bool accepted;
+//     double seconds;
+// } batch_job;
+
+/**
+ * Batch Pool is what the worker threads share, the jobs and the index of the
+ * next one to take. Everything else a job needs is made by the worker that
+ * takes it.
+ * @param   jobs    Jobs of the manifest.
+ * @param   count   Amount of jobs.
+ * @param   next    Index of the next job to take.
+ * @param   passes  Optimizer passes to run on each program.
+ * @param   vm      Whether to run the programs on the bytecode machine.
+ * @param   lock    Lock of next.
+ */
+// typedef struct batch_pool {
+//     struct batch_job * jobs;
+//     int count;
+//     int next;
+//     int passes;
+//     bool vm;
+//     pthread_mutex_t lock;
+// } batch_pool;
+
+/**
+ * Batch Read Manifest reads the jobs of a manifest. Each line has a program
+ * and optionally the file its reads take their values from, blank lines and
+ * lines that start with # are skipped.
+ * @param   file    Manifest file.
+ * @param   count   Where to store the amount of jobs.
+ * @return  Array of the jobs, NULL if the manifest can not be read.
+ */
+batch_job * batch_read_manifest(char * file, int * count) {
+    char line[BATCH_LINE_SIZE];
+    char program[BATCH_LINE_SIZE];
+    char input[BATCH_LINE_SIZE];
+    int capacity = BATCH_JOBS_SIZE;
+    FILE * manifest = fopen(file, "r");
+    if (manifest == NULL) return NULL;
+
+    batch_job * jobs = (batch_job *)calloc(capacity, sizeof(batch_job));
+    *count = 0;
+    while (fgets(line, sizeof(line), manifest) != NULL) {
+        int fields = sscanf(line, "%4095s %4095s", program, input);
+        if (fields < 1 || program[0] == '#') continue;
+        if (*count == capacity) {
+            capacity *= 2;
+            jobs = (batch_job *)realloc(jobs, capacity * sizeof(batch_job));
+        }
+        if (jobs == NULL) {
+            printf("Batch: Out of memory.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        batch_job * job = &jobs[(*count) ++];
+        memset(job, 0, sizeof(batch_job));
+        job->program = strdup(program);
+        job->input = fields == 2 ? strdup(input) : NULL;
+    }
+    fclose(manifest);
+    return jobs;
+}
+
+/**
+ * Batch Next takes the index of the next job of the pool.
+ * @param   pool    Pool of the jobs.
+ * @return  Index of the job, -1 once every job was taken.
+ */
+int batch_next(batch_pool * pool) {
+    int index = -1;
+    pthread_mutex_lock(&pool->lock);
+    if (pool->next < pool->count) index = pool->next ++;
+    pthread_mutex_unlock(&pool->lock);
+    return index;
+}
+
+/**
+ * Batch Execute parses, optimizes and runs the program of a job on the calling
+ * thread. The job has its own parse context, arena, symbol table and streams,
+ * and the interpreter state is kept per thread, so jobs on other threads do
+ * not see it. Its prints and errors are captured in its output, and a runtime
+ * error unwinds back here, so only this job fails and the pool goes on.
+ * @param   pool    Pool of the jobs.
+ * @param   job     Job to run.
+ */
+void batch_execute(batch_pool * pool, batch_job * job) {
+    double start = profile_seconds();
+    FILE * output = open_memstream(&job->output, &job->length);
+    parse_context context = { 0 };
+    context.output = output;
+    int descriptor = -1;
+
+    if (!flex_open(&context, job->program))
+        fprintf(output, "Failed to open file.\n");
+    else if (job->input != NULL
+        && (descriptor = open(job->input, O_RDONLY)) < 0)
+        fprintf(output, "Failed to open input.\n");
+    else {
+        context.arena = arena_initialize();
+        if (bison_parse(&context) == 0) {
+            optimize_stats stats;
+            syntax_node * node = optimize_program(
+                context.node, context.table, pool->passes, &stats);
+            stream_open(descriptor, output);
+            syntax_prepare(context.table);
+            jmp_buf recover;
+            bytecode_program * volatile program = NULL;
+            bytecode_state * volatile state = NULL;
+            syntax_recover(&recover, output);
+            if (setjmp(recover) == 0) {
+                if (pool->vm) {
+                    program = bytecode_compile(node, context.table);
+                    state = bytecode_state_create();
+                    memcpy(state->registers, context.table->values,
+                        context.table->slots * sizeof(data_value));
+                    bytecode_run(program, state);
+                } else syntax_execute_nodetype(node);
+                job->accepted = true;
+            }
+            syntax_recover(NULL, NULL);
+            bytecode_state_release(state);
+            if (program != NULL) bytecode_release(program);
+            stream_close();
+        }
+        symbol_release(context.table);
+        arena_release(context.arena);
+    }
+
+    if (descriptor >= 0) close(descriptor);
+    flex_close(&context);
+    fclose(output);
+    job->seconds = profile_seconds() - start;
+}
+
+/**
+ * Batch Worker runs jobs of the pool until every job was taken.
+ * @param   argument    Pool of the jobs.
+ * @return  Nothing.
+ */
+void * batch_worker(void * argument) {
+    batch_pool * pool = (batch_pool *)argument;
+    int index;
+    while ((index = batch_next(pool)) >= 0)
+        batch_execute(pool, &pool->jobs[index]);
+    stream_release();
+    return NULL;
+}
+
+/**
+ * Batch Run runs the jobs of a manifest on a pool of worker threads, then
+ * prints the output of each job in the order of the manifest along with the
+ * throughput and the latency of the batch.
+ * @param   manifest    Manifest file.
+ * @param   threads     Amount of worker threads, 0 for one per core.
+ * @param   passes      Optimizer passes to run on each program.
+ * @param   vm          Whether to run the programs on the bytecode machine.
+ * @return  Whether the manifest could be read and the threads started.
+ */
+bool batch_run(char * manifest, int threads, int passes, bool vm) {
+    batch_pool pool;
+    pool.jobs = batch_read_manifest(manifest, &pool.count);
+    if (pool.jobs == NULL) {
+        printf("Failed to open manifest.\n");
+        return false;
+    }
+    pool.next = 0;
+    pool.passes = passes;
+    pool.vm = vm;
+    pthread_mutex_init(&pool.lock, NULL);
+
+    if (threads <= 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > pool.count) threads = pool.count;
+    if (threads > BATCH_THREADS_MAX) threads = BATCH_THREADS_MAX;
+    if (threads < 1) threads = 1;
+
+    // The main thread waits, each worker takes jobs until none is left.
+    int i;
+    int started = 0;
+    pthread_t workers[BATCH_THREADS_MAX];
+    double start = profile_seconds();
+    for (i=0; i<threads; i++)
+        if (pthread_create(&workers[i], NULL, batch_worker, &pool) == 0)
+            started ++;
+    if (started == 0) batch_worker(&pool);
+    for (i=0; i<started; i++) pthread_join(workers[i], NULL);
+    double seconds = profile_seconds() - start;
+
+    batch_print(&pool, started > 0 ? started : 1, seconds);
+    pthread_mutex_destroy(&pool.lock);
+    batch_release(pool.jobs, pool.count);
+    return true;
+}
+
+/**
+ * Batch Compare orders latencies from the least to the most for qsort.
+ * @param   one     First latency.
+ * @param   two     Second latency.
+ * @return  Negative, zero or positive like strcmp.
+ */
+int batch_compare(const void * one, const void * two) {
+    double a = *(const double *)one;
+    double b = *(const double *)two;
+    return (a > b) - (a < b);
+}
+
+/**
+ * Batch Percentile returns the nearest rank percentile of sorted latencies.
+ * @param   sorted  Latencies from the least to the most.
+ * @param   count   Amount of latencies.
+ * @param   rank    Percentile between 0 and 1.
+ * @return  Latency at the percentile.
+ */
+double batch_percentile(double * sorted, int count, double rank) {
+    if (count == 0) return 0;
+    int index = (int)(rank * count + 0.999999) - 1;
+    if (index < 0) index = 0;
+    if (index >= count) index = count - 1;
+    return sorted[index];
+}
+
+/**
+ * Batch Print prints the output of each job in the order of the manifest,
+ * after a line with its program, and then the totals of the batch.
+ * @param   pool    Pool of the jobs that ran.
+ * @param   threads Amount of worker threads.
+ * @param   seconds Wall time of the batch.
+ */
+void batch_print(batch_pool * pool, int threads, double seconds) {
+    int i;
+    int accepted = 0;
+    double * latencies = (double *)malloc((pool->count + 1) * sizeof(double));
+    for (i=0; i<pool->count; i++) {
+        batch_job * job = &pool->jobs[i];
+        printf("Job %d: %s %s in %.6f seconds\n", i + 1, job->program,
+            job->accepted ? "ran" : "failed", job->seconds);
+        if (job->length > 0) fwrite(job->output, 1, job->length, stdout);
+        if (job->accepted) accepted ++;
+        latencies[i] = job->seconds;
+    }
+    qsort(latencies, pool->count, sizeof(double), batch_compare);
+
+    printf("\n");
+    printf("Batch: %d jobs, %d ran, on %d threads in %.6f seconds\n",
+        pool->count, accepted, threads, seconds);
+    printf("Throughput: %.2f jobs/s\n",
+        seconds > 0 ? pool->count / seconds : 0);
+    printf("Latency: p50 %.6f p90 %.6f p99 %.6f max %.6f seconds\n",
+        batch_percentile(latencies, pool->count, 0.50),
+        batch_percentile(latencies, pool->count, 0.90),
+        batch_percentile(latencies, pool->count, 0.99),
+        batch_percentile(latencies, pool->count, 1.00));
+    free(latencies);
+}
+
+/**
+ * Batch Release frees the jobs of a manifest and their outputs.
+ * @param   jobs    Jobs to free.
+ * @param   count   Amount of jobs.
+ */
+void batch_release(batch_job * jobs, int count) {
+    int i;
+    for (i=0; i<count; i++) {
+        free(jobs[i].program);
+        free(jobs[i].input);
+        free(jobs[i].output);
+    }
+    free(jobs);
+}
@@ -0,0 +1,54 @@
+#ifndef _BATCHH_
+#define _BATCHH_
+
+// Imports
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "arena.h"
+#include "bytecode.h"
+#include "optimize.h"
+#include "profile.h"
+#include "stream.h"
+#include "symbol_table.h"
+#include "syntax_tree.h"
+#include "bison.tab.h"
+
+// Definitions
+#define BATCH_LINE_SIZE     4096
+#define BATCH_JOBS_SIZE     64
+#define BATCH_THREADS_MAX   256
+
+// Declarations
+typedef struct batch_job {
+    char * program;
+    char * input;
+    char * output;
+    size_t length;
+    bool accepted;
+    double seconds;
+} batch_job;
+typedef struct batch_pool {
+    struct batch_job * jobs;
+    int count;
+    int next;
+    int passes;
+    bool vm;
+    pthread_mutex_t lock;
+} batch_pool;
+
+batch_job * batch_read_manifest(char *, int *);
+int batch_next(batch_pool *);
+void batch_execute(batch_pool *, batch_job *);
+void * batch_worker(void *);
+bool batch_run(char *, int, int, bool);
+int batch_compare(const void *, const void *);
+double batch_percentile(double *, int, double);
+void batch_print(batch_pool *, int, double);
+void batch_release(batch_job *, int);
+
+#endif
@@ -0,0 +1,388 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+// Definitions
+#define BENCH_WARMUP            1
+#define BENCH_REPETITIONS       5
+#define BENCH_ARGUMENTS         32
+#define BENCH_STRAIGHT          100000
+#define BENCH_STRAIGHT_LOOPS    90
+#define BENCH_PARSE_STATEMENTS  2000000
+#define BENCH_COMPILER          "cc"
+
+// Declarations
+typedef struct bench_workload {
+    char * name;
+    char * file;
+    char * unit;
+    double ops;
+    char * option;
+} bench_workload;
+typedef struct bench_result {
+    double best;
+    double median;
+    double mean;
+    long peak_rss;
+} bench_result;
+
+/**
+ * Bench Workload is one program of the suite.
+ * @param   name    Name of the workload in the report.
+ * @param   file    Program to run.
+ * @param   unit    What an operation of this workload is.
+ * @param   ops     Amount of operations one run performs.
+ * @param   option  Option of the interpreter for this workload, or NULL.
+ */
+// typedef struct bench_workload {
+//     char * name;
+//     char * file;
+//     char * unit;
+//     double ops;
+//     char * option;
+// } bench_workload;
+
+/**
+ * Bench Result is the summary of the timed runs of a workload.
+ * @param   best        Fastest wall time in seconds.
+ * @param   median      Median wall time in seconds.
+ * @param   mean        Mean wall time in seconds.
+ * @param   peak_rss    Largest peak resident set of the runs in kilobytes.
+ */
+// typedef struct bench_result {
+//     double best;
+//     double median;
+//     double mean;
+//     long peak_rss;
+// } bench_result;
+
+// Global Values.
+char bench_straight[] = "/tmp/straight_benchXXXXXX";
+char bench_parse[] = "/tmp/parse_benchXXXXXX";
+char bench_source[] = "/tmp/compiled_benchXXXXXX.c";
+char bench_binary[] = "/tmp/compiled_benchXXXXXX";
+bench_workload bench_workloads[] = {
+    { "loop",     "bench/programs/loop",   "iterations", 5000000, NULL },
+    { "float",    "bench/programs/float",  "iterations", 5000000, NULL },
+    { "calls",    "bench/programs/calls",  "calls",      5000000, NULL },
+    { "ifelse",   "bench/programs/ifelse", "iterations", 4000000, NULL },
+    { "straight", bench_straight,          "statements",
+        (double)BENCH_STRAIGHT * BENCH_STRAIGHT_LOOPS, NULL },
+    { "parse",    bench_parse,             "bytes",      0, "--parse-only" },
+};
+
+/**
+ * Bench Seconds returns the monotonic clock in seconds.
+ * @return  Seconds elapsed since an arbitrary point.
+ */
+double bench_seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * Bench Write Straight generates the straight line workload, a loop whose
+ * body is a single list of BENCH_STRAIGHT assignments. It is generated
+ * instead of kept in the repository because of its size. The statements only
+ * shuffle values around, so the result is the same on every run.
+ */
+void bench_write_straight() {
+    int descriptor = mkstemp(bench_straight);
+    FILE * file = descriptor < 0 ? NULL : fdopen(descriptor, "w");
+    if (file == NULL) {
+        printf("Bench: Failed to create the straight line program.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    char * statements[] = { "a <- b + 1", "b <- a - 1", "c <- c + a - b" };
+    int i;
+    fprintf(file, "var i : int;\nvar a : int;\nvar b : int;\nvar c : int\n");
+    fprintf(file, "begin\n   i <- 0;\n   while (i < %d)\n   begin\n",
+        BENCH_STRAIGHT_LOOPS);
+    for (i=0; i<BENCH_STRAIGHT - 1; i++)
+        fprintf(file, "      %s;\n", statements[i % 3]);
+    fprintf(file, "      i <- i + 1\n   end;\n   print c\nend\n");
+    fclose(file);
+}
+
+/**
+ * Bench Write Parse generates the parse workload, a program whose body is a
+ * single list of BENCH_PARSE_STATEMENTS statements, which is only parsed.
+ * @return  Size of the program in bytes.
+ */
+double bench_write_parse() {
+    int descriptor = mkstemp(bench_parse);
+    FILE * file = descriptor < 0 ? NULL : fdopen(descriptor, "w");
+    if (file == NULL) {
+        printf("Bench: Failed to create the parse program.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    char * statements[] = {
+        "alpha <- beta + 17 * (gamma - 3)",
+        "beta <- alpha - beta / 5",
+        "if (alpha < beta) gamma <- gamma + 1",
+    };
+    int i;
+    fprintf(file, "var alpha : int;\nvar beta : int;\nvar gamma : int\nbegin\n");
+    for (i=0; i<BENCH_PARSE_STATEMENTS; i++)
+        fprintf(file, "   %s;\n", statements[i % 3]);
+    fprintf(file, "   print gamma\nend\n");
+    fclose(file);
+
+    struct stat status;
+    stat(bench_parse, &status);
+    return status.st_size;
+}
+
+/**
+ * Bench Run runs the interpreter once over a program, or any other command,
+ * with the standard streams on /dev/null so that only it is measured.
+ * @param   arguments   Arguments of the command, ending with NULL.
+ * @param   name        Name of the workload, used for errors.
+ * @param   peak_rss    Where to store the peak resident set in kilobytes.
+ * @return  Wall time in seconds.
+ */
+double bench_run(char * arguments[], char * name, long * peak_rss) {
+    double start = bench_seconds();
+    pid_t child = fork();
+    if (child < 0) {
+        printf("Bench: Failed to start the interpreter.\n");
+        exit(EXIT_FAILURE);
+    } else if (child == 0) {
+        int null = open("/dev/null", O_RDWR);
+        dup2(null, STDIN_FILENO);
+        dup2(null, STDOUT_FILENO);
+        execvp(arguments[0], arguments);
+        _exit(127);
+    }
+
+    int status;
+    struct rusage usage;
+    wait4(child, &status, 0, &usage);
+    double elapsed = bench_seconds() - start;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        printf("Bench: %s failed on %s.\n", arguments[0], name);
+        exit(EXIT_FAILURE);
+    }
+    *peak_rss = usage.ru_maxrss;
+    return elapsed;
+}
+
+/**
+ * Bench Compare orders wall times for qsort.
+ * @param   one     First time.
+ * @param   two     Second time.
+ * @return  Negative, zero or positive like strcmp.
+ */
+int bench_compare(const void * one, const void * two) {
+    double a = *(const double *)one;
+    double b = *(const double *)two;
+    return (a > b) - (a < b);
+}
+
+/**
+ * Bench Workload Run runs a workload warmup times without measuring it and then
+ * repetitions times measured.
+ * @param   arguments   Arguments of the interpreter, ending with NULL.
+ * @param   name        Name of the workload, used for errors.
+ * @param   warmup      Amount of runs discarded.
+ * @param   repetitions Amount of runs measured.
+ * @return  Summary of the measured runs.
+ */
+bench_result bench_workload_run(
+    char * arguments[], char * name, int warmup, int repetitions
+) {
+    int i;
+    long peak_rss;
+    bench_result result;
+    double * times = (double *)calloc(repetitions, sizeof(double));
+
+    for (i=0; i<warmup; i++) bench_run(arguments, name, &peak_rss);
+
+    result.mean = 0;
+    result.peak_rss = 0;
+    for (i=0; i<repetitions; i++) {
+        times[i] = bench_run(arguments, name, &peak_rss);
+        result.mean += times[i] / repetitions;
+        if (peak_rss > result.peak_rss) result.peak_rss = peak_rss;
+    }
+
+    qsort(times, repetitions, sizeof(double), bench_compare);
+    result.best = times[0];
+    result.median = repetitions % 2 == 1 ? times[repetitions / 2]
+        : (times[repetitions / 2 - 1] + times[repetitions / 2]) / 2;
+    free(times);
+    return result;
+}
+
+/**
+ * Bench Compile translates a workload to C with --emit-c and builds it with
+ * the system compiler into bench_binary.
+ * @param   interpreter Path of the interpreter.
+ * @param   compiler    Command of the C compiler.
+ * @param   workload    Workload to build.
+ */
+void bench_compile(
+    char * interpreter, char * compiler, bench_workload * workload
+) {
+    long peak_rss;
+    char * emit[] = {
+        interpreter, "--emit-c", bench_source, workload->file, NULL
+    };
+    char * build[] = {
+        compiler, "-O2", "-ffp-contract=off", bench_source,
+        "-o", bench_binary, NULL
+    };
+    bench_run(emit, workload->name, &peak_rss);
+    bench_run(build, workload->name, &peak_rss);
+}
+
+/**
+ * Bench Main runs every workload and prints a table, and optionally writes
+ * the results as JSON so that runs can be compared across commits. Options
+ * that are not its own are passed to the interpreter, e.g. --vm. With
+ * --compiled, the workloads that run are also translated with --emit-c and
+ * built with the C compiler, and the speedup of the binaries is printed.
+ *
+ *   runtime_bench.out [--interpreter path] [--warmup n] [--repetitions n]
+ *                     [--json file] [--label text] [--compiled] [--cc path]
+ *                     [interpreter options]
+ */
+int main(int argc, char * argv[]) {
+    int i, j;
+    char * interpreter = "./run.out";
+    char * json = NULL;
+    char * label = "";
+    char * compiler = BENCH_COMPILER;
+    int compiled = 0;
+    int warmup = BENCH_WARMUP;
+    int repetitions = BENCH_REPETITIONS;
+    char * options[BENCH_ARGUMENTS];
+    int count = 0;
+    char flags[1024] = "";
+
+    for (i=1; i<argc; i++) {
+        int has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--interpreter") == 0 && has_value)
+            interpreter = argv[++ i];
+        else if (strcmp(argv[i], "--warmup") == 0 && has_value)
+            warmup = atoi(argv[++ i]);
+        else if (strcmp(argv[i], "--repetitions") == 0 && has_value)
+            repetitions = atoi(argv[++ i]);
+        else if (strcmp(argv[i], "--json") == 0 && has_value)
+            json = argv[++ i];
+        else if (strcmp(argv[i], "--label") == 0 && has_value)
+            label = argv[++ i];
+        else if (strcmp(argv[i], "--compiled") == 0) compiled = 1;
+        else if (strcmp(argv[i], "--cc") == 0 && has_value)
+            compiler = argv[++ i];
+        else if (count < BENCH_ARGUMENTS - 3) {
+            options[count ++] = argv[i];
+            if (flags[0] != '\0')
+                strncat(flags, " ", sizeof(flags) - 1 - strlen(flags));
+            strncat(flags, argv[i], sizeof(flags) - 1 - strlen(flags));
+        }
+    }
+    if (repetitions < 1) repetitions = 1;
+    if (warmup < 0) warmup = 0;
+
+    bench_write_straight();
+    int workloads = sizeof(bench_workloads) / sizeof(bench_workload);
+    bench_workloads[workloads - 1].ops = bench_write_parse();
+    bench_result * results =
+        (bench_result *)calloc(workloads, sizeof(bench_result));
+    bench_result * binaries =
+        (bench_result *)calloc(workloads, sizeof(bench_result));
+    if (compiled) {
+        close(mkstemps(bench_source, 2));
+        close(mkstemp(bench_binary));
+    }
+
+    printf("%-10s %12s %12s %16s %12s\n",
+        "workload", "best (s)", "median (s)", "ops/s", "peak (KB)");
+    for (i=0; i<workloads; i++) {
+        char * arguments[BENCH_ARGUMENTS] = { NULL };
+        int used = 0;
+        arguments[used ++] = interpreter;
+        for (j=0; j<count; j++) arguments[used ++] = options[j];
+        if (bench_workloads[i].option != NULL)
+            arguments[used ++] = bench_workloads[i].option;
+        arguments[used ++] = bench_workloads[i].file;
+
+        results[i] = bench_workload_run(
+            arguments, bench_workloads[i].name, warmup, repetitions);
+        printf("%-10s %12.4f %12.4f %16.0f %12ld\n",
+            bench_workloads[i].name, results[i].best, results[i].median,
+            bench_workloads[i].ops / results[i].median, results[i].peak_rss);
+
+        // The binary takes the options of the interpreter it understands.
+        if (!compiled || bench_workloads[i].option != NULL) continue;
+        bench_compile(interpreter, compiler, &bench_workloads[i]);
+        arguments[0] = bench_binary;
+        binaries[i] = bench_workload_run(
+            arguments, bench_workloads[i].name, warmup, repetitions);
+    }
+    unlink(bench_straight);
+    unlink(bench_parse);
+
+    if (compiled) {
+        unlink(bench_source);
+        unlink(bench_binary);
+        printf("\n%-10s %12s %12s %16s %12s\n",
+            "compiled", "best (s)", "median (s)", "ops/s", "speedup");
+        for (i=0; i<workloads; i++) {
+            if (bench_workloads[i].option != NULL) continue;
+            printf("%-10s %12.4f %12.4f %16.0f %11.1fx\n",
+                bench_workloads[i].name, binaries[i].best, binaries[i].median,
+                bench_workloads[i].ops / binaries[i].median,
+                results[i].median / binaries[i].median);
+        }
+    }
+
+    // The parser reads the parse workload once per run.
+    double parse_mb = bench_workloads[workloads - 1].ops
+        / results[workloads - 1].median / 1e6;
+    printf("\nparse throughput: %.1f MB/s\n", parse_mb);
+
+    if (json != NULL) {
+        FILE * file = fopen(json, "w");
+        if (file == NULL) {
+            printf("Bench: Failed to open %s.\n", json);
+            return 1;
+        }
+        fprintf(file, "{\n  \"label\": \"%s\",\n  \"interpreter\": \"%s\",\n",
+            label, interpreter);
+        fprintf(file, "  \"flags\": \"%s\",\n  \"warmup\": %d,\n", flags, warmup);
+        fprintf(file, "  \"repetitions\": %d,\n", repetitions);
+        fprintf(file, "  \"parse_mb_per_s\": %.3f,\n  \"workloads\": [\n",
+            parse_mb);
+        for (i=0; i<workloads; i++) {
+            fprintf(file, "    {\"name\": \"%s\", \"unit\": \"%s\", "
+                "\"ops\": %.0f, \"best_s\": %.6f, \"median_s\": %.6f, "
+                "\"mean_s\": %.6f, \"ops_per_s\": %.0f, \"peak_rss_kb\": %ld",
+                bench_workloads[i].name, bench_workloads[i].unit,
+                bench_workloads[i].ops, results[i].best, results[i].median,
+                results[i].mean, bench_workloads[i].ops / results[i].median,
+                results[i].peak_rss);
+            if (compiled && bench_workloads[i].option == NULL)
+                fprintf(file, ", \"compiled_median_s\": %.6f, "
+                    "\"speedup\": %.3f", binaries[i].median,
+                    results[i].median / binaries[i].median);
+            fprintf(file, "}%s\n", i + 1 < workloads ? "," : "");
+        }
+        fprintf(file, "  ]\n}\n");
+        fclose(file);
+    }
+
+    free(results);
+    free(binaries);
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <time.h>
+#include "../arena.h"
+#include "../data.h"
+#include "../symbol_table.h"
+#include "../syntax_tree.h"
+
+// Definitions
+#define BENCH_LOOKUPS       1000000
+#define BENCH_REPETITIONS   5
+
+/**
+ * Bench Seconds returns the monotonic clock in seconds.
+ * @return  Seconds elapsed since an arbitrary point.
+ */
+double bench_seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * Bench Symbols inserts count identifiers in a new table and then looks them
+ * up BENCH_LOOKUPS times in a round robin. Prints the best throughput of the
+ * repetitions for both operations.
+ * @param   count   Amount of identifiers.
+ */
+void bench_symbols(int count) {
+    int i, r;
+    double best_insert = 0;
+    double best_lookup = 0;
+    char ** names = (char **)calloc(count, sizeof(char *));
+    for (i=0; i<count; i++) {
+        char name[32];
+        sprintf(name, "var%d", i);
+        names[i] = arena_strdup(global_arena, name);
+    }
+
+    for (r=0; r<BENCH_REPETITIONS; r++) {
+        symbol_table * table = symbol_initialize();
+
+        double start = bench_seconds();
+        for (i=0; i<count; i++)
+            symbol_insert_identifier(table, names[i], data_create_integer(i));
+        double insert = count / (bench_seconds() - start);
+
+        int found = 0;
+        start = bench_seconds();
+        for (i=0; i<BENCH_LOOKUPS; i++)
+            found += symbol_get_slot(table, names[i % count]) >= 0;
+        double lookup = BENCH_LOOKUPS / (bench_seconds() - start);
+
+        if (found != BENCH_LOOKUPS) {
+            printf("Bench: %d lookups failed.\n", BENCH_LOOKUPS - found);
+            exit(EXIT_FAILURE);
+        }
+        if (insert > best_insert) best_insert = insert;
+        if (lookup > best_lookup) best_lookup = lookup;
+
+        free(table->items);
+        free(table->values);
+        free(table);
+    }
+
+    printf("%10d%16.0f%16.0f\n", count, best_insert, best_lookup);
+    free(names);
+}
+
+/**
+ * Main function runs the symbol table benchmark at 10, 1k and 100k symbols.
+ * @return  Runtime code, zero for OK.
+ */
+int main() {
+    global_arena = arena_initialize();
+
+    printf("%10s%16s%16s\n\n", "symbols", "inserts/s", "lookups/s");
+    bench_symbols(10);
+    bench_symbols(1000);
+    bench_symbols(100000);
+
+    arena_release(global_arena);
+    return 0;
+}
@@ -2,33 +2,101 @@
 // Imports
 #include <stdio.h>
 #include <stdbool.h>
+#include "arena.h"
+#include "data.h"
+#include "symbol_table.h"
+#include "syntax_tree.h"
+#include "bytecode.h"
+#include "stream.h"
+#include "optimize.h"
+#include "profile.h"
+#include "cache.h"
+#include "batch.h"
+#include "emit.h"
+#include "jit.h"
+%}
+
+/**
+ * Parse Context is everything a parse of one program needs, so that programs
+ * can be parsed at once on different threads. It is given to the scanner as
+ * its extra data and to every action of the grammar.
+ * @param   scanner             Reentrant flex scanner.
+ * @param   arena               Arena of the nodes and symbols of the program.
+ * @param   table               Symbol table being filled.
+ * @param   node                Root of the main program once parsed.
+ * @param   function_current    Function being declared, NULL outside.
+ * @param   function_args       Arguments counted for the current call.
+ * @param   input               File read by the scanner when not mapped.
+ * @param   mapping             Mapped program, NULL when read from input.
+ * @param   mapping_size        Size of the mapping.
+ * @param   buffer              Flex buffer over the mapping.
+ * @param   output              Where errors are printed, stdout when NULL.
+ */
+// typedef struct parse_context {
+//     void * scanner;
+//     struct arena * arena;
+//     struct symbol_table * table;
+//     struct syntax_node * node;
+//     struct symbol_function * function_current;
+//     int function_args;
+//     FILE * input;
+//     char * mapping;
+//     size_t mapping_size;
+//     struct yy_buffer_state * buffer;
+//     FILE * output;
+// } parse_context;
+
+// Bison Union Requirements, and the context shared with the scanner.
+%code requires {
+#include <stdio.h>
+#include <stdbool.h>
+#include "arena.h"
 #include "data.h"
 #include "symbol_table.h"
 #include "syntax_tree.h"
 
-// Global Table
-symbol_table * table;
-syntax_node * node;
-char * function_identifier;
-int function_args = 0;
+typedef struct parse_context {
+    void * scanner;
+    struct arena * arena;
+    struct symbol_table * table;
+    struct syntax_node * node;
+    struct symbol_function * function_current;
+    int function_args;
+    FILE * input;
+    char * mapping;
+    size_t mapping_size;
+    struct yy_buffer_state * buffer;
+    FILE * output;
+} parse_context;
+}
+
+// Bison Interface, how other modules open and parse a program.
+%code provides {
+bool flex_open(parse_context *, char *);
+bool flex_open_source(parse_context *, char *, size_t);
+void flex_close(parse_context *);
+int bison_parse(parse_context *);
+}
 
+// Bison Code, after the context is known.
+%code {
 // Flex externals
-extern FILE * yyin;
-extern int yylineno;
-extern char * yytext;
-extern int yylex();
-extern int yyerror(char const *);
+extern int yylex(YYSTYPE *, YYLTYPE *, void *);
+extern char * yyget_text(void *);
+extern int yyget_lineno(void *);
 
 // Declarations
+int yyerror(YYLTYPE *, void *, parse_context *, char const *);
 void bison_parse_success();
-void bison_error_identifier_repeated(char *);
-void bison_error_identifier_failed(char *);
-void bison_error_identifier_missing(char *);
-void bison_error_data_mismatch(data_value *, data_value *);
-void bison_error_not_function(char *);
-void bison_error_not_identifier(char *);
-void bison_error_arg_mismatch(char *);
-%}
+void bison_error_identifier_repeated(parse_context *, YYLTYPE *, char *);
+void bison_error_identifier_failed(parse_context *, YYLTYPE *, char *);
+void bison_error_identifier_missing(parse_context *, YYLTYPE *, char *);
+void bison_error_data_mismatch(
+    parse_context *, YYLTYPE *, data_value, data_value);
+void bison_error_not_function(parse_context *, YYLTYPE *, char *);
+void bison_error_not_identifier(parse_context *, YYLTYPE *, char *);
+void bison_error_arg_mismatch(parse_context *, YYLTYPE *, char *);
+}
 
 // Bison Union
 %union {
@@ -36,11 +104,19 @@ void bison_error_arg_mismatch(char *);
     int instruction;
     char * identifier;
     struct param_list * list;
-    struct data_value * value;
+    struct data_value value;
     struct syntax_node * node;
     struct symbol_table * table;
 }
 
+// Bison Purity, the parser and the scanner keep no state between programs.
+%define api.pure full
+%parse-param {void * scanner} {parse_context * context}
+%lex-param {void * scanner}
+
+// Bison Locations, the line of the first token of a node is its line.
+%locations
+
 // Bison Terminal Types
 %token<instruction> R_BEGIN R_END R_VAR R_INT R_FLOAT
 %token<instruction> R_IF R_IFELSE R_WHILE R_READ R_PRINT R_FUN R_RETURN
@@ -63,7 +139,7 @@ void bison_error_arg_mismatch(char *);
 prog
     : opt_decls opt_fun_decls R_BEGIN opt_stmts R_END {
         // The node is given by opt_stmts.
-        node = $4;
+        context->node = $4;
     }
 ;
 
@@ -80,14 +156,21 @@ decls
 dec
     : R_VAR V_ID S_COLON tipo {
         // Verify that the identifier is unique.
-        if (symbol_exists(table, $2)) {
-            bison_error_identifier_repeated($2);
+        if (symbol_exists(context->table, $2)) {
+            bison_error_identifier_repeated(context, &@2, $2);
             YYERROR;
         }
 
+        // Locals of a function go in its frame instead of the table storage.
+        bool inserted;
+        if (context->function_current != NULL)
+            inserted = symbol_insert_local(
+                context->table, $2, $4, context->function_current);
+        else inserted = symbol_insert_identifier(context->table, $2, $4);
+
         // Verify that the identifier was inserted.
-        if (!symbol_insert_identifier(table, $2, $4)) {
-            bison_error_identifier_failed($2);
+        if (!inserted) {
+            bison_error_identifier_failed(context, &@2, $2);
             YYERROR;
         }
     }
@@ -104,19 +187,28 @@ fun_decls
 ;
 
 fun_dec
-    : R_FUN V_ID S_PARENTL opt_params S_PARENTR S_COLON tipo
-      opt_decls R_BEGIN opt_stmts R_END {
+    : R_FUN V_ID {
+        // Parameters and locals that follow are placed in this function.
+        context->function_current = symbol_function_create();
+    } S_PARENTL opt_params S_PARENTR S_COLON tipo {
         // Verify that the identifier is unique.
-        if (symbol_exists(table, $2)) {
-            bison_error_identifier_repeated($2);
+        if (symbol_exists(context->table, $2)) {
+            bison_error_identifier_repeated(context, &@2, $2);
             YYERROR;
         }
 
-        // Verify that the identifier was inserted.
-        if (!symbol_insert_function(table, $2, $7, $4, $10)) {
-            bison_error_identifier_failed($2);
+        // Verify that the identifier was inserted, before the body so that
+        // the function can call itself.
+        if (!symbol_insert_function(
+            context->table, $2, $8, $5, context->function_current)) {
+            bison_error_identifier_failed(context, &@2, $2);
             YYERROR;
         }
+    } opt_decls R_BEGIN opt_stmts R_END {
+        // Set the body and forget the parameters and locals.
+        context->function_current->node = $12;
+        context->function_current = NULL;
+        symbol_close_scope(context->table);
     }
 ;
 
@@ -145,19 +237,18 @@ param_lst
 param
     : V_ID S_COLON tipo {
         // Verify that the identifier is unique.
-        if (symbol_exists(table, $1)) {
-            bison_error_identifier_repeated($1);
+        if (symbol_exists(context->table, $1)) {
+            bison_error_identifier_repeated(context, &@1, $1);
             YYERROR;
         }
 
-        // Verify that the identifier was inserted.
-        if (!symbol_insert_identifier(table, $1, $3)) {
-            bison_error_identifier_failed($1);
+        // Verify that the identifier was inserted in the frame.
+        $$ = symbol_insert_param(
+            context->table, $1, $3, context->function_current);
+        if ($$ == NULL) {
+            bison_error_identifier_failed(context, &@1, $1);
             YYERROR;
         }
-
-        // Create a parameter using an identifier.
-        $$ = symbol_param_create($1, $3);
     }
 ;
 
@@ -183,70 +274,86 @@ opt_stmts
 ;
 
 stmt_lst
-    : stmt S_SEMICOLON stmt_lst {
-        // Create a node of INSTRUCTION STMT.
-        $$ = syntax_create_stmt($1, $3, NULL);
+    : stmt_lst S_SEMICOLON stmt {
+        // Append to the node of INSTRUCTION STMT. The rule is left recursive,
+        // so the parser stack stays the same size however long the list is.
+        $$ = syntax_append_stmt($1, $3);
     }
     | stmt {
         // Create a node of INSTRUCTION STMT
-        $$ = syntax_create_stmt($1, NULL, NULL);
+        $$ = syntax_create_stmt($1);
     }
 ;
 
 stmt
     : V_ID S_ASSIGN expr {
         // Verify that the identifier exists.
-        if (!symbol_exists(table, $1)) {
-            bison_error_identifier_missing($1);
+        if (!symbol_exists(context->table, $1)) {
+            bison_error_identifier_missing(context, &@1, $1);
             YYERROR;
         }
 
-        // Create a node using an identifier.
+        // Create a node bound to the slot of the identifier, or to its frame
+        // offset for parameters and locals.
         syntax_node * id_node;
         char * identifier = $1;
-        data_value * value = symbol_get_value(table, identifier);
-        id_node = syntax_create_value(SYNTAX_IDENTIFIER, identifier, value);
+        int slot = symbol_get_slot(context->table, identifier);
+        data_value value = symbol_get_value(context->table, identifier);
+        if (symbol_is_local(context->table, identifier))
+            id_node = syntax_create_local(identifier, slot, value);
+        else id_node = syntax_create_identifier(identifier, slot, value);
+        SYNTAX_LINE(id_node) = @1.first_line;
 
         // Create a node of INSTRUCTION ASSIGN
         $$ = syntax_create_assign(id_node, $3, NULL);
         
         // Verify that the types are the same.
         if (!syntax_check_types(id_node, $3)) {
-            bison_error_data_mismatch(id_node->value, $3->value);
+            bison_error_data_mismatch(context, &@2, id_node->value, $3->value);
             YYERROR;
         }
     }
     | R_IF S_PARENTL expression S_PARENTR stmt {
         // Create a node of INSTRUCTION IF
         $$ = syntax_create_if($3, $5, NULL);
+        SYNTAX_LINE($$) = @1.first_line;
     }
     | R_IFELSE S_PARENTL expression S_PARENTR stmt stmt {
         // Create a node of INSTRUCTION IFELSE
         $$ = syntax_create_ifelse($3, $5, $6);
+        SYNTAX_LINE($$) = @1.first_line;
     }
     | R_WHILE S_PARENTL expression S_PARENTR stmt {
         // Create a node of INSTRUCTION WHILE
         $$ = syntax_create_while($3, $5, NULL);
+        SYNTAX_LINE($$) = @1.first_line;
     }
     | R_READ V_ID{
         // Verify that the identifier exists.
-        if (!symbol_exists(table, $2)) {
-            bison_error_identifier_missing($2);
+        if (!symbol_exists(context->table, $2)) {
+            bison_error_identifier_missing(context, &@2, $2);
             YYERROR;
         }
 
-        // Create a node using an identifier.
-        syntax_node * id_node; 
+        // Create a node bound to the slot of the identifier, or to its frame
+        // offset for parameters and locals.
+        syntax_node * id_node;
         char * identifier = $2;
-        data_value * value = symbol_get_value(table, identifier);
-        id_node = syntax_create_value(SYNTAX_IDENTIFIER, identifier, value);
+        int slot = symbol_get_slot(context->table, identifier);
+        data_value value = symbol_get_value(context->table, identifier);
+        if (symbol_is_local(context->table, identifier))
+            id_node = syntax_create_local(identifier, slot, value);
+        else id_node = syntax_create_identifier(identifier, slot, value);
+        SYNTAX_LINE(id_node) = @2.first_line;
 
         // Create a node of INSTRUCTION READ
         $$ = syntax_create_read(id_node, NULL, NULL);
+        SYNTAX_LINE($$) = @1.first_line;
     }
     | R_PRINT expr {
         // Create a node of INSTRUCTION PRINT
         $$ = syntax_create_print($2, NULL, NULL);
+        SYNTAX_LINE($$) = @1.first_line;
     }
     | R_BEGIN opt_stmts R_END{
         // Skip creation and go directly to OPT_STMTS, then STMT_LST, then STMT.
@@ -255,6 +362,15 @@ stmt
     | R_RETURN expr {
         // Create a node of INSTRUCTION RETURN
         $$ = syntax_create_return($2, NULL, NULL);
+        SYNTAX_LINE($$) = @1.first_line;
+
+        // Verify that the type is the one of the function.
+        if (context->function_current != NULL
+            && context->function_current->value.numtype != $2->value.numtype) {
+            bison_error_data_mismatch(context, &@1,
+                context->function_current->value, $2->value);
+            YYERROR;
+        }
     }
 ;
 
@@ -269,7 +385,7 @@ expression
         
         // Verify that the types are the same.
         if (!syntax_check_types($1, $3)) {
-            bison_error_data_mismatch($1->value, $3->value);
+            bison_error_data_mismatch(context, &@2, $1->value, $3->value);
             YYERROR;
         }
     }
@@ -280,17 +396,26 @@ expr
         // Create a node of INSTRUCTION EXPR
         $$ = syntax_create_expr(DATA_SUM, $1, $3, NULL);
 
-        // TBD: Type check.
+        // Verify that the types are the same.
+        if (!syntax_check_types($1, $3)) {
+            bison_error_data_mismatch(context, &@2, $1->value, $3->value);
+            YYERROR;
+        }
     }
     | expr S_MINUS term {
         // Create a node of INSTRUCTION EXPR
         $$ = syntax_create_expr(DATA_SUBSTRACT, $1, $3, NULL);
 
-        // TBD: Type check.
+        // Verify that the types are the same.
+        if (!syntax_check_types($1, $3)) {
+            bison_error_data_mismatch(context, &@2, $1->value, $3->value);
+            YYERROR;
+        }
     }
     | signo term {
         // Create a node of INSTRUCTION EXPR
         $$ = syntax_create_expr(DATA_NEGATIVE, $2, NULL, NULL);
+        SYNTAX_LINE($$) = @1.first_line;
     }
     | term {
         // Skip creation and go directly to TERM
@@ -305,7 +430,7 @@ term
 
         // Verify that the types are the same.
         if (!syntax_check_types($1, $3)) {
-            bison_error_data_mismatch($1->value, $3->value);
+            bison_error_data_mismatch(context, &@2, $1->value, $3->value);
             YYERROR;
         }
     }
@@ -315,7 +440,7 @@ term
 
         // Verify that the types are the same.
         if (!syntax_check_types($1, $3)) {
-            bison_error_data_mismatch($1->value, $3->value);
+            bison_error_data_mismatch(context, &@2, $1->value, $3->value);
             YYERROR;
         }
     }
@@ -332,21 +457,26 @@ factor
     }
     | V_ID {
         // Verify that the identifier exists.
-        if (!symbol_exists(table, $1)) {
-            bison_error_identifier_missing($1);
+        if (!symbol_exists(context->table, $1)) {
+            bison_error_identifier_missing(context, &@1, $1);
             YYERROR;
         }
 
         // Verify that the identifier is an identifier.
-        if (!symbol_is_identifier(table, $1)) {
-            bison_error_not_identifier($1);
+        if (!symbol_is_identifier(context->table, $1)) {
+            bison_error_not_identifier(context, &@1, $1);
             YYERROR;
         }
 
-        // Create a node using an identifier.
+        // Create a node bound to the slot of the identifier, or to its frame
+        // offset for parameters and locals.
         syntax_node * id_node;
-        data_value * value = symbol_get_value(table, $1);
-        id_node = syntax_create_value(SYNTAX_IDENTIFIER, $1, value);
+        int slot = symbol_get_slot(context->table, $1);
+        data_value value = symbol_get_value(context->table, $1);
+        if (symbol_is_local(context->table, $1))
+            id_node = syntax_create_local($1, slot, value);
+        else id_node = syntax_create_identifier($1, slot, value);
+        SYNTAX_LINE(id_node) = @1.first_line;
 
         // Return the newly created node.
         $$ = id_node;
@@ -354,8 +484,9 @@ factor
     | V_NUMINT{
         // Create a node using a value.
         syntax_node * int_node;
-        data_value * value = $1;
+        data_value value = $1;
         int_node = syntax_create_value(SYNTAX_VALUE, NULL, value);
+        SYNTAX_LINE(int_node) = @1.first_line;
 
         // Return the newly created node.
         $$ = int_node;
@@ -363,38 +494,42 @@ factor
     | V_NUMFLOAT{
         // Create a node using a value.
         syntax_node * float_node;
-        data_value * value = $1;
+        data_value value = $1;
         float_node = syntax_create_value(SYNTAX_VALUE, NULL, value);
+        SYNTAX_LINE(float_node) = @1.first_line;
 
         // Return the newly created node.
         $$ = float_node;
     }
     | V_ID S_PARENTL opt_args S_PARENTR {
         // Verify that the identifier exists.
-        if (!symbol_exists(table, $1)) {
-            bison_error_identifier_missing($1);
+        if (!symbol_exists(context->table, $1)) {
+            bison_error_identifier_missing(context, &@1, $1);
             YYERROR;
         }
 
         // Verify that the identifier is a function.
-        if (!symbol_is_function(table, $1)) {
-            bison_error_not_function($1);
+        if (!symbol_is_function(context->table, $1)) {
+            bison_error_not_function(context, &@1, $1);
             YYERROR;
         }
 
         // Verify that the argument count is correct.
-        if (!symbol_param_equal(table, $1, function_args)) {
-            bison_error_arg_mismatch($1);
+        if (!symbol_param_equal(context->table, $1, context->function_args)) {
+            bison_error_arg_mismatch(context, &@1, $1);
             YYERROR;
         }
 
-        // Create a node that runs a function.
+        // Create a node that runs a function, bound to it.
         syntax_node * function_node;
-        data_value * value = symbol_get_value(table, $1);
-        function_node = syntax_create_function($1, value, $3);
+        int slot = symbol_get_slot(context->table, $1);
+        data_value value = symbol_get_value(context->table, $1);
+        symbol_function * function = symbol_get_function(context->table, $1);
+        function_node = syntax_create_function($1, slot, value, function, $3);
+        SYNTAX_LINE(function_node) = @1.first_line;
         
         // Return the newly created node.
-        function_args = 0;
+        context->function_args = 0;
         $$ = function_node;
     }
 ;
@@ -413,11 +548,11 @@ opt_args
 arg_lst
     : expr S_COMMA arg_lst {
         // Create a node of arg.
-        function_args ++;
+        context->function_args ++;
         $$ = syntax_create_arg($1, $3, NULL);
     }
     | expr {
-        function_args ++;
+        context->function_args ++;
         $$ = syntax_create_arg($1, NULL, NULL);
     }
 ;
@@ -450,12 +585,35 @@ signo
 /**
  * YYError is redefined in Bison for it to include additional details regarding
  * the system's grammars and where it was found to be at fault.
- * @param   error   Error to print
+ * @param   location    Location of the token.
+ * @param   scanner     Scanner that read the token.
+ * @param   context     Parse context, with where to print.
+ * @param   error       Error to print
  * @return  Integer code error.
  */
-int yyerror(char const * error) {
-    printf("\n%s found after reading '%s' at line %d.\n",
-        error, yytext, yylineno);
+int yyerror(
+    YYLTYPE * location, void * scanner, parse_context * context,
+    char const * error) {
+    FILE * output = context->output != NULL ? context->output : stdout;
+    fprintf(output, "\n%s found after reading '%s' at line %d.\n",
+        error, yyget_text(scanner), location->first_line);
+    return 0;
+}
+
+/**
+ * Bison Parse parses a program opened with flex_open into its context. The
+ * nodes and symbols are made in the arena of the context, which becomes the
+ * arena of the calling thread while it parses.
+ * @param   context Parse context of the program.
+ * @return  Zero if the program was accepted, like yyparse.
+ */
+int bison_parse(parse_context * context) {
+    syntax_arena(context->arena);
+    context->table = symbol_initialize();
+    context->node = syntax_initialize();
+    context->function_current = NULL;
+    context->function_args = 0;
+    return yyparse(context->scanner, context);
 }
 
 /**
@@ -468,137 +626,301 @@ void bison_parse_success() {
 /**
  * Bison Error Identifier Repeated calls the yyerror function with a message of
  * "variable declared twice: identifier".
+ * @param   context     Parse context.
+ * @param   location    Location of the identifier.
  * @param   identifier  String of the identifier.
  */
-void bison_error_identifier_repeated(char * identifier) {
+void bison_error_identifier_repeated(
+    parse_context * context, YYLTYPE * location, char * identifier) {
     char error[1000] = "variable declared twice: ";
     strcat(error, identifier);
-    yyerror(error);
+    yyerror(location, context->scanner, context, error);
 }
 
 /**
  * Bison Error Identifier Failed calls the yyerror function with a message of
  * "variable failed to be inserted: identifier".
+ * @param   context     Parse context.
+ * @param   location    Location of the identifier.
  * @param   identifier  String of the identifier.
  */
-void bison_error_identifier_failed(char * identifier) {
+void bison_error_identifier_failed(
+    parse_context * context, YYLTYPE * location, char * identifier) {
     char error[1000] = "variable failed to be inserted: ";
     strcat(error, identifier);
-    yyerror(error);
+    yyerror(location, context->scanner, context, error);
 }
 
 /**
  * Bison Error Identifier Missing calls the yyerror function with a message of
  * "variable not found: identifier".
+ * @param   context     Parse context.
+ * @param   location    Location of the identifier.
  * @param   identifier  String of the identifier.
  */
-void bison_error_identifier_missing(char * identifier) {
+void bison_error_identifier_missing(
+    parse_context * context, YYLTYPE * location, char * identifier) {
     char error[1000] = "variable not found: ";
     strcat(error, identifier);
-    yyerror(error);
+    yyerror(location, context->scanner, context, error);
 }
 
 /**
  * Bison Error Data Mismatch calls the yyerror function with a message of
  * "illegal operation of: one and two".
- * @param   one     First data type.
- * @param   two     Second data type.
+ * @param   context     Parse context.
+ * @param   location    Location of the operation.
+ * @param   one         First data type.
+ * @param   two         Second data type.
  */
-void bison_error_data_mismatch(data_value * one, data_value * two) {
+void bison_error_data_mismatch(
+    parse_context * context, YYLTYPE * location, data_value one,
+    data_value two) {
     char error[1000] = "illegal operation of ";
     char hold[1000];
     char erra[] = " and ";
     char erri[] = "int:";
     char errf[] = "float:";
     char errn[] = "unknown";
-    if (one->numtype == DATA_INTEGER) {
+    if (one.numtype == DATA_INTEGER) {
         strcat(error, erri);
-        sprintf(hold, "%d", one->number.int_value);
+        sprintf(hold, "%d", one.number.int_value);
         strcat(error, hold);
     }
-    else if (one->numtype == DATA_FLOAT) {
+    else if (one.numtype == DATA_FLOAT) {
         strcat(error, errf);
-        sprintf(hold, "%f", one->number.float_value);
+        sprintf(hold, "%f", one.number.float_value);
         strcat(error, hold);
     }
     else strcat(error, errn);
     strcat(error, erra);
-    if (two->numtype == DATA_INTEGER) {
+    if (two.numtype == DATA_INTEGER) {
         strcat(error, erri);
-        sprintf(hold, "%d", two->number.int_value);
+        sprintf(hold, "%d", two.number.int_value);
         strcat(error, hold);
     }
-    else if (two->numtype == DATA_FLOAT) {
+    else if (two.numtype == DATA_FLOAT) {
         strcat(error, errf);
-        sprintf(hold, "%f", two->number.float_value);
+        sprintf(hold, "%f", two.number.float_value);
         strcat(error, hold);
     }
     else strcat(error, errn);
-    yyerror(error);
+    yyerror(location, context->scanner, context, error);
 }
 
 /**
  * Bison Error Not Identifier prints that the identifier read was found to be
  * a function instead of an identifier.
+ * @param   context     Parse context.
+ * @param   location    Location of the identifier.
  * @param   identifier  Identifier found to be a function.
  */
-void bison_error_not_identifier(char * identifier) {
+void bison_error_not_identifier(
+    parse_context * context, YYLTYPE * location, char * identifier) {
     char error[1000] = "called identifier but found a function: ";
     strcat(error, identifier);
-    yyerror(error);
+    yyerror(location, context->scanner, context, error);
 }
 
 /**
  * Bison Error Not Function prints that the identifier read was found to be
  * an identifier instead of a function.
+ * @param   context     Parse context.
+ * @param   location    Location of the identifier.
  * @param   identifier  Identifier found not to be a function.
  */
-void bison_error_not_function(char * identifier) {
+void bison_error_not_function(
+    parse_context * context, YYLTYPE * location, char * identifier) {
     char error[1000] = "called a function but found an identifier: ";
     strcat(error, identifier);
-    yyerror(error);
+    yyerror(location, context->scanner, context, error);
 }
 
 /**
  * Bison Error Argument Mismatch prints that the lexicon was found to be using
  * an incorrect amount of parameters for a function call.
+ * @param   context     Parse context.
+ * @param   location    Location of the identifier.
  * @param   identifier  Identifier found to be called incorrectly.
  */
-void bison_error_arg_mismatch(char * identifier) {
+void bison_error_arg_mismatch(
+    parse_context * context, YYLTYPE * location, char * identifier) {
     char error[1000] = "called function with a wrong amount of parameters: ";
     strcat(error, identifier);
-    yyerror(error);
+    yyerror(location, context->scanner, context, error);
 }
 
+// The library built for embedding leaves main to the host.
+#ifndef BISON_LIBRARY
 /**
  * Main function couples the yyparse, hash table initialize and syntax tree
  * initialize functions along for this assignment.
+ * Options, also listed in the README:
+ *  --vm                Run the program on the bytecode machine.
+ *  --mem-stats         Print the memory used per kind of object at exit.
+ *  --batch             Read and print numbers without prompts.
+ *  --no-fold           Do not fold or propagate constants.
+ *  --no-propagate      Do not propagate constants across statements.
+ *  --no-hoist          Do not move loop-invariant operations out of whiles.
+ *  --inline-budget n   Inline calls of functions of at most n nodes.
+ *  --opt-stats         Print what the optimizer did and the memoized calls.
+ *  --profile           Count and time each line and function.
+ *  --profile-csv f     Profile and also write every line and function to f.
+ *  --cache dir         Keep the parsed and optimized program in dir.
+ *  --parse-only        Parse the program and print the symbol table.
+ *  --jobs m            Run every program of the manifest m on threads.
+ *  --threads n         Use n worker threads for --jobs.
+ *  --emit-c file       Write the program as C to file instead of running it.
+ *  --no-jit            Keep every while in the tree instead of compiling it.
  * @param   argc    Argument count.
  * @param   argv    Argument values.
  * @return  Runtime code, zero for OK and one for ERR.
  */
 int main(int argc, char * argv[]) {
-    // Argument and file verification
-    if (argc < 2) {
+    // Argument verification.
+    int i;
+    char * file = NULL;
+    bool mem_stats = false;
+    bool vm = false;
+    bool batch = false;
+    int passes = OPTIMIZE_DEFAULT;
+    bool opt_stats = false;
+    bool profile = false;
+    char * profile_csv = NULL;
+    char * cache = NULL;
+    bool parse_only = false;
+    char * jobs = NULL;
+    int threads = 0;
+    char * emit = NULL;
+    bool jit = true;
+    for (i=1; i<argc; i++) {
+        if (strcmp(argv[i], "--mem-stats") == 0) mem_stats = true;
+        else if (strcmp(argv[i], "--vm") == 0) vm = true;
+        else if (strcmp(argv[i], "--batch") == 0) batch = true;
+        else if (strcmp(argv[i], "--no-fold") == 0)
+            passes &= ~(OPTIMIZE_FOLD | OPTIMIZE_PROPAGATE);
+        else if (strcmp(argv[i], "--no-propagate") == 0)
+            passes &= ~OPTIMIZE_PROPAGATE;
+        else if (strcmp(argv[i], "--no-hoist") == 0)
+            passes &= ~OPTIMIZE_HOIST;
+        else if (strcmp(argv[i], "--inline-budget") == 0 && i + 1 < argc) {
+            int budget = atoi(argv[++ i]);
+            if (budget < 0) budget = 0;
+            if (budget > OPTIMIZE_BUDGET_MAX) budget = OPTIMIZE_BUDGET_MAX;
+            passes = (passes & OPTIMIZE_ALL) | budget << OPTIMIZE_BUDGET_SHIFT;
+        }
+        else if (strcmp(argv[i], "--opt-stats") == 0) opt_stats = true;
+        else if (strcmp(argv[i], "--profile") == 0) profile = true;
+        else if (strcmp(argv[i], "--profile-csv") == 0 && i + 1 < argc) {
+            profile = true;
+            profile_csv = argv[++ i];
+        }
+        else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+            cache = argv[++ i];
+        else if (strcmp(argv[i], "--parse-only") == 0) parse_only = true;
+        else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc)
+            jobs = argv[++ i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = atoi(argv[++ i]);
+        else if (strcmp(argv[i], "--emit-c") == 0 && i + 1 < argc)
+            emit = argv[++ i];
+        else if (strcmp(argv[i], "--no-jit") == 0) jit = false;
+        else if (strncmp(argv[i], "--", 2) == 0) {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        } else file = argv[i];
+    }
+
+    // The profiler measures the nodes of the tree.
+    if (profile && vm) {
+        printf("The profiler can not be used with --vm.\n");
+        return 1;
+    }
+    if (profile && emit != NULL) {
+        printf("The profiler can not be used with --emit-c.\n");
+        return 1;
+    }
+
+    // Batch of jobs, each one is parsed and run on a worker thread.
+    if (jobs != NULL) {
+        if (profile) {
+            printf("The profiler can not be used with --jobs.\n");
+            return 1;
+        }
+        return batch_run(jobs, threads, passes, vm) ? 0 : 1;
+    }
+
+    // File verification. Regular files are scanned in place from memory.
+    parse_context context = { 0 };
+    if (file == NULL) {
         printf("No file argument provided.\n");
         return 1;
-    } else if ((yyin = fopen(argv[1], "r")) == NULL) {
+    } else if (!flex_open(&context, file)) {
         printf("Failed to open file.\n");
         return 1;
     }
 
-    // Flex and Bison parsing.
-    table = symbol_initialize();
-    node = syntax_initialize();
-    int success = yyparse();
-    if (success == 0) {
-        global_table = table;
-        global_value = NULL;
-        syntax_execute_nodetype(node);
+    // Flex and Bison parsing, unless there is a cache of the same source.
+    stream_initialize(batch);
+    syntax_arena(arena_initialize());
+    context.arena = global_arena;
+    symbol_table * table;
+    syntax_node * node;
+    optimize_stats stats;
+    int success = 0;
+    bool emitted = false;
+    bool cached = cache != NULL && !parse_only
+        && cache_load(cache, file, passes, &node, &table, &stats);
+    if (!cached) {
+        success = bison_parse(&context);
+        table = context.table;
+        node = context.node;
+    }
+    if (success == 0 && !parse_only) {
+        if (!cached) {
+            node = optimize_program(node, table, passes, &stats);
+            if (cache != NULL
+                && !cache_save(cache, file, passes, node, table, &stats))
+                printf("Failed to write the cache in %s.\n", cache);
+        }
+        syntax_prepare(table);
+        if (profile) profile_initialize(node, table);
+        if (emit != NULL) {
+            // The C program prints the symbol table once it runs.
+            emitted = true;
+            if (!emit_write(emit, file, node, table))
+                printf("Failed to write %s.\n", emit);
+        } else if (vm) {
+            bytecode_program * program = bytecode_compile(node, table);
+            bytecode_execute(program, table);
+            bytecode_release(program);
+        } else {
+            // The profiler measures every statement, so loops stay in the tree.
+            if (jit && !profile) jit_initialize(node, table);
+            syntax_execute_nodetype(node);
+            jit_release();
+        }
+        if (profile) profile_finish();
+    }
+    stream_flush();
+    if (!emitted) symbol_print(table);
+    if (mem_stats) arena_print(global_arena);
+    if (opt_stats && success == 0 && !parse_only) {
+        stats.hits = global_memo_hits;
+        stats.misses = global_memo_misses;
+        optimize_print(&stats);
+    }
+    if (profile && success == 0 && !parse_only) {
+        profile_print(file);
+        if (profile_csv != NULL && !profile_write(profile_csv))
+            printf("Failed to write %s.\n", profile_csv);
+        profile_release();
     }
-    symbol_print(table);
 
     // Closure of file and system.
-    if (yyin != NULL) fclose(yyin);
+    flex_close(&context);
+    arena_release(global_arena);
+    cache_release();
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,729 @@
+#include "bytecode.h"
+
+/**
+ * Bytecode Instruction is a single instruction of the register machine. The
+ * operands are register indexes, except for the immediate value of LOAD, the
+ * function slot of CALL, the name index of READ, the storage slot of GETG
+ * and SETG, and the jump target, which is always kept in c so that it can be
+ * patched.
+ * @param   opcode  Operation of this instruction.
+ * @param   a       First operand, usually the destination register.
+ * @param   b       Second operand.
+ * @param   c       Third operand or jump target.
+ */
+// typedef struct bytecode_instruction {
+//     int opcode;
+//     int a;
+//     int b;
+//     int c;
+// } bytecode_instruction;
+
+/**
+ * Bytecode Program is the linear code of a whole program. Registers are
+ * relative to the window of the running call. The window of the main program
+ * starts with the storage slots of the symbol table, followed by its
+ * temporaries. The window of a function starts with its frame, parameters
+ * and then locals, followed by its temporaries, and it reaches the storage
+ * slots through GETG and SETG. Functions are compiled after the main program.
+ * @param   size        Amount of instructions.
+ * @param   capacity    Amount of instructions reserved.
+ * @param   registers   Amount of registers used by the window being compiled.
+ * @param   temporary   Next free temporary while compiling.
+ * @param   identifiers Amount of names.
+ * @param   entries     First instruction of each function, indexed by slot.
+ * @param   windows     Amount of registers of each function, indexed by slot.
+ * @param   names       Identifiers used by READ.
+ * @param   table       Symbol table of the program.
+ * @param   function    Function being compiled, NULL for the main program.
+ * @param   code        Instructions of the program.
+ */
+// typedef struct bytecode_program {
+//     int size;
+//     int capacity;
+//     int registers;
+//     int temporary;
+//     int identifiers;
+//     int * entries;
+//     int * windows;
+//     char ** names;
+//     struct symbol_table * table;
+//     struct symbol_function * function;
+//     struct bytecode_instruction * code;
+// } bytecode_program;
+
+/**
+ * Bytecode Compile lowers the syntax tree of the main program and the bodies
+ * of every function in the symbol table into a single bytecode program.
+ * @param   node    Root node of the main program.
+ * @param   table   Symbol table of the program.
+ * @return  Program compiled.
+ */
+bytecode_program * bytecode_compile(syntax_node * node, symbol_table * table) {
+    int i;
+    bytecode_program * program;
+    program = (bytecode_program *)calloc(1, sizeof(bytecode_program));
+    program->size = 0;
+    program->capacity = BYTECODE_SIZE;
+    program->code = (bytecode_instruction *)calloc(
+        BYTECODE_SIZE, sizeof(bytecode_instruction));
+    program->registers = table->slots;
+    program->temporary = table->slots;
+    program->identifiers = 0;
+    program->entries = (int *)calloc(table->slots, sizeof(int));
+    program->windows = (int *)calloc(table->slots, sizeof(int));
+    program->names = NULL;
+    program->table = table;
+    program->function = NULL;
+
+    for (i=0; i<table->slots; i++)
+        program->entries[i] = BYTECODE_NONE;
+
+    // Compile the main program.
+    bytecode_compile_statement(program, node);
+    bytecode_emit(program, BYTECODE_HALT, 0, 0, 0);
+
+    // Compile the functions, each one in its own window.
+    int registers = program->registers;
+    for (i=0; i<table->buckets; i++)
+        if (table->items[i].symtype == SYMBOL_FUNCTION)
+            bytecode_compile_function(program, &table->items[i]);
+    program->registers = registers;
+    program->function = NULL;
+
+    return program;
+}
+
+/**
+ * Bytecode Compile Function lowers the body of a function. It starts by
+ * setting its locals to zero, and a function that ends without a return
+ * gives zero too.
+ * @param   program     Program being compiled.
+ * @param   item        Item of the function.
+ */
+void bytecode_compile_function(bytecode_program * program, symbol_item * item) {
+    symbol_function * function = item->function;
+    program->function = function;
+    program->registers = function->size;
+    program->temporary = function->size;
+    program->entries[item->slot] = program->size;
+
+    param_list * local;
+    for (local = function->locals; local != NULL; local = local->next)
+        bytecode_emit(program, BYTECODE_LOAD, local->offset, 0, 0);
+
+    bytecode_compile_statement(program, function->node);
+    int a = bytecode_temporary(program);
+    bytecode_emit(program, BYTECODE_LOAD, a, 0, 0);
+    bytecode_emit(program, BYTECODE_RET, a, 0, 0);
+    program->windows[item->slot] = program->registers;
+}
+
+/**
+ * Bytecode Release frees the program.
+ * @param   program     Program to release.
+ */
+void bytecode_release(bytecode_program * program) {
+    if (program == NULL) return;
+    free(program->code);
+    free(program->entries);
+    free(program->windows);
+    free(program->names);
+    free(program);
+}
+
+/**
+ * Bytecode Emit appends an instruction to the program.
+ * @param   program     Program to append to.
+ * @param   opcode      Operation of the instruction.
+ * @param   a           First operand.
+ * @param   b           Second operand.
+ * @param   c           Third operand.
+ * @return  Position of the instruction.
+ */
+int bytecode_emit(bytecode_program * program, int opcode, int a, int b, int c) {
+    if (program->size == program->capacity) {
+        program->capacity *= 2;
+        program->code = (bytecode_instruction *)realloc(program->code,
+            program->capacity * sizeof(bytecode_instruction));
+    }
+    bytecode_instruction * instruction = &program->code[program->size];
+    instruction->opcode = opcode;
+    instruction->a = a;
+    instruction->b = b;
+    instruction->c = c;
+    return program->size ++;
+}
+
+/**
+ * Bytecode Patch sets the target of the jump at position.
+ * @param   program     Program to patch.
+ * @param   position    Position of the jump.
+ * @param   target      Position to jump to.
+ */
+void bytecode_patch(bytecode_program * program, int position, int target) {
+    program->code[position].c = target;
+}
+
+/**
+ * Bytecode Temporary reserves the next free temporary register.
+ * @param   program     Program being compiled.
+ * @return  Register reserved.
+ */
+int bytecode_temporary(bytecode_program * program) {
+    int temporary = program->temporary ++;
+    if (program->temporary > program->registers)
+        program->registers = program->temporary;
+    return temporary;
+}
+
+/**
+ * Bytecode Name keeps the identifier for READ to print it.
+ * @param   program     Program being compiled.
+ * @param   identifier  Identifier to keep.
+ * @return  Index of the name.
+ */
+int bytecode_name(bytecode_program * program, char * identifier) {
+    program->names = (char **)realloc(program->names,
+        (program->identifiers + 1) * sizeof(char *));
+    program->names[program->identifiers] = identifier;
+    return program->identifiers ++;
+}
+
+/**
+ * Bytecode Has Call tells if a function is called anywhere inside the node,
+ * which means that evaluating it may change any global.
+ * @param   node    Node to look into.
+ * @return  True if the node calls a function.
+ */
+bool bytecode_has_call(syntax_node * node) {
+    int i;
+    if (node == NULL) return false;
+    if (node->nodetype != SYNTAX_INSTRUCTION) return false;
+    if (node->instruction == SYNTAX_FUNCTION) return true;
+    for (i=0; i<node->count; i++)
+        if (bytecode_has_call(SYNTAX_AT(node->list[i]))) return true;
+    return bytecode_has_call(SYNTAX_NODEA(node)) ||
+        bytecode_has_call(SYNTAX_NODEB(node)) ||
+        bytecode_has_call(SYNTAX_NODEC(node));
+}
+
+/**
+ * Bytecode Compile Statement lowers a statement. The temporaries used by it
+ * are free again once it is done.
+ * @param   program     Program being compiled.
+ * @param   node        Node of the statement.
+ */
+void bytecode_compile_statement(bytecode_program * program, syntax_node * node) {
+    int i, a, jump, skip, loop;
+    int temporary = program->temporary;
+    bool global;
+
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return;
+
+    switch (node->instruction) {
+        case SYNTAX_STMT:
+            // Compile the statements of the list in order.
+            for (i=0; i<node->count; i++)
+                bytecode_compile_statement(
+                    program, SYNTAX_AT(node->list[i]));
+            break;
+        case SYNTAX_ASSIGN:
+            // Functions store to the storage slots through SETG.
+            global = SYNTAX_NODEA(node)->nodetype == SYNTAX_IDENTIFIER &&
+                program->function != NULL;
+            if (!global) {
+                bytecode_compile_expression(
+                    program, SYNTAX_NODEB(node), SYNTAX_NODEA(node)->slot);
+                break;
+            }
+            a = bytecode_compile_operand(program, SYNTAX_NODEB(node), false);
+            bytecode_emit(
+                program, BYTECODE_SETG, SYNTAX_NODEA(node)->slot, a, 0);
+            break;
+        case SYNTAX_IF:
+            jump = bytecode_compile_condition(
+                program, SYNTAX_NODEA(node), false);
+            bytecode_compile_statement(program, SYNTAX_NODEB(node));
+            bytecode_patch(program, jump, program->size);
+            break;
+        case SYNTAX_IFELSE:
+            jump = bytecode_compile_condition(
+                program, SYNTAX_NODEA(node), false);
+            bytecode_compile_statement(program, SYNTAX_NODEB(node));
+            skip = bytecode_emit(program, BYTECODE_JUMP, 0, 0, 0);
+            bytecode_patch(program, jump, program->size);
+            bytecode_compile_statement(program, SYNTAX_NODEC(node));
+            bytecode_patch(program, skip, program->size);
+            break;
+        case SYNTAX_WHILE:
+            // The condition goes after the body so each turn is one jump.
+            skip = bytecode_emit(program, BYTECODE_JUMP, 0, 0, 0);
+            loop = program->size;
+            bytecode_compile_statement(program, SYNTAX_NODEB(node));
+            bytecode_patch(program, skip, program->size);
+            jump = bytecode_compile_condition(
+                program, SYNTAX_NODEA(node), true);
+            bytecode_patch(program, jump, loop);
+            break;
+        case SYNTAX_READ:
+            global = SYNTAX_NODEA(node)->nodetype == SYNTAX_IDENTIFIER &&
+                program->function != NULL;
+            a = global ? bytecode_temporary(program) : SYNTAX_NODEA(node)->slot;
+            if (SYNTAX_NODEA(node)->value.numtype == DATA_INTEGER)
+                bytecode_emit(program, BYTECODE_READI, a,
+                    bytecode_name(program, SYNTAX_NODEA(node)->identifier), 0);
+            else bytecode_emit(program, BYTECODE_READF, a,
+                    bytecode_name(program, SYNTAX_NODEA(node)->identifier), 0);
+            if (global)
+                bytecode_emit(program, BYTECODE_SETG,
+                    SYNTAX_NODEA(node)->slot, a, 0);
+            break;
+        case SYNTAX_PRINT:
+            a = bytecode_compile_operand(program, SYNTAX_NODEA(node), false);
+            if (SYNTAX_NODEA(node)->value.numtype == DATA_INTEGER)
+                bytecode_emit(program, BYTECODE_PRINTI, a, 0, 0);
+            else bytecode_emit(program, BYTECODE_PRINTF, a, 0, 0);
+            break;
+        case SYNTAX_RETURN:
+            // A return of the main program ends it.
+            a = bytecode_compile_operand(program, SYNTAX_NODEA(node), false);
+            if (program->function == NULL)
+                bytecode_emit(program, BYTECODE_HALT, 0, 0, 0);
+            else bytecode_emit(program, BYTECODE_RET, a, 0, 0);
+            break;
+        default:
+            bytecode_compile_expression(program, node, BYTECODE_NONE);
+            break;
+    }
+    program->temporary = temporary;
+}
+
+/**
+ * Bytecode Compile Arguments stores each argument in the registers that start
+ * at base, one after the other, which become the parameters of the window of
+ * the call.
+ * @param   program     Program being compiled.
+ * @param   node        Node of the first ARG.
+ * @param   base        First register of the window of the call.
+ */
+void bytecode_compile_arguments(
+    bytecode_program * program, syntax_node * node, int base
+) {
+    while (node != NULL) {
+        bytecode_compile_expression(program, SYNTAX_NODEA(node), base ++);
+        node = SYNTAX_NODEB(node);
+    }
+}
+
+/**
+ * Bytecode Compile Condition lowers an EXPRESSION into a conditional jump
+ * that is taken when the evaluation equals when. The target is patched later.
+ * @param   program     Program being compiled.
+ * @param   node        Node of the expression.
+ * @param   when        Evaluation that takes the jump.
+ * @return  Position of the jump.
+ */
+int bytecode_compile_condition(
+    bytecode_program * program, syntax_node * node, bool when
+) {
+    int opcode = BYTECODE_JUMP;
+    bool integer = SYNTAX_NODEA(node)->value.numtype == DATA_INTEGER;
+
+    if (node->operation == DATA_ZERO) {
+        int a = bytecode_compile_operand(program, SYNTAX_NODEA(node), false);
+        if (integer) opcode = when ? BYTECODE_JNZI : BYTECODE_JZI;
+        else opcode = when ? BYTECODE_JNZF : BYTECODE_JZF;
+        return bytecode_emit(program, opcode, a, 0, 0);
+    }
+
+    bool protect = bytecode_has_call(SYNTAX_NODEB(node));
+    int a = bytecode_compile_operand(program, SYNTAX_NODEA(node), protect);
+    int b = bytecode_compile_operand(program, SYNTAX_NODEB(node), false);
+
+    // Integers jump on the complement, floats need their own negation for NaN.
+    switch (node->operation) {
+        case DATA_LESS:
+            if (integer) opcode = when ? BYTECODE_JLTI : BYTECODE_JGEI;
+            else opcode = when ? BYTECODE_JLTF : BYTECODE_JNLTF;
+            break;
+        case DATA_GREATER:
+            if (integer) opcode = when ? BYTECODE_JGTI : BYTECODE_JLEI;
+            else opcode = when ? BYTECODE_JGTF : BYTECODE_JNGTF;
+            break;
+        case DATA_EQUALS:
+            if (integer) opcode = when ? BYTECODE_JEQI : BYTECODE_JNEI;
+            else opcode = when ? BYTECODE_JEQF : BYTECODE_JNEQF;
+            break;
+        case DATA_LTE:
+            if (integer) opcode = when ? BYTECODE_JLEI : BYTECODE_JGTI;
+            else opcode = when ? BYTECODE_JLEF : BYTECODE_JNLEF;
+            break;
+        case DATA_GTE:
+            if (integer) opcode = when ? BYTECODE_JGEI : BYTECODE_JLTI;
+            else opcode = when ? BYTECODE_JGEF : BYTECODE_JNGEF;
+            break;
+        default:
+            // Unknown relops never evaluate to true.
+            if (when) return bytecode_emit(program, BYTECODE_JZI, a, 0, 0);
+            opcode = BYTECODE_JUMP;
+            break;
+    }
+    return bytecode_emit(program, opcode, a, b, 0);
+}
+
+/**
+ * Bytecode Compile Operand returns the register holding the value of node.
+ * Parameters and locals are used in place. So are storage slots in the main
+ * program, unless protect is set, in which case they are copied first because
+ * the other operand may call a function that changes them, and the tree
+ * interpreter reads them before that.
+ * @param   program     Program being compiled.
+ * @param   node        Node of the operand.
+ * @param   protect     Whether identifiers have to be copied.
+ * @return  Register of the operand.
+ */
+int bytecode_compile_operand(
+    bytecode_program * program, syntax_node * node, bool protect
+) {
+    if (node->nodetype == SYNTAX_LOCAL) return node->slot;
+    if (node->nodetype == SYNTAX_IDENTIFIER && !protect &&
+        program->function == NULL) return node->slot;
+    return bytecode_compile_expression(program, node, BYTECODE_NONE);
+}
+
+/**
+ * Bytecode Compile Expression lowers an EXPR, TERM, FUNCTION, identifier or
+ * value, leaving the result in target, or in a temporary if there is none.
+ * @param   program     Program being compiled.
+ * @param   node        Node of the expression.
+ * @param   target      Register for the result, or BYTECODE_NONE.
+ * @return  Register of the result.
+ */
+int bytecode_compile_expression(
+    bytecode_program * program, syntax_node * node, int target
+) {
+    int a, b;
+    int opcode;
+    bool integer;
+
+    switch (node->nodetype) {
+        case SYNTAX_IDENTIFIER:
+            if (target == BYTECODE_NONE) target = bytecode_temporary(program);
+            opcode = program->function == NULL ? BYTECODE_MOVE : BYTECODE_GETG;
+            bytecode_emit(program, opcode, target, node->slot, 0);
+            return target;
+        case SYNTAX_LOCAL:
+            if (target == BYTECODE_NONE) target = bytecode_temporary(program);
+            bytecode_emit(program, BYTECODE_MOVE, target, node->slot, 0);
+            return target;
+        case SYNTAX_VALUE:
+            if (target == BYTECODE_NONE) target = bytecode_temporary(program);
+            bytecode_emit(program, BYTECODE_LOAD,
+                target, node->value.number.int_value, 0);
+            return target;
+        case SYNTAX_INSTRUCTION:
+            break;
+        default:
+            return target;
+    }
+
+    switch (node->instruction) {
+        case SYNTAX_EXPR:
+        case SYNTAX_TERM:
+            integer = SYNTAX_NODEA(node)->value.numtype == DATA_INTEGER;
+            if (node->operation == DATA_NEGATIVE) {
+                a = bytecode_compile_operand(
+                    program, SYNTAX_NODEA(node), false);
+                if (target == BYTECODE_NONE)
+                    target = bytecode_temporary(program);
+                opcode = integer ? BYTECODE_NEGI : BYTECODE_NEGF;
+                bytecode_emit(program, opcode, target, a, 0);
+                return target;
+            }
+
+            a = bytecode_compile_operand(program, SYNTAX_NODEA(node),
+                bytecode_has_call(SYNTAX_NODEB(node)));
+            b = bytecode_compile_operand(program, SYNTAX_NODEB(node), false);
+            if (target == BYTECODE_NONE) target = bytecode_temporary(program);
+
+            // Mixed types evaluate to the integer zero, as in data_operation.
+            if (SYNTAX_NODEA(node)->value.numtype
+                != SYNTAX_NODEB(node)->value.numtype) {
+                bytecode_emit(program, BYTECODE_LOAD, target, 0, 0);
+                return target;
+            }
+
+            switch (node->operation) {
+                case DATA_SUM:
+                    opcode = integer ? BYTECODE_ADDI : BYTECODE_ADDF;
+                    break;
+                case DATA_SUBSTRACT:
+                    opcode = integer ? BYTECODE_SUBI : BYTECODE_SUBF;
+                    break;
+                case DATA_MULTIPLY:
+                    opcode = integer ? BYTECODE_MULI : BYTECODE_MULF;
+                    break;
+                case DATA_DIVIDE:
+                    opcode = integer ? BYTECODE_DIVI : BYTECODE_DIVF;
+                    break;
+                default:
+                    bytecode_emit(program, BYTECODE_LOAD, target, 0, 0);
+                    return target;
+            }
+            bytecode_emit(program, opcode, target, a, b);
+            return target;
+        case SYNTAX_FUNCTION:
+            // The window of the call starts after every live temporary.
+            a = program->temporary;
+            for (b=0; b<node->function->args; b++) bytecode_temporary(program);
+            bytecode_compile_arguments(program, SYNTAX_NODEA(node), a);
+            bytecode_emit(program, BYTECODE_CALL, node->slot, a, 0);
+            if (target == BYTECODE_NONE) target = bytecode_temporary(program);
+            bytecode_emit(program, BYTECODE_GETRET, target, 0, 0);
+            if (program->function == NULL)
+                bytecode_emit(program, BYTECODE_MOVE, node->slot, target, 0);
+            else bytecode_emit(program, BYTECODE_SETG, node->slot, target, 0);
+            return target;
+        default:
+            return target;
+    }
+}
+
+/**
+ * Bytecode State is what a run of a program writes, so that a compiled program
+ * is never changed by running it and can be run by many states at once.
+ * @param   registers   Register stack, starting with the storage slots.
+ * @param   stack       Return addresses and window offsets of the calls.
+ */
+// typedef struct bytecode_state {
+//     struct data_value * registers;
+//     int * stack;
+// } bytecode_state;
+
+/**
+ * Bytecode State Create returns a state with its registers and call stack.
+ * @return  State created.
+ */
+bytecode_state * bytecode_state_create() {
+    bytecode_state * state;
+    state = (bytecode_state *)calloc(1, sizeof(bytecode_state));
+    state->registers = (data_value *)calloc(BYTECODE_STACK, sizeof(data_value));
+    state->stack = (int *)calloc(BYTECODE_DEPTH * 2, sizeof(int));
+    if (state->registers == NULL || state->stack == NULL) {
+        printf("Bytecode: Out of memory.\n");
+        exit(EXIT_FAILURE);
+    }
+    return state;
+}
+
+/**
+ * Bytecode State Release frees a state.
+ * @param   state   State to release.
+ */
+void bytecode_state_release(bytecode_state * state) {
+    if (state == NULL) return;
+    free(state->registers);
+    free(state->stack);
+    free(state);
+}
+
+/**
+ * Bytecode Execute runs the program over a register stack that starts with a
+ * copy of the storage of the symbol table, which is copied back at the end.
+ * @param   program     Program to run.
+ * @param   table       Symbol table of the program.
+ */
+void bytecode_execute(bytecode_program * program, symbol_table * table) {
+    bytecode_state * state = bytecode_state_create();
+    memcpy(state->registers, table->values, table->slots * sizeof(data_value));
+    bytecode_run(program, state);
+    memcpy(table->values, state->registers, table->slots * sizeof(data_value));
+    bytecode_state_release(state);
+}
+
+/**
+ * Bytecode Run runs the program over the registers of a state, which must
+ * start with the storage slots. Each call moves the window of registers up to
+ * the base of its arguments. Registers only have their number written, so
+ * the storage keeps its types. Only the state is written.
+ * @param   program     Program to run.
+ * @param   state       State of the run.
+ */
+void bytecode_run(bytecode_program * program, bytecode_state * state) {
+    data_value * g = state->registers;
+    data_value * r = g;
+
+    int * stack = state->stack;
+    int depth = 0;
+    data_number result;
+    result.int_value = 0;
+
+    bytecode_instruction * code = program->code;
+    bytecode_instruction * instruction;
+    int pc = 0;
+    char error[64];
+
+    for (;;) {
+        instruction = &code[pc ++];
+        int a = instruction->a;
+        int b = instruction->b;
+        int c = instruction->c;
+
+        switch (instruction->opcode) {
+            case BYTECODE_HALT:
+                return;
+            case BYTECODE_MOVE:
+                r[a].number = r[b].number;
+                break;
+            case BYTECODE_LOAD:
+                r[a].number.int_value = b;
+                break;
+            case BYTECODE_ADDI:
+                r[a].number.int_value =
+                    r[b].number.int_value + r[c].number.int_value;
+                break;
+            case BYTECODE_SUBI:
+                r[a].number.int_value =
+                    r[b].number.int_value - r[c].number.int_value;
+                break;
+            case BYTECODE_MULI:
+                r[a].number.int_value =
+                    r[b].number.int_value * r[c].number.int_value;
+                break;
+            case BYTECODE_DIVI:
+                r[a].number.int_value =
+                    r[b].number.int_value / r[c].number.int_value;
+                break;
+            case BYTECODE_NEGI:
+                r[a].number.int_value = r[b].number.int_value * (-1);
+                break;
+            case BYTECODE_ADDF:
+                r[a].number.float_value =
+                    r[b].number.float_value + r[c].number.float_value;
+                break;
+            case BYTECODE_SUBF:
+                r[a].number.float_value =
+                    r[b].number.float_value - r[c].number.float_value;
+                break;
+            case BYTECODE_MULF:
+                r[a].number.float_value =
+                    r[b].number.float_value * r[c].number.float_value;
+                break;
+            case BYTECODE_DIVF:
+                r[a].number.float_value =
+                    r[b].number.float_value / r[c].number.float_value;
+                break;
+            case BYTECODE_NEGF:
+                r[a].number.float_value = r[b].number.float_value * (-1);
+                break;
+            case BYTECODE_JUMP:
+                pc = c;
+                break;
+            case BYTECODE_JLTI:
+                if (r[a].number.int_value < r[b].number.int_value) pc = c;
+                break;
+            case BYTECODE_JGTI:
+                if (r[a].number.int_value > r[b].number.int_value) pc = c;
+                break;
+            case BYTECODE_JEQI:
+                if (r[a].number.int_value == r[b].number.int_value) pc = c;
+                break;
+            case BYTECODE_JNEI:
+                if (r[a].number.int_value != r[b].number.int_value) pc = c;
+                break;
+            case BYTECODE_JLEI:
+                if (r[a].number.int_value <= r[b].number.int_value) pc = c;
+                break;
+            case BYTECODE_JGEI:
+                if (r[a].number.int_value >= r[b].number.int_value) pc = c;
+                break;
+            case BYTECODE_JZI:
+                if (r[a].number.int_value == 0) pc = c;
+                break;
+            case BYTECODE_JNZI:
+                if (r[a].number.int_value != 0) pc = c;
+                break;
+            case BYTECODE_JLTF:
+                if (r[a].number.float_value < r[b].number.float_value) pc = c;
+                break;
+            case BYTECODE_JGTF:
+                if (r[a].number.float_value > r[b].number.float_value) pc = c;
+                break;
+            case BYTECODE_JEQF:
+                if (r[a].number.float_value == r[b].number.float_value) pc = c;
+                break;
+            case BYTECODE_JLEF:
+                if (r[a].number.float_value <= r[b].number.float_value) pc = c;
+                break;
+            case BYTECODE_JGEF:
+                if (r[a].number.float_value >= r[b].number.float_value) pc = c;
+                break;
+            case BYTECODE_JNLTF:
+                if (!(r[a].number.float_value < r[b].number.float_value))
+                    pc = c;
+                break;
+            case BYTECODE_JNGTF:
+                if (!(r[a].number.float_value > r[b].number.float_value))
+                    pc = c;
+                break;
+            case BYTECODE_JNEQF:
+                if (!(r[a].number.float_value == r[b].number.float_value))
+                    pc = c;
+                break;
+            case BYTECODE_JNLEF:
+                if (!(r[a].number.float_value <= r[b].number.float_value))
+                    pc = c;
+                break;
+            case BYTECODE_JNGEF:
+                if (!(r[a].number.float_value >= r[b].number.float_value))
+                    pc = c;
+                break;
+            case BYTECODE_JZF:
+                if (r[a].number.float_value == 0) pc = c;
+                break;
+            case BYTECODE_JNZF:
+                if (r[a].number.float_value != 0) pc = c;
+                break;
+            case BYTECODE_READI:
+                r[a].number.int_value = stream_read_integer(program->names[b]);
+                break;
+            case BYTECODE_READF:
+                r[a].number.float_value = stream_read_float(program->names[b]);
+                break;
+            case BYTECODE_PRINTI:
+                stream_print_integer(r[a].number.int_value);
+                break;
+            case BYTECODE_PRINTF:
+                stream_print_float(r[a].number.float_value);
+                break;
+            case BYTECODE_CALL:
+                if (depth == BYTECODE_DEPTH * 2 ||
+                    (r - g) + b + program->windows[a] > BYTECODE_STACK) {
+                    syntax_fail("Call: The call stack is full.");
+                }
+                stack[depth ++] = pc;
+                stack[depth ++] = b;
+                r += b;
+                pc = program->entries[a];
+                break;
+            case BYTECODE_RET:
+                result = r[a].number;
+                r -= stack[-- depth];
+                pc = stack[-- depth];
+                break;
+            case BYTECODE_GETRET:
+                r[a].number = result;
+                break;
+            case BYTECODE_GETG:
+                r[a].number = g[b].number;
+                break;
+            case BYTECODE_SETG:
+                g[a].number = r[b].number;
+                break;
+            default:
+                sprintf(error, "Bytecode: Unknown opcode %d.",
+                    instruction->opcode);
+                syntax_fail(error);
+        }
+    }
+}
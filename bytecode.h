@@ -0,0 +1,106 @@
+#ifndef _BYTECODEH_
+#define _BYTECODEH_
+
+// Imports
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "data.h"
+#include "symbol_table.h"
+#include "syntax_tree.h"
+
+// Definitions
+#define BYTECODE_SIZE       64
+#define BYTECODE_DEPTH      65536
+#define BYTECODE_STACK      1048576
+#define BYTECODE_NONE       -1
+
+// Opcodes
+#define BYTECODE_HALT       0
+#define BYTECODE_MOVE       1
+#define BYTECODE_LOAD       2
+#define BYTECODE_ADDI       3
+#define BYTECODE_SUBI       4
+#define BYTECODE_MULI       5
+#define BYTECODE_DIVI       6
+#define BYTECODE_NEGI       7
+#define BYTECODE_ADDF       8
+#define BYTECODE_SUBF       9
+#define BYTECODE_MULF       10
+#define BYTECODE_DIVF       11
+#define BYTECODE_NEGF       12
+#define BYTECODE_JUMP       13
+#define BYTECODE_JLTI       14
+#define BYTECODE_JGTI       15
+#define BYTECODE_JEQI       16
+#define BYTECODE_JNEI       17
+#define BYTECODE_JLEI       18
+#define BYTECODE_JGEI       19
+#define BYTECODE_JZI        20
+#define BYTECODE_JNZI       21
+#define BYTECODE_JLTF       22
+#define BYTECODE_JGTF       23
+#define BYTECODE_JEQF       24
+#define BYTECODE_JLEF       25
+#define BYTECODE_JGEF       26
+#define BYTECODE_JNLTF      27
+#define BYTECODE_JNGTF      28
+#define BYTECODE_JNEQF      29
+#define BYTECODE_JNLEF      30
+#define BYTECODE_JNGEF      31
+#define BYTECODE_JZF        32
+#define BYTECODE_JNZF       33
+#define BYTECODE_READI      34
+#define BYTECODE_READF      35
+#define BYTECODE_PRINTI     36
+#define BYTECODE_PRINTF     37
+#define BYTECODE_CALL       38
+#define BYTECODE_RET        39
+#define BYTECODE_GETRET     40
+#define BYTECODE_GETG       41
+#define BYTECODE_SETG       42
+
+// Declarations
+typedef struct bytecode_instruction {
+    int opcode;
+    int a;
+    int b;
+    int c;
+} bytecode_instruction;
+typedef struct bytecode_program {
+    int size;
+    int capacity;
+    int registers;
+    int temporary;
+    int identifiers;
+    int * entries;
+    int * windows;
+    char ** names;
+    struct symbol_table * table;
+    struct symbol_function * function;
+    struct bytecode_instruction * code;
+} bytecode_program;
+typedef struct bytecode_state {
+    struct data_value * registers;
+    int * stack;
+} bytecode_state;
+
+bytecode_program * bytecode_compile(syntax_node *, symbol_table *);
+void bytecode_release(bytecode_program *);
+int bytecode_emit(bytecode_program *, int, int, int, int);
+int bytecode_temporary(bytecode_program *);
+int bytecode_name(bytecode_program *, char *);
+void bytecode_compile_function(bytecode_program *, symbol_item *);
+bool bytecode_has_call(syntax_node *);
+void bytecode_compile_statement(bytecode_program *, syntax_node *);
+void bytecode_compile_arguments(bytecode_program *, syntax_node *, int);
+int bytecode_compile_condition(bytecode_program *, syntax_node *, bool);
+void bytecode_patch(bytecode_program *, int, int);
+int bytecode_compile_operand(bytecode_program *, syntax_node *, bool);
+int bytecode_compile_expression(bytecode_program *, syntax_node *, int);
+bytecode_state * bytecode_state_create();
+void bytecode_state_release(bytecode_state *);
+void bytecode_execute(bytecode_program *, symbol_table *);
+void bytecode_run(bytecode_program *, bytecode_state *);
+
+#endif
@@ -0,0 +1,866 @@
+#include "cache.h"
+
+/**
+ * Cache Header starts a cache file. A cache is only used when every field
+ * that identifies it matches, so a changed program, other passes or another
+ * build of the interpreter parse the program again.
+ * @param   magic       CACHE_MAGIC, without the terminator.
+ * @param   version     CACHE_VERSION of the interpreter that wrote it.
+ * @param   handlers    Amount of handlers the interpreter knows.
+ * @param   passes      Optimizer passes that ran on the tree.
+ * @param   root        Index of the root of the main program.
+ * @param   hash        64 bit FNV-1a hash of the source.
+ * @param   length      Length of the source in bytes.
+ * @param   nodes       Amount of node records.
+ * @param   params      Amount of parameter records.
+ * @param   functions   Amount of function records.
+ * @param   buckets     Amount of item records, one per bucket of the table.
+ * @param   size        Amount of items in the table.
+ * @param   slots       Amount of storage values.
+ * @param   entries     Amount of statements of the STMT lists.
+ * @param   strings     Bytes of the identifiers, each one with a terminator.
+ * @param   stats       What the optimizer did, for --opt-stats.
+ */
+// typedef struct cache_header {
+//     char magic[8];
+//     int version;
+//     int handlers;
+//     int passes;
+//     int root;
+//     unsigned long long hash;
+//     long long length;
+//     int nodes;
+//     int params;
+//     int functions;
+//     int buckets;
+//     int size;
+//     int slots;
+//     int entries;
+//     int strings;
+//     optimize_stats stats;
+// } cache_header;
+
+/**
+ * Cache Node, Param, Function and Item are the records of the nodes, the
+ * parameters and locals, the functions and the items. Every pointer of the
+ * structure they come from is an index in the records of its kind, or
+ * CACHE_NONE for NULL, identifiers are offsets in the strings, and the
+ * handler is its index in cache_handlers. The statements of a STMT list are
+ * the count node indices that start at list in the entries.
+ */
+// typedef struct cache_node {
+//     int handler;
+//     char nodetype;
+//     char operation;
+//     char evaluation;
+//     char instruction;
+//     int slot;
+//     int line;
+//     int identifier;
+//     int function;
+//     int nodea;
+//     int nodeb;
+//     int nodec;
+//     int count;
+//     int list;
+//     data_value value;
+// } cache_node;
+// typedef struct cache_param {
+//     int offset;
+//     int identifier;
+//     int next;
+//     data_value value;
+// } cache_param;
+// typedef struct cache_function {
+//     int args;
+//     int size;
+//     int writes;
+//     int pure;
+//     int memoize;
+//     int list;
+//     int locals;
+//     int node;
+//     data_value value;
+// } cache_function;
+// typedef struct cache_item {
+//     unsigned int key;
+//     int slot;
+//     int symtype;
+//     int identifier;
+//     int list;
+//     int function;
+// } cache_item;
+
+/**
+ * Cache Shape is what a handler expects of its nodes, so that a record
+ * whose handler does not match the rest of it is not run.
+ * @param   nodetype    Type of the nodes, SYNTAX_NULLT for any.
+ * @param   instruction Instruction of the nodes, SYNTAX_NULLT for any.
+ * @param   children    Children the handler runs without checking them.
+ */
+// typedef struct cache_shape {
+//     char nodetype;
+//     char instruction;
+//     int children;
+// } cache_shape;
+
+/**
+ * Cache List is a growing array of the pointers of one kind found while
+ * saving, in the order of their records.
+ * @param   size        Amount of pointers.
+ * @param   capacity    Amount of pointers reserved.
+ * @param   items       Pointers.
+ */
+// typedef struct cache_list {
+//     int size;
+//     int capacity;
+//     void ** items;
+// } cache_list;
+
+/**
+ * Cache Writer is what is needed to turn a tree into records. Its map is an
+ * open addressing hash table from each pointer found to its index, so nodes
+ * reached twice keep a single record.
+ * @param   size        Amount of buckets of the map.
+ * @param   used        Amount of pointers in the map.
+ * @param   keys        Pointers of the map.
+ * @param   indices     Index of each pointer of the map.
+ * @param   nodes       Nodes found.
+ * @param   params      Parameters and locals found.
+ * @param   functions   Functions found.
+ * @param   strings     Bytes of the identifiers written.
+ * @param   capacity    Bytes reserved for the identifiers.
+ * @param   text        Identifiers, each one with a terminator.
+ */
+// typedef struct cache_writer {
+//     int size;
+//     int used;
+//     void ** keys;
+//     int * indices;
+//     cache_list nodes;
+//     cache_list params;
+//     cache_list functions;
+//     int strings;
+//     int capacity;
+//     char * text;
+// } cache_writer;
+
+// Global Values.
+char * cache_mapping = NULL;
+size_t cache_mapping_size = 0;
+
+// Every handler a node can have when the tree is saved. Records keep the
+// index, so CACHE_VERSION must change when this list does.
+syntax_handler cache_handlers[] = {
+    syntax_execute_value,
+    syntax_operate_addi, syntax_operate_addf,
+    syntax_operate_subi, syntax_operate_subf,
+    syntax_operate_muli, syntax_operate_mulf,
+    syntax_operate_divi, syntax_operate_divf,
+    syntax_operate_negi, syntax_operate_negf,
+    syntax_evaluate_lessi, syntax_evaluate_lessf,
+    syntax_evaluate_greateri, syntax_evaluate_greaterf,
+    syntax_evaluate_equalsi, syntax_evaluate_equalsf,
+    syntax_evaluate_ltei, syntax_evaluate_ltef,
+    syntax_evaluate_gtei, syntax_evaluate_gtef,
+    syntax_evaluate_zeroi, syntax_evaluate_zerof,
+    syntax_print_integer, syntax_print_float,
+    syntax_execute_stmt,
+    syntax_execute_assign, syntax_execute_assign_local,
+    syntax_execute_if, syntax_execute_ifelse, syntax_execute_while,
+    syntax_execute_read, syntax_execute_print,
+    syntax_evaluate_expression, syntax_operate_expr, syntax_operate_term,
+    syntax_operate_identifier, syntax_operate_local,
+    syntax_execute_function, syntax_execute_return,
+};
+int cache_handler_count = sizeof(cache_handlers) / sizeof(syntax_handler);
+
+// The shape of the nodes of each handler, in the order of cache_handlers.
+#define CACHE_KERNEL(instruction, children) \
+    { SYNTAX_INSTRUCTION, instruction, children }
+cache_shape cache_shapes[] = {
+    { SYNTAX_NULLT, SYNTAX_NULLT, 0 },
+    CACHE_KERNEL(SYNTAX_EXPR, 2), CACHE_KERNEL(SYNTAX_EXPR, 2),
+    CACHE_KERNEL(SYNTAX_EXPR, 2), CACHE_KERNEL(SYNTAX_EXPR, 2),
+    CACHE_KERNEL(SYNTAX_TERM, 2), CACHE_KERNEL(SYNTAX_TERM, 2),
+    CACHE_KERNEL(SYNTAX_TERM, 2), CACHE_KERNEL(SYNTAX_TERM, 2),
+    CACHE_KERNEL(SYNTAX_EXPR, 1), CACHE_KERNEL(SYNTAX_EXPR, 1),
+    CACHE_KERNEL(SYNTAX_EXPRESSION, 2), CACHE_KERNEL(SYNTAX_EXPRESSION, 2),
+    CACHE_KERNEL(SYNTAX_EXPRESSION, 2), CACHE_KERNEL(SYNTAX_EXPRESSION, 2),
+    CACHE_KERNEL(SYNTAX_EXPRESSION, 2), CACHE_KERNEL(SYNTAX_EXPRESSION, 2),
+    CACHE_KERNEL(SYNTAX_EXPRESSION, 2), CACHE_KERNEL(SYNTAX_EXPRESSION, 2),
+    CACHE_KERNEL(SYNTAX_EXPRESSION, 2), CACHE_KERNEL(SYNTAX_EXPRESSION, 2),
+    CACHE_KERNEL(SYNTAX_EXPRESSION, 1), CACHE_KERNEL(SYNTAX_EXPRESSION, 1),
+    CACHE_KERNEL(SYNTAX_PRINT, 1), CACHE_KERNEL(SYNTAX_PRINT, 1),
+    CACHE_KERNEL(SYNTAX_STMT, 0),
+    CACHE_KERNEL(SYNTAX_ASSIGN, 0), CACHE_KERNEL(SYNTAX_ASSIGN, 2),
+    CACHE_KERNEL(SYNTAX_IF, 0), CACHE_KERNEL(SYNTAX_IFELSE, 0),
+    CACHE_KERNEL(SYNTAX_WHILE, 0),
+    CACHE_KERNEL(SYNTAX_READ, 0), CACHE_KERNEL(SYNTAX_PRINT, 0),
+    CACHE_KERNEL(SYNTAX_EXPRESSION, 0), CACHE_KERNEL(SYNTAX_EXPR, 0),
+    CACHE_KERNEL(SYNTAX_TERM, 0),
+    { SYNTAX_IDENTIFIER, SYNTAX_NULLT, 0 }, { SYNTAX_LOCAL, SYNTAX_NULLT, 0 },
+    CACHE_KERNEL(SYNTAX_FUNCTION, 0), CACHE_KERNEL(SYNTAX_RETURN, 0),
+};
+#undef CACHE_KERNEL
+
+/**
+ * Cache Source hashes a program with the 64 bit FNV-1a hash, reading it
+ * through a mapping.
+ * @param   file    Program file.
+ * @param   hash    Where to store the hash.
+ * @param   length  Where to store the length in bytes.
+ * @return  True if the file could be read.
+ */
+bool cache_source(char * file, unsigned long long * hash, long long * length) {
+    struct stat status;
+    int descriptor = open(file, O_RDONLY);
+    if (descriptor < 0) return false;
+    if (fstat(descriptor, &status) < 0) {
+        close(descriptor);
+        return false;
+    }
+
+    *hash = CACHE_FNV_BASIS;
+    *length = status.st_size;
+    if (status.st_size > 0) {
+        unsigned char * data = (unsigned char *)mmap(
+            NULL, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (data == MAP_FAILED) {
+            close(descriptor);
+            return false;
+        }
+        long long i;
+        for (i=0; i<status.st_size; i++)
+            *hash = (*hash ^ data[i]) * CACHE_FNV_PRIME;
+        munmap(data, status.st_size);
+    }
+    close(descriptor);
+    return true;
+}
+
+/**
+ * Cache Path returns the file of the cache of a program, named after its
+ * hash and the passes of the optimizer, so that programs with the same
+ * source share it.
+ * @param   directory   Directory of the caches.
+ * @param   hash        Hash of the source.
+ * @param   passes      Optimizer passes.
+ * @param   path        Where to store the path, CACHE_PATH long.
+ */
+void cache_path(
+    char * directory, unsigned long long hash, int passes, char * path
+) {
+    snprintf(path, CACHE_PATH, "%s/%016llx-%d.ast", directory, hash, passes);
+}
+
+/**
+ * Cache Handler Index returns the index of a handler in cache_handlers.
+ * @param   handler     Handler to look for.
+ * @return  Index, or CACHE_NONE if it can not be saved.
+ */
+int cache_handler_index(syntax_handler handler) {
+    int i;
+    for (i=0; i<cache_handler_count; i++)
+        if (cache_handlers[i] == handler) return i;
+    return CACHE_NONE;
+}
+
+/**
+ * Cache Find returns the index given to a pointer.
+ * @param   writer  Writer with the map.
+ * @param   pointer Pointer to look for.
+ * @return  Index, or CACHE_NONE if it was not found yet.
+ */
+int cache_find(cache_writer * writer, void * pointer) {
+    if (pointer == NULL) return CACHE_NONE;
+    int curr = (int)(((uintptr_t)pointer >> 3) * CACHE_FNV_PRIME)
+        & (writer->size - 1);
+    while (writer->keys[curr] != NULL) {
+        if (writer->keys[curr] == pointer) return writer->indices[curr];
+        curr = (curr + 1) & (writer->size - 1);
+    }
+    return CACHE_NONE;
+}
+
+/**
+ * Cache Put gives an index to a pointer, doubling the map once it is half
+ * full.
+ * @param   writer  Writer with the map.
+ * @param   pointer Pointer not yet in the map.
+ * @param   index   Index of the pointer.
+ */
+void cache_put(cache_writer * writer, void * pointer, int index) {
+    int i;
+    if (2 * (writer->used + 1) > writer->size) {
+        int size = writer->size;
+        void ** keys = writer->keys;
+        int * indices = writer->indices;
+        writer->size = 2 * size;
+        writer->used = 0;
+        writer->keys = (void **)calloc(writer->size, sizeof(void *));
+        writer->indices = (int *)calloc(writer->size, sizeof(int));
+        for (i=0; i<size; i++)
+            if (keys[i] != NULL) cache_put(writer, keys[i], indices[i]);
+        free(keys);
+        free(indices);
+    }
+
+    int curr = (int)(((uintptr_t)pointer >> 3) * CACHE_FNV_PRIME)
+        & (writer->size - 1);
+    while (writer->keys[curr] != NULL) curr = (curr + 1) & (writer->size - 1);
+    writer->keys[curr] = pointer;
+    writer->indices[curr] = index;
+    writer->used ++;
+}
+
+/**
+ * Cache Index returns the index of a pointer in its list, adding it if it
+ * was not found yet.
+ * @param   writer  Writer with the map.
+ * @param   list    List of the kind of the pointer.
+ * @param   pointer Pointer, may be NULL.
+ * @param   added   Where to store whether it was added now.
+ * @return  Index, or CACHE_NONE for NULL.
+ */
+int cache_index(
+    cache_writer * writer, cache_list * list, void * pointer, bool * added
+) {
+    *added = false;
+    if (pointer == NULL) return CACHE_NONE;
+    int index = cache_find(writer, pointer);
+    if (index != CACHE_NONE) return index;
+
+    if (list->size == list->capacity) {
+        list->capacity = list->capacity == 0 ? CACHE_LIST_SIZE
+            : 2 * list->capacity;
+        list->items = (void **)realloc(
+            list->items, list->capacity * sizeof(void *));
+    }
+    list->items[list->size] = pointer;
+    cache_put(writer, pointer, list->size);
+    *added = true;
+    return list->size ++;
+}
+
+/**
+ * Cache String returns the offset of an identifier in the strings, adding it
+ * if it was not found yet.
+ * @param   writer      Writer with the strings.
+ * @param   identifier  Identifier, may be NULL.
+ * @return  Offset, or CACHE_NONE for NULL.
+ */
+int cache_string(cache_writer * writer, char * identifier) {
+    if (identifier == NULL) return CACHE_NONE;
+    int offset = cache_find(writer, identifier);
+    if (offset != CACHE_NONE) return offset;
+
+    int length = strlen(identifier) + 1;
+    while (writer->strings + length > writer->capacity) {
+        writer->capacity = writer->capacity == 0 ? CACHE_MAP_SIZE
+            : 2 * writer->capacity;
+        writer->text = (char *)realloc(writer->text, writer->capacity);
+    }
+    offset = writer->strings;
+    memcpy(writer->text + offset, identifier, length);
+    writer->strings += length;
+    cache_put(writer, identifier, offset);
+    return offset;
+}
+
+/**
+ * Cache Collect Node gives an index to a node and to what it reaches.
+ * @param   writer  Writer of the cache.
+ * @param   node    Node, may be NULL.
+ * @return  Index of the node.
+ */
+int cache_collect_node(cache_writer * writer, syntax_node * node) {
+    int i;
+    bool added;
+    int index = cache_index(writer, &writer->nodes, node, &added);
+    if (!added) return index;
+    cache_collect_node(writer, SYNTAX_NODEA(node));
+    cache_collect_node(writer, SYNTAX_NODEB(node));
+    cache_collect_node(writer, SYNTAX_NODEC(node));
+    for (i=0; i<node->count; i++)
+        cache_collect_node(writer, SYNTAX_AT(node->list[i]));
+    cache_collect_function(writer, node->function);
+    return index;
+}
+
+/**
+ * Cache Collect Param gives an index to each parameter of a list.
+ * @param   writer  Writer of the cache.
+ * @param   list    List, may be NULL.
+ * @return  Index of the first parameter.
+ */
+int cache_collect_param(cache_writer * writer, param_list * list) {
+    bool added;
+    int index = cache_index(writer, &writer->params, list, &added);
+    if (added) cache_collect_param(writer, list->next);
+    return index;
+}
+
+/**
+ * Cache Collect Function gives an index to a function, its parameters, its
+ * locals and its body.
+ * @param   writer      Writer of the cache.
+ * @param   function    Function, may be NULL.
+ * @return  Index of the function.
+ */
+int cache_collect_function(cache_writer * writer, symbol_function * function) {
+    bool added;
+    int index = cache_index(writer, &writer->functions, function, &added);
+    if (!added) return index;
+    cache_collect_param(writer, function->list);
+    cache_collect_param(writer, function->locals);
+    cache_collect_node(writer, function->node);
+    return index;
+}
+
+/**
+ * Cache Save writes the optimized tree and the symbol table of a program, so
+ * that the next run of the same source can skip the parser and the
+ * optimizer. The file is written aside and renamed, so a run never reads a
+ * cache that is half written.
+ * @param   directory   Directory of the caches.
+ * @param   file        Program file.
+ * @param   passes      Optimizer passes that ran on the tree.
+ * @param   node        Root of the main program.
+ * @param   table       Symbol table.
+ * @param   stats       What the optimizer did.
+ * @return  True if the cache was written.
+ */
+bool cache_save(
+    char * directory,
+    char * file,
+    int passes,
+    syntax_node * node,
+    symbol_table * table,
+    optimize_stats * stats
+) {
+    int i;
+    cache_header header;
+    memset(&header, 0, sizeof(cache_header));
+    if (!cache_source(file, &header.hash, &header.length)) return false;
+
+    cache_writer writer;
+    memset(&writer, 0, sizeof(cache_writer));
+    writer.size = CACHE_MAP_SIZE;
+    writer.keys = (void **)calloc(writer.size, sizeof(void *));
+    writer.indices = (int *)calloc(writer.size, sizeof(int));
+    header.root = cache_collect_node(&writer, node);
+    for (i=0; i<table->buckets; i++) {
+        cache_collect_param(&writer, table->items[i].list);
+        cache_collect_function(&writer, table->items[i].function);
+    }
+
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.handlers = cache_handler_count;
+    header.passes = passes;
+    header.nodes = writer.nodes.size;
+    header.params = writer.params.size;
+    header.functions = writer.functions.size;
+    header.buckets = table->buckets;
+    header.size = table->size;
+    header.slots = table->slots;
+    header.stats = *stats;
+
+    char path[CACHE_PATH];
+    char temporary[CACHE_PATH + 8];
+    cache_path(directory, header.hash, passes, path);
+    snprintf(temporary, sizeof(temporary), "%s.XXXXXX", path);
+    int descriptor = mkstemp(temporary);
+    if (descriptor >= 0) fchmod(descriptor, 0644);
+    FILE * cache = descriptor < 0 ? NULL : fdopen(descriptor, "wb");
+
+    bool written = cache != NULL && cache_write(cache, &writer, &header, table);
+    if (cache != NULL) written = fclose(cache) == 0 && written;
+    else if (descriptor >= 0) close(descriptor);
+    if (written) written = rename(temporary, path) == 0;
+    if (!written && descriptor >= 0) unlink(temporary);
+
+    free(writer.keys);
+    free(writer.indices);
+    free(writer.nodes.items);
+    free(writer.params.items);
+    free(writer.functions.items);
+    free(writer.text);
+    return written;
+}
+
+/**
+ * Cache Write writes the header and the records. The strings are gathered
+ * while the records are made, so the header is written again at the end with
+ * their size and the amount of entries.
+ * @param   cache   File of the cache.
+ * @param   writer  Writer with every pointer found.
+ * @param   header  Header of the cache.
+ * @param   table   Symbol table.
+ * @return  True if everything could be written.
+ */
+bool cache_write(
+    FILE * cache, cache_writer * writer, cache_header * header,
+    symbol_table * table
+) {
+    int i, j;
+    int entries = 0;
+    bool written = fwrite(header, sizeof(cache_header), 1, cache) == 1;
+
+    for (i=0; i<writer->nodes.size && written; i++) {
+        syntax_node * node = (syntax_node *)writer->nodes.items[i];
+        cache_node record;
+        memset(&record, 0, sizeof(cache_node));
+        record.handler = cache_handler_index(node->handler);
+        if (record.handler == CACHE_NONE) return false;
+        record.nodetype = node->nodetype;
+        record.operation = node->operation;
+        record.evaluation = node->evaluation;
+        record.instruction = node->instruction;
+        record.slot = node->slot;
+        record.line = SYNTAX_LINE(node);
+        record.identifier = cache_string(writer, node->identifier);
+        record.function = cache_find(writer, node->function);
+        record.nodea = cache_find(writer, SYNTAX_NODEA(node));
+        record.nodeb = cache_find(writer, SYNTAX_NODEB(node));
+        record.nodec = cache_find(writer, SYNTAX_NODEC(node));
+        record.count = node->count;
+        record.list = entries;
+        entries += node->count;
+        record.value = node->value;
+        written = fwrite(&record, sizeof(cache_node), 1, cache) == 1;
+    }
+
+    for (i=0; i<writer->params.size && written; i++) {
+        param_list * param = (param_list *)writer->params.items[i];
+        cache_param record;
+        memset(&record, 0, sizeof(cache_param));
+        record.offset = param->offset;
+        record.identifier = cache_string(writer, param->identifier);
+        record.next = cache_find(writer, param->next);
+        record.value = param->value;
+        written = fwrite(&record, sizeof(cache_param), 1, cache) == 1;
+    }
+
+    for (i=0; i<writer->functions.size && written; i++) {
+        symbol_function * function =
+            (symbol_function *)writer->functions.items[i];
+        cache_function record;
+        memset(&record, 0, sizeof(cache_function));
+        record.args = function->args;
+        record.size = function->size;
+        record.writes = function->writes;
+        record.pure = function->pure;
+        record.memoize = function->memoize;
+        record.list = cache_find(writer, function->list);
+        record.locals = cache_find(writer, function->locals);
+        record.node = cache_find(writer, function->node);
+        record.value = function->value;
+        written = fwrite(&record, sizeof(cache_function), 1, cache) == 1;
+    }
+
+    for (i=0; i<table->buckets && written; i++) {
+        symbol_item * item = &table->items[i];
+        cache_item record;
+        memset(&record, 0, sizeof(cache_item));
+        record.key = item->key;
+        record.slot = item->slot;
+        record.symtype = item->symtype;
+        record.identifier = cache_string(writer, item->identifier);
+        record.list = cache_find(writer, item->list);
+        record.function = cache_find(writer, item->function);
+        written = fwrite(&record, sizeof(cache_item), 1, cache) == 1;
+    }
+
+    if (written && table->slots > 0)
+        written = fwrite(table->values, sizeof(data_value), table->slots,
+            cache) == (size_t)table->slots;
+    for (i=0; i<writer->nodes.size && written; i++) {
+        syntax_node * node = (syntax_node *)writer->nodes.items[i];
+        for (j=0; j<node->count && written; j++) {
+            int entry = cache_find(writer, SYNTAX_AT(node->list[j]));
+            written = fwrite(&entry, sizeof(int), 1, cache) == 1;
+        }
+    }
+    if (written && writer->strings > 0)
+        written = fwrite(writer->text, 1, writer->strings, cache)
+            == (size_t)writer->strings;
+
+    header->entries = entries;
+    header->strings = writer->strings;
+    if (written) written = fseek(cache, 0, SEEK_SET) == 0
+        && fwrite(header, sizeof(cache_header), 1, cache) == 1;
+    return written;
+}
+
+/**
+ * Cache Check tells if a mapped cache is complete, every index in it is in
+ * range, every node has the shape of its handler and every slot and offset
+ * fits the storage or the frame it is used in, so that a damaged file is
+ * parsed again instead of run.
+ * @param   header  Header at the start of the mapping.
+ * @param   size    Size of the mapping.
+ * @return  True if the cache can be loaded.
+ */
+bool cache_check(cache_header * header, long long size) {
+    int i;
+    int frame = 0;
+    if (header->nodes < 1 || header->params < 0 || header->functions < 0
+        || header->buckets < 1 || header->slots < 0 || header->entries < 0
+        || header->strings < 0
+        || (header->buckets & (header->buckets - 1)) != 0) return false;
+    long long expected = sizeof(cache_header)
+        + (long long)header->nodes * sizeof(cache_node)
+        + (long long)header->params * sizeof(cache_param)
+        + (long long)header->functions * sizeof(cache_function)
+        + (long long)header->buckets * sizeof(cache_item)
+        + (long long)header->slots * sizeof(data_value)
+        + (long long)header->entries * sizeof(int)
+        + header->strings;
+    if (size != expected) return false;
+    if (header->strings > 0
+        && ((char *)header)[size - 1] != '\0') return false;
+
+    #define CACHE_IN(index, count) ((index) >= CACHE_NONE && (index) < (count))
+    cache_node * nodes = (cache_node *)(header + 1);
+    cache_param * params = (cache_param *)(nodes + header->nodes);
+    cache_function * functions = (cache_function *)(params + header->params);
+    cache_item * items = (cache_item *)(functions + header->functions);
+    data_value * values = (data_value *)(items + header->buckets);
+    int * entries = (int *)(values + header->slots);
+    if (header->root < 0 || header->root >= header->nodes) return false;
+    for (i=0; i<header->nodes; i++)
+        if (nodes[i].handler < 0 || nodes[i].handler >= header->handlers
+            || !CACHE_IN(nodes[i].identifier, header->strings)
+            || !CACHE_IN(nodes[i].function, header->functions)
+            || !CACHE_IN(nodes[i].nodea, header->nodes)
+            || !CACHE_IN(nodes[i].nodeb, header->nodes)
+            || !CACHE_IN(nodes[i].nodec, header->nodes)
+            || nodes[i].count < 0 || nodes[i].list < 0
+            || nodes[i].list > header->entries - nodes[i].count) return false;
+    for (i=0; i<header->entries; i++)
+        if (entries[i] < 0 || entries[i] >= header->nodes) return false;
+    for (i=0; i<header->params; i++)
+        if (!CACHE_IN(params[i].identifier, header->strings)
+            || !CACHE_IN(params[i].next, header->params)) return false;
+    for (i=0; i<header->functions; i++)
+        if (!CACHE_IN(functions[i].list, header->params)
+            || !CACHE_IN(functions[i].locals, header->params)
+            || !CACHE_IN(functions[i].node, header->nodes)
+            || (functions[i].memoize && functions[i].args > SYNTAX_MEMO_ARGS)
+            || functions[i].args < 0 || functions[i].size < functions[i].args
+            || functions[i].size > SYNTAX_STACK
+            || !cache_check_frame(params, header->params,
+                functions[i].list, functions[i].size)
+            || !cache_check_frame(params, header->params,
+                functions[i].locals, functions[i].size)) return false;
+    for (i=0; i<header->functions; i++)
+        if (functions[i].size > frame) frame = functions[i].size;
+    for (i=0; i<header->nodes; i++) {
+        cache_shape * shape = &cache_shapes[nodes[i].handler];
+        bool call = nodes[i].nodetype == SYNTAX_INSTRUCTION
+            && nodes[i].instruction == SYNTAX_FUNCTION;
+        if ((shape->nodetype != SYNTAX_NULLT
+                && nodes[i].nodetype != shape->nodetype)
+            || (shape->instruction != SYNTAX_NULLT
+                && nodes[i].instruction != shape->instruction)
+            || (shape->children > 0 && nodes[i].nodea == CACHE_NONE)
+            || (shape->children > 1 && nodes[i].nodeb == CACHE_NONE)
+            || (call && nodes[i].function == CACHE_NONE)) return false;
+
+        // Globals and the results of calls live in the storage of the table,
+        // parameters and locals in the frame of the largest function.
+        if ((nodes[i].nodetype == SYNTAX_IDENTIFIER || call)
+            && (nodes[i].slot < 0 || nodes[i].slot >= header->slots))
+            return false;
+        if (nodes[i].nodetype == SYNTAX_LOCAL
+            && (nodes[i].slot < 0 || nodes[i].slot >= frame)) return false;
+    }
+    for (i=0; i<header->buckets; i++)
+        if (!CACHE_IN(items[i].identifier, header->strings)
+            || !CACHE_IN(items[i].list, header->params)
+            || !CACHE_IN(items[i].function, header->functions)
+            || (items[i].symtype != SYMBOL_EMPTY
+                && (items[i].slot < 0 || items[i].slot >= header->slots)))
+            return false;
+    #undef CACHE_IN
+    return true;
+}
+
+/**
+ * Cache Check Frame tells if every parameter or local of a list has an
+ * offset in the frame of its function. A list longer than the records
+ * loops, so it is damaged as well.
+ * @param   params  Records of the parameters and locals.
+ * @param   count   Amount of records.
+ * @param   first   Index of the first one of the list, CACHE_NONE if empty.
+ * @param   size    Size of the frame of the function.
+ * @return  True if the list fits the frame.
+ */
+bool cache_check_frame(cache_param * params, int count, int first, int size) {
+    int i;
+    int index = first;
+    for (i=0; index != CACHE_NONE; i++) {
+        if (i == count || params[index].offset < 0
+            || params[index].offset >= size) return false;
+        index = params[index].next;
+    }
+    return true;
+}
+
+/**
+ * Cache Load maps the cache of a program, if there is one for its current
+ * source and the same passes, and rebuilds the tree and the symbol table
+ * from it. The records hold indices instead of pointers, so the whole tree
+ * is rebuilt in one pass over them into a single block of nodes, and the
+ * identifiers are used in place from the mapping, which stays until
+ * cache_release.
+ * @param   directory   Directory of the caches.
+ * @param   file        Program file.
+ * @param   passes      Optimizer passes asked for.
+ * @param   node        Where to store the root of the main program.
+ * @param   table       Where to store the symbol table.
+ * @param   stats       Where to store what the optimizer did.
+ * @return  True if the program was loaded.
+ */
+bool cache_load(
+    char * directory,
+    char * file,
+    int passes,
+    syntax_node ** node,
+    symbol_table ** table,
+    optimize_stats * stats
+) {
+    int i;
+    unsigned long long hash;
+    long long length;
+    if (!cache_source(file, &hash, &length)) return false;
+
+    char path[CACHE_PATH];
+    struct stat status;
+    cache_path(directory, hash, passes, path);
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) return false;
+    if (fstat(descriptor, &status) < 0
+        || status.st_size < (off_t)sizeof(cache_header)) {
+        close(descriptor);
+        return false;
+    }
+    char * data = (char *)mmap(
+        NULL, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (data == MAP_FAILED) return false;
+
+    cache_header * header = (cache_header *)data;
+    if (memcmp(header->magic, CACHE_MAGIC, sizeof(header->magic)) != 0
+        || header->version != CACHE_VERSION
+        || header->handlers != cache_handler_count
+        || header->passes != passes || header->hash != hash
+        || header->length != length || !cache_check(header, status.st_size)) {
+        munmap(data, status.st_size);
+        return false;
+    }
+
+    cache_node * node_records = (cache_node *)(header + 1);
+    cache_param * param_records = (cache_param *)(
+        node_records + header->nodes);
+    cache_function * function_records = (cache_function *)(
+        param_records + header->params);
+    cache_item * item_records = (cache_item *)(
+        function_records + header->functions);
+    data_value * values = (data_value *)(item_records + header->buckets);
+    int * entries = (int *)(values + header->slots);
+    char * strings = (char *)(entries + header->entries);
+
+    syntax_node * nodes = syntax_allocate(header->nodes);
+    syntax_index base = syntax_locate(nodes);
+    syntax_index * lists = (syntax_index *)arena_allocate(global_arena,
+        ARENA_LIST, (header->entries + 1) * sizeof(syntax_index));
+    for (i=0; i<header->entries; i++) lists[i] = base + entries[i];
+    param_list * params = (param_list *)arena_allocate(global_arena,
+        ARENA_PARAM, (header->params + 1) * sizeof(param_list));
+    symbol_function * functions = (symbol_function *)arena_allocate(
+        global_arena, ARENA_FUNCTION,
+        (header->functions + 1) * sizeof(symbol_function));
+
+    #define CACHE_AT(base, index) ((index) == CACHE_NONE ? NULL : &(base)[index])
+    #define CACHE_NODE(index) \
+        ((index) == CACHE_NONE ? SYNTAX_NONE : base + (index))
+    for (i=0; i<header->nodes; i++) {
+        cache_node * record = &node_records[i];
+        nodes[i].handler = cache_handlers[record->handler];
+        nodes[i].nodetype = record->nodetype;
+        nodes[i].operation = record->operation;
+        nodes[i].evaluation = record->evaluation;
+        nodes[i].instruction = record->instruction;
+        nodes[i].slot = record->slot;
+        SYNTAX_LINE(&nodes[i]) = record->line;
+        nodes[i].identifier = CACHE_AT(strings, record->identifier);
+        nodes[i].value = record->value;
+        nodes[i].function = CACHE_AT(functions, record->function);
+        nodes[i].nodea = CACHE_NODE(record->nodea);
+        nodes[i].nodeb = CACHE_NODE(record->nodeb);
+        nodes[i].nodec = CACHE_NODE(record->nodec);
+        nodes[i].count = record->count;
+        nodes[i].list = record->count == 0 ? NULL : &lists[record->list];
+    }
+    for (i=0; i<header->params; i++) {
+        params[i].offset = param_records[i].offset;
+        params[i].identifier = CACHE_AT(strings, param_records[i].identifier);
+        params[i].value = param_records[i].value;
+        params[i].next = CACHE_AT(params, param_records[i].next);
+    }
+    for (i=0; i<header->functions; i++) {
+        functions[i].args = function_records[i].args;
+        functions[i].size = function_records[i].size;
+        functions[i].writes = function_records[i].writes;
+        functions[i].pure = function_records[i].pure;
+        functions[i].memoize = function_records[i].memoize;
+        functions[i].value = function_records[i].value;
+        functions[i].list = CACHE_AT(params, function_records[i].list);
+        functions[i].locals = CACHE_AT(params, function_records[i].locals);
+        functions[i].node = CACHE_AT(nodes, function_records[i].node);
+    }
+
+    symbol_table * loaded = (symbol_table *)calloc(1, sizeof(symbol_table));
+    loaded->size = header->size;
+    loaded->buckets = header->buckets;
+    loaded->slots = header->slots;
+    loaded->capacity = header->slots > SYMBOL_SLOTS
+        ? header->slots : SYMBOL_SLOTS;
+    loaded->values = (data_value *)calloc(
+        loaded->capacity, sizeof(data_value));
+    memcpy(loaded->values, values, header->slots * sizeof(data_value));
+    loaded->items = symbol_itemize(header->buckets);
+    for (i=0; i<header->buckets; i++) {
+        loaded->items[i].key = item_records[i].key;
+        loaded->items[i].slot = item_records[i].slot;
+        loaded->items[i].symtype = item_records[i].symtype;
+        loaded->items[i].identifier = CACHE_AT(
+            strings, item_records[i].identifier);
+        loaded->items[i].list = CACHE_AT(params, item_records[i].list);
+        loaded->items[i].function = CACHE_AT(
+            functions, item_records[i].function);
+    }
+    #undef CACHE_AT
+    #undef CACHE_NODE
+
+    *node = &nodes[header->root];
+    *table = loaded;
+    *stats = header->stats;
+    cache_mapping = data;
+    cache_mapping_size = status.st_size;
+    return true;
+}
+
+/**
+ * Cache Release unmaps the cache that was loaded, whose identifiers the tree
+ * and the symbol table use, so it must be called after them.
+ */
+void cache_release() {
+    if (cache_mapping == NULL) return;
+    munmap(cache_mapping, cache_mapping_size);
+    cache_mapping = NULL;
+    cache_mapping_size = 0;
+}
@@ -0,0 +1,133 @@
+#ifndef _CACHEH_
+#define _CACHEH_
+
+// Imports
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "arena.h"
+#include "data.h"
+#include "optimize.h"
+#include "symbol_table.h"
+#include "syntax_tree.h"
+
+// Definitions
+#define CACHE_MAGIC         "SSTCACHE"
+#define CACHE_VERSION       4
+#define CACHE_NONE          -1
+#define CACHE_PATH          4096
+#define CACHE_MAP_SIZE      1024
+#define CACHE_LIST_SIZE     256
+#define CACHE_FNV_BASIS     14695981039346656037ull
+#define CACHE_FNV_PRIME     1099511628211ull
+
+// Declarations
+typedef struct cache_header {
+    char magic[8];
+    int version;
+    int handlers;
+    int passes;
+    int root;
+    unsigned long long hash;
+    long long length;
+    int nodes;
+    int params;
+    int functions;
+    int buckets;
+    int size;
+    int slots;
+    int entries;
+    int strings;
+    struct optimize_stats stats;
+} cache_header;
+typedef struct cache_node {
+    int handler;
+    char nodetype;
+    char operation;
+    char evaluation;
+    char instruction;
+    int slot;
+    int line;
+    int identifier;
+    int function;
+    int nodea;
+    int nodeb;
+    int nodec;
+    int count;
+    int list;
+    data_value value;
+} cache_node;
+typedef struct cache_param {
+    int offset;
+    int identifier;
+    int next;
+    data_value value;
+} cache_param;
+typedef struct cache_function {
+    int args;
+    int size;
+    int writes;
+    int pure;
+    int memoize;
+    int list;
+    int locals;
+    int node;
+    data_value value;
+} cache_function;
+typedef struct cache_item {
+    unsigned int key;
+    int slot;
+    int symtype;
+    int identifier;
+    int list;
+    int function;
+} cache_item;
+typedef struct cache_shape {
+    char nodetype;
+    char instruction;
+    int children;
+} cache_shape;
+typedef struct cache_list {
+    int size;
+    int capacity;
+    void ** items;
+} cache_list;
+typedef struct cache_writer {
+    int size;
+    int used;
+    void ** keys;
+    int * indices;
+    struct cache_list nodes;
+    struct cache_list params;
+    struct cache_list functions;
+    int strings;
+    int capacity;
+    char * text;
+} cache_writer;
+
+bool cache_source(char *, unsigned long long *, long long *);
+void cache_path(char *, unsigned long long, int, char *);
+int cache_handler_index(syntax_handler);
+int cache_find(cache_writer *, void *);
+void cache_put(cache_writer *, void *, int);
+int cache_index(cache_writer *, cache_list *, void *, bool *);
+int cache_string(cache_writer *, char *);
+int cache_collect_node(cache_writer *, syntax_node *);
+int cache_collect_param(cache_writer *, param_list *);
+int cache_collect_function(cache_writer *, symbol_function *);
+bool cache_save(
+    char *, char *, int, syntax_node *, symbol_table *, optimize_stats *);
+bool cache_write(FILE *, cache_writer *, cache_header *, symbol_table *);
+bool cache_check(cache_header *, long long);
+bool cache_check_frame(cache_param *, int, int, int);
+bool cache_load(
+    char *, char *, int, syntax_node **, symbol_table **, optimize_stats *);
+void cache_release();
+
+#endif
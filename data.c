@@ -14,7 +14,8 @@
 
 /**
  * Struct Data Content stores the value of the number that the identifier is 
- * currently assigned to, and the type to know how to handle it.
+ * currently assigned to, and the type to know how to handle it. It fits in
+ * eight bytes, so it is passed, returned and stored by value.
  * @param   numtype     Type of the data.
  * @param   number      Value of the data.
  */
@@ -29,8 +30,8 @@
  * @param   two     Data of the second element.
  * @return  If both match the same numtype. 
  */
-bool data_numtype_match(data_value * one, data_value * two) {
-    return one->numtype == two->numtype;
+bool data_numtype_match(data_value one, data_value two) {
+    return one.numtype == two.numtype;
 }
 
 /**
@@ -39,13 +40,13 @@ bool data_numtype_match(data_value * one, data_value * two) {
  * @param   two     Data of the second element.
  * @return  If the evaluation was true or false.
  */
-bool data_evaluation(data_value * one, data_value * two, char operation) {
+bool data_evaluation(data_value one, data_value two, char operation) {
     if (!data_numtype_match(one, two))
         return false;
 
-    if (one->numtype == DATA_INTEGER) {
-        int input_one = one->number.int_value;
-        int input_two = two->number.int_value;
+    if (one.numtype == DATA_INTEGER) {
+        int input_one = one.number.int_value;
+        int input_two = two.number.int_value;
 
         switch (operation) {
             case DATA_LESS:     return input_one < input_two;
@@ -55,9 +56,9 @@ bool data_evaluation(data_value * one, data_value * two, char operation) {
             case DATA_GTE:      return input_one >= input_two;
             default:            return false;
         }
-    } else if (one->numtype == DATA_FLOAT) {
-        float input_one = one->number.float_value;
-        float input_two = two->number.float_value;
+    } else if (one.numtype == DATA_FLOAT) {
+        float input_one = one.number.float_value;
+        float input_two = two.number.float_value;
 
         switch (operation) {
             case DATA_LESS:     return input_one < input_two;
@@ -75,11 +76,11 @@ bool data_evaluation(data_value * one, data_value * two, char operation) {
  * @param   one     Data of the first element.
  * @return  If the evaluaton is zero.
  */
-bool data_zero(data_value * one) {
-    if (one->numtype == DATA_INTEGER)
-        return one->number.int_value == 0;
-    else if (one->numtype == DATA_FLOAT)
-        return one->number.float_value == 0;
+bool data_zero(data_value one) {
+    if (one.numtype == DATA_INTEGER)
+        return one.number.int_value == 0;
+    else if (one.numtype == DATA_FLOAT)
+        return one.number.float_value == 0;
     else return false;
 }
 
@@ -88,10 +89,10 @@ bool data_zero(data_value * one) {
  * @param   number      Value of this number.
  * @return  Data instance of an integer.
  */
-data_value * data_create_integer(int number) {
-    data_value * value = (data_value *)calloc(1, sizeof(data_value));
-    value->numtype = DATA_INTEGER;
-    value->number.int_value = number;
+data_value data_create_integer(int number) {
+    data_value value;
+    value.numtype = DATA_INTEGER;
+    value.number.int_value = number;
     return value;
 }
 
@@ -100,10 +101,10 @@ data_value * data_create_integer(int number) {
  * @param   number      Value of this number.
  * @return  Data instance of a float.
  */
-data_value * data_create_float(float number) {
-    data_value * value = (data_value *)calloc(1, sizeof(data_value));
-    value->numtype = DATA_FLOAT;
-    value->number.float_value = number;
+data_value data_create_float(float number) {
+    data_value value;
+    value.numtype = DATA_FLOAT;
+    value.number.float_value = number;
     return value;
 }
 
@@ -116,13 +117,13 @@ data_value * data_create_float(float number) {
  * @param   operation   Operation to do with the two datas.
  * @return  Arithmetic expression between the two.
  */
-data_value * data_operation(
-    data_value * one, data_value * two, char operation
+data_value data_operation(
+    data_value one, data_value two, char operation
 ){
     if (!data_numtype_match(one, two)) return data_create_integer(0);
-    if (one->numtype == DATA_INTEGER) {
-        int input_one = one->number.int_value;
-        int input_two = two->number.int_value;
+    if (one.numtype == DATA_INTEGER) {
+        int input_one = one.number.int_value;
+        int input_two = two.number.int_value;
         int output = 0;
 
         switch (operation) {
@@ -133,9 +134,9 @@ data_value * data_operation(
             default:                output = 0; break;
         }
         return data_create_integer(output);
-    } else if (one->numtype == DATA_FLOAT) {
-        float input_one = one->number.float_value;
-        float input_two = two->number.float_value;
+    } else if (one.numtype == DATA_FLOAT) {
+        float input_one = one.number.float_value;
+        float input_two = two.number.float_value;
         float output = 0;
 
         switch (operation) {
@@ -155,10 +156,10 @@ data_value * data_operation(
  * @param   one     Data of the only element.
  * @return  Negative data equivalent of the parameter.
  */
-data_value * data_negative(data_value * one) {
-    if (one->numtype == DATA_INTEGER)
-        return data_create_integer(one->number.int_value * (-1));
-    else if (one->numtype == DATA_FLOAT)
-        return data_create_float(one->number.float_value * (-1));
+data_value data_negative(data_value one) {
+    if (one.numtype == DATA_INTEGER)
+        return data_create_integer(one.number.int_value * (-1));
+    else if (one.numtype == DATA_FLOAT)
+        return data_create_float(one.number.float_value * (-1));
     else return data_create_integer(0);
 }
\ No newline at end of file
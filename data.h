@@ -33,12 +33,12 @@ typedef struct data_value {
     union data_number number;
 } data_value;
 
-bool data_numtype_match(data_value*, data_value*);
-bool data_evaluation(data_value*, data_value*, char);
-bool data_zero(data_value*);
-data_value * data_create_integer(int);
-data_value * data_create_float(float);
-data_value * data_operation(data_value*, data_value*, char);
-data_value * data_negative(data_value*);
+bool data_numtype_match(data_value, data_value);
+bool data_evaluation(data_value, data_value, char);
+bool data_zero(data_value);
+data_value data_create_integer(int);
+data_value data_create_float(float);
+data_value data_operation(data_value, data_value, char);
+data_value data_negative(data_value);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "embed.h"
+
+/**
+ * Embed Program is a program compiled once for a host that runs it many
+ * times. It is never written after it is compiled, so it can be shared by
+ * instances on any amount of threads.
+ * @param   arena   Arena of the tree and of the identifiers of the program.
+ * @param   table   Symbol table, its storage keeps the initial values.
+ * @param   code    Bytecode of the program.
+ */
+// typedef struct embed_program {
+//     struct arena * arena;
+//     struct symbol_table * table;
+//     struct bytecode_program * code;
+// } embed_program;
+
+/**
+ * Embed Instance is everything a run of a program writes, the storage of its
+ * identifiers, its temporaries and its call stack. Each host thread uses its
+ * own instances.
+ * @param   program Program the instance runs.
+ * @param   state   Registers and call stack of the runs.
+ */
+// typedef struct embed_instance {
+//     struct embed_program * program;
+//     struct bytecode_state * state;
+// } embed_instance;
+
+/**
+ * Embed Compile parses, optimizes and lowers the source of a program to
+ * bytecode. The tree is only used while compiling, so running the program
+ * costs no parsing and changes no node. Errors are printed like with a file.
+ * @param   source  Text of the program.
+ * @param   passes  Optimizer passes to run, such as OPTIMIZE_DEFAULT.
+ * @return  Program compiled, NULL if it was not accepted.
+ */
+embed_program * embed_compile(char * source, int passes) {
+    parse_context context = { 0 };
+    if (!flex_open_source(&context, source, strlen(source))) return NULL;
+
+    // The arena of the thread is given back, the program keeps its own.
+    arena * previous = global_arena;
+    context.arena = arena_initialize();
+    int success = bison_parse(&context);
+    flex_close(&context);
+
+    embed_program * program = NULL;
+    if (success == 0) {
+        optimize_stats stats;
+        syntax_node * node = optimize_program(
+            context.node, context.table, passes, &stats);
+        program = (embed_program *)calloc(1, sizeof(embed_program));
+        program->arena = context.arena;
+        program->table = context.table;
+        program->code = bytecode_compile(node, context.table);
+    } else {
+        symbol_release(context.table);
+        arena_release(context.arena);
+    }
+    syntax_arena(previous);
+    return program;
+}
+
+/**
+ * Embed Instantiate creates an instance of a program, with its identifiers
+ * at their initial values.
+ * @param   program Program to run.
+ * @return  Instance created.
+ */
+embed_instance * embed_instantiate(embed_program * program) {
+    embed_instance * instance;
+    instance = (embed_instance *)calloc(1, sizeof(embed_instance));
+    instance->program = program;
+    instance->state = bytecode_state_create();
+    embed_reset(instance);
+    return instance;
+}
+
+/**
+ * Embed Run runs the program of an instance once. Reads take the inputs in
+ * order, and read zero once there are no more, and prints write to the
+ * outputs. Every run starts from the initial values, since the optimizer may
+ * have folded them into the code, and the values it leaves can be read with
+ * embed_value until the next run or reset.
+ * @param   instance    Instance to run.
+ * @param   inputs      Values of the reads, may be NULL.
+ * @param   count       Amount of inputs.
+ * @param   outputs     Where to write the values printed, may be NULL.
+ * @param   capacity    Amount of outputs that fit.
+ * @return  Amount of values printed, more than capacity if some did not fit.
+ */
+int embed_run(
+    embed_instance * instance, data_value * inputs, int count,
+    data_value * outputs, int capacity) {
+    stream_record record;
+    record.inputs = inputs;
+    record.input_count = inputs != NULL ? count : 0;
+    record.outputs = outputs;
+    record.output_capacity = outputs != NULL ? capacity : 0;
+
+    embed_reset(instance);
+    stream_record_open(&record);
+    bytecode_run(instance->program->code, instance->state);
+    stream_record_close();
+    return record.output_count;
+}
+
+/**
+ * Embed Reset gives the identifiers of an instance their initial values, which
+ * is what every run starts from.
+ * @param   instance    Instance to reset.
+ */
+void embed_reset(embed_instance * instance) {
+    symbol_table * table = instance->program->table;
+    memcpy(instance->state->registers, table->values,
+        table->slots * sizeof(data_value));
+}
+
+/**
+ * Embed Value returns the value of a global identifier of an instance, or the
+ * last value returned by a function.
+ * @param   instance    Instance to read.
+ * @param   identifier  Identifier to read.
+ * @return  Value of the identifier, integer zero if it does not exist.
+ */
+data_value embed_value(embed_instance * instance, char * identifier) {
+    symbol_table * table = instance->program->table;
+    int i = symbol_search(table, identifier);
+    if (i == SYMBOL_NOT_FOUND || table->items[i].symtype == SYMBOL_LOCAL)
+        return data_create_integer(0);
+    return instance->state->registers[table->items[i].slot];
+}
+
+/**
+ * Embed Instance Release frees an instance, the program is kept.
+ * @param   instance    Instance to release.
+ */
+void embed_instance_release(embed_instance * instance) {
+    if (instance == NULL) return;
+    bytecode_state_release(instance->state);
+    free(instance);
+}
+
+/**
+ * Embed Release frees a program, once every instance of it was released.
+ * @param   program Program to release.
+ */
+void embed_release(embed_program * program) {
+    if (program == NULL) return;
+    bytecode_release(program->code);
+    symbol_release(program->table);
+    arena_release(program->arena);
+    free(program);
+}
@@ -0,0 +1,37 @@
+#ifndef _EMBEDH_
+#define _EMBEDH_
+
+// Imports
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "arena.h"
+#include "bytecode.h"
+#include "data.h"
+#include "optimize.h"
+#include "stream.h"
+#include "symbol_table.h"
+#include "syntax_tree.h"
+#include "bison.tab.h"
+
+// Declarations
+typedef struct embed_program {
+    struct arena * arena;
+    struct symbol_table * table;
+    struct bytecode_program * code;
+} embed_program;
+typedef struct embed_instance {
+    struct embed_program * program;
+    struct bytecode_state * state;
+} embed_instance;
+
+embed_program * embed_compile(char *, int);
+embed_instance * embed_instantiate(embed_program *);
+int embed_run(embed_instance *, data_value *, int, data_value *, int);
+void embed_reset(embed_instance *);
+data_value embed_value(embed_instance *, char *);
+void embed_instance_release(embed_instance *);
+void embed_release(embed_program *);
+
+#endif
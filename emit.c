@@ -0,0 +1,989 @@
+#include "emit.h"
+
+/**
+ * Emit Program is the state of the translation of a program to C. Storage
+ * slots become C variables named after their identifier, v_ followed by it,
+ * or after their slot for the temporaries of the optimizer. The ones a
+ * function uses are globals and the rest are locals of main. Parameters and
+ * locals of a function are named l_ and its identifier, or after their
+ * offset, and temporaries of an expression are named t and their index.
+ * @param   output      Where the code is written.
+ * @param   depth       Indentation of the statement being written.
+ * @param   temporaries Amount of temporaries of the function being written.
+ * @param   finish      Whether the main program returns before its end.
+ * @param   types       Type of each temporary.
+ * @param   names       Identifier of each storage slot, NULL for temporaries.
+ * @param   shared      Whether each storage slot is used by a function.
+ * @param   frame       Type of each offset of the frame being written.
+ * @param   locals      Identifier of each offset of the frame being written.
+ * @param   table       Symbol table of the program.
+ * @param   item        Item of the function being written, NULL for main.
+ */
+// typedef struct emit_program {
+//     FILE * output;
+//     int depth;
+//     int temporaries;
+//     bool finish;
+//     char * types;
+//     char ** names;
+//     bool * shared;
+//     char * frame;
+//     char ** locals;
+//     struct symbol_table * table;
+//     struct symbol_item * item;
+// } emit_program;
+
+// Global Values. Runtime of the emitted programs, the streams of stream.c.
+char * emit_runtime[] = {
+    "#include <stdio.h>",
+    "#include <stdlib.h>",
+    "#include <string.h>",
+    "#include <unistd.h>",
+    "",
+    "// Integers wrap around like they do in the interpreter.",
+    "#define RT_ADD(a, b)    ((int)((unsigned int)(a) + (unsigned int)(b)))",
+    "#define RT_SUB(a, b)    ((int)((unsigned int)(a) - (unsigned int)(b)))",
+    "#define RT_MUL(a, b)    ((int)((unsigned int)(a) * (unsigned int)(b)))",
+    "#define RT_NEG(a)       ((int)(0u - (unsigned int)(a)))",
+    "#define RT_OUTPUT_SIZE  1048576",
+    "#define RT_INPUT_SIZE   65536",
+    "#define RT_NUMBER_SIZE  64",
+    "",
+    "static int rt_batch = 0;",
+    "static int rt_output_used = 0;",
+    "static int rt_input_used = 0;",
+    "static int rt_input_length = 0;",
+    "static char rt_output[RT_OUTPUT_SIZE];",
+    "static char rt_input[RT_INPUT_SIZE];",
+    "",
+    "static void rt_flush(void) {",
+    "    if (!rt_batch || rt_output_used == 0) return;",
+    "    fwrite(rt_output, 1, rt_output_used, stdout);",
+    "    fflush(stdout);",
+    "    rt_output_used = 0;",
+    "}",
+    "",
+    "static void rt_initialize(int argc, char * argv[]) {",
+    "    int i;",
+    "    for (i=1; i<argc; i++)",
+    "        if (strcmp(argv[i], \"--batch\") == 0) rt_batch = 1;",
+    "    if (rt_batch) atexit(rt_flush);",
+    "}",
+    "",
+    "static void rt_full(void) {",
+    "    printf(\"Function: The call stack is full.\\n\");",
+    "    exit(EXIT_FAILURE);",
+    "}",
+    "",
+    "static int rt_as_int(float value) {",
+    "    union { int i; float f; } bits;",
+    "    bits.f = value;",
+    "    return bits.i;",
+    "}",
+    "",
+    "static float rt_as_float(int value) {",
+    "    union { int i; float f; } bits;",
+    "    bits.i = value;",
+    "    return bits.f;",
+    "}",
+    "",
+    "static void rt_print_integer(int value) {",
+    "    if (!rt_batch) {",
+    "        printf(\"\\nThe value is %d\\n\", value);",
+    "        return;",
+    "    }",
+    "    if (rt_output_used + RT_NUMBER_SIZE > RT_OUTPUT_SIZE) rt_flush();",
+    "",
+    "    char digits[RT_NUMBER_SIZE];",
+    "    int count = 0;",
+    "    unsigned int magnitude = value < 0 ? 0u - value : value;",
+    "    do {",
+    "        digits[count ++] = '0' + magnitude % 10;",
+    "        magnitude /= 10;",
+    "    } while (magnitude != 0);",
+    "",
+    "    char * data = rt_output + rt_output_used;",
+    "    if (value < 0) *data ++ = '-';",
+    "    while (count > 0) *data ++ = digits[-- count];",
+    "    *data ++ = '\\n';",
+    "    rt_output_used = data - rt_output;",
+    "}",
+    "",
+    "static void rt_print_float(float value) {",
+    "    if (!rt_batch) {",
+    "        printf(\"\\nThe value is %f\\n\", value);",
+    "        return;",
+    "    }",
+    "    if (rt_output_used + RT_NUMBER_SIZE > RT_OUTPUT_SIZE) rt_flush();",
+    "    rt_output_used += snprintf(rt_output + rt_output_used,",
+    "        RT_NUMBER_SIZE, \"%f\\n\", value);",
+    "}",
+    "",
+    "static int rt_next(void) {",
+    "    if (rt_input_used == rt_input_length) {",
+    "        ssize_t length = read(STDIN_FILENO, rt_input, RT_INPUT_SIZE);",
+    "        if (length <= 0) return EOF;",
+    "        rt_input_length = length;",
+    "        rt_input_used = 0;",
+    "    }",
+    "    return (unsigned char)rt_input[rt_input_used ++];",
+    "}",
+    "",
+    "static int rt_skip(void) {",
+    "    int character;",
+    "    do character = rt_next();",
+    "    while (character == ' ' || character == '\\n' || character == '\\t'",
+    "        || character == '\\r');",
+    "    return character;",
+    "}",
+    "",
+    "static int rt_read_integer(const char * identifier) {",
+    "    if (!rt_batch) {",
+    "        int input = 0;",
+    "        printf(\"\\nEnter an integer for the identifier %s : \",",
+    "            identifier);",
+    "        if (scanf(\"%d\", &input) != 1) return 0;",
+    "        return input;",
+    "    }",
+    "",
+    "    int character = rt_skip();",
+    "    int negative = character == '-';",
+    "    if (character == '-' || character == '+') character = rt_next();",
+    "",
+    "    unsigned int magnitude = 0;",
+    "    while (character >= '0' && character <= '9') {",
+    "        magnitude = magnitude * 10 + (character - '0');",
+    "        character = rt_next();",
+    "    }",
+    "    return negative ? (int)(0u - magnitude) : (int)magnitude;",
+    "}",
+    "",
+    "static float rt_read_float(const char * identifier) {",
+    "    if (!rt_batch) {",
+    "        float input = 0;",
+    "        printf(\"\\nEnter a float for the identifier %s :\", identifier);",
+    "        if (scanf(\"%f\", &input) != 1) return 0;",
+    "        return input;",
+    "    }",
+    "",
+    "    char number[RT_NUMBER_SIZE];",
+    "    int count = 0;",
+    "    int character = rt_skip();",
+    "    while (character != EOF && character != ' ' && character != '\\n'",
+    "        && character != '\\t' && character != '\\r') {",
+    "        if (count < RT_NUMBER_SIZE - 1) number[count ++] = character;",
+    "        character = rt_next();",
+    "    }",
+    "    number[count] = '\\0';",
+    "    return strtof(number, NULL);",
+    "}",
+    NULL
+};
+
+/**
+ * Emit Write translates an optimized program to a standalone C translation
+ * unit. Built with the system compiler, it prints what the interpreter prints
+ * for the program, symbol table included, and takes --batch like it does.
+ * @param   file    C file to write.
+ * @param   source  Program file, named in the header of the C file.
+ * @param   node    Root node of the main program.
+ * @param   table   Symbol table of the program.
+ * @return  Whether the file could be written.
+ */
+bool emit_write(
+    char * file, char * source, syntax_node * node, symbol_table * table
+) {
+    int i;
+    emit_program program;
+    program.output = fopen(file, "w");
+    if (program.output == NULL) return false;
+    program.depth = 0;
+    program.temporaries = 0;
+    program.finish = false;
+    program.types = NULL;
+    program.names = (char **)calloc(table->slots + 1, sizeof(char *));
+    program.shared = (bool *)calloc(table->slots + 1, sizeof(bool));
+    program.frame = NULL;
+    program.locals = NULL;
+    program.table = table;
+    program.item = NULL;
+
+    // Slots of functions keep their last result, which they write.
+    bool functions = false;
+    for (i=0; i<table->buckets; i++) {
+        symbol_item * item = &table->items[i];
+        if (item->symtype != SYMBOL_IDENTIFIER
+            && item->symtype != SYMBOL_FUNCTION) continue;
+        program.names[item->slot] = item->identifier;
+        if (item->symtype == SYMBOL_FUNCTION) {
+            functions = true;
+            program.shared[item->slot] = true;
+            emit_share(&program, item->function->node);
+        }
+    }
+
+    fprintf(program.output, "// Generated with --emit-c from %s.\n", source);
+    fprintf(program.output, "// Build it with: cc -O2 -ffp-contract=off\n");
+    for (i=0; emit_runtime[i] != NULL; i++)
+        fprintf(program.output, "%s\n", emit_runtime[i]);
+
+    // Frames of functions, storage they use, the functions and then main.
+    if (functions) {
+        fprintf(program.output, "\n#define RT_STACK        %d\n\n",
+            SYNTAX_STACK);
+        fprintf(program.output, "static int rt_top = 0;\n");
+    }
+    for (i=0; i<table->slots; i++)
+        if (program.shared[i])
+            emit_declare(&program, table->values[i].numtype,
+                'v', program.names[i], i, table->values[i].number);
+    fprintf(program.output, "\n");
+    for (i=0; i<table->buckets; i++)
+        if (table->items[i].symtype == SYMBOL_FUNCTION) {
+            emit_prototype(&program, &table->items[i]);
+            fprintf(program.output, ";\n");
+        }
+    fprintf(program.output, "\n");
+    for (i=0; i<table->buckets; i++)
+        if (table->items[i].symtype == SYMBOL_FUNCTION)
+            emit_function(&program, &table->items[i]);
+    emit_main(&program, node);
+
+    free(program.names);
+    free(program.shared);
+    return fclose(program.output) == 0;
+}
+
+/**
+ * Emit Share marks the storage slots that a function body reads or writes,
+ * which have to be C globals.
+ * @param   program Program being translated.
+ * @param   node    Node to look into.
+ */
+void emit_share(emit_program * program, syntax_node * node) {
+    int i;
+    if (node == NULL) return;
+    if (node->nodetype == SYNTAX_IDENTIFIER) program->shared[node->slot] = true;
+    if (node->nodetype != SYNTAX_INSTRUCTION) return;
+    emit_share(program, SYNTAX_NODEA(node));
+    emit_share(program, SYNTAX_NODEB(node));
+    emit_share(program, SYNTAX_NODEC(node));
+    for (i=0; i<node->count; i++)
+        emit_share(program, SYNTAX_AT(node->list[i]));
+}
+
+/**
+ * Emit Frame takes the types of the frame offsets that are not parameters or
+ * locals, the temporaries the optimizer added, from the nodes that use them.
+ * @param   program Program being translated.
+ * @param   node    Node to look into.
+ */
+void emit_frame(emit_program * program, syntax_node * node) {
+    int i;
+    if (node == NULL) return;
+    if (node->nodetype == SYNTAX_LOCAL && program->frame[node->slot] == '\0')
+        program->frame[node->slot] = node->value.numtype;
+    if (node->nodetype != SYNTAX_INSTRUCTION) return;
+    emit_frame(program, SYNTAX_NODEA(node));
+    emit_frame(program, SYNTAX_NODEB(node));
+    emit_frame(program, SYNTAX_NODEC(node));
+    for (i=0; i<node->count; i++)
+        emit_frame(program, SYNTAX_AT(node->list[i]));
+}
+
+/**
+ * Emit Prototype writes the declaration of the C function of a function, so
+ * that functions can call each other in any order.
+ * @param   program Program being translated.
+ * @param   item    Item of the function.
+ */
+void emit_prototype(emit_program * program, symbol_item * item) {
+    symbol_function * function = item->function;
+    param_list * param;
+    fprintf(program->output, "static %s f_%s(",
+        emit_type_name(function->value.numtype), item->identifier);
+    for (param = function->list; param != NULL; param = param->next)
+        fprintf(program->output, "%s%s l_%s",
+            param == function->list ? "" : ", ",
+            emit_type_name(param->value.numtype), param->identifier);
+    fprintf(program->output, function->list == NULL ? "void)" : ")");
+}
+
+/**
+ * Emit Function writes the C function of a function. It keeps the frames on
+ * the same budget as the tree interpreter, so a recursion that is too deep
+ * stops with the same error, and every return stores the result in the slot
+ * of the function like a call does. The body is written first, since its
+ * temporaries are declared before it.
+ * @param   program Program being translated.
+ * @param   item    Item of the function.
+ */
+void emit_function(emit_program * program, symbol_item * item) {
+    int i;
+    symbol_function * function = item->function;
+    param_list * entry;
+    program->item = item;
+    program->temporaries = 0;
+    program->frame = (char *)calloc(function->size + 1, sizeof(char));
+    program->locals = (char **)calloc(function->size + 1, sizeof(char *));
+    for (entry = function->list; entry != NULL; entry = entry->next) {
+        program->frame[entry->offset] = entry->value.numtype;
+        program->locals[entry->offset] = entry->identifier;
+    }
+    for (entry = function->locals; entry != NULL; entry = entry->next) {
+        program->frame[entry->offset] = entry->value.numtype;
+        program->locals[entry->offset] = entry->identifier;
+    }
+    emit_frame(program, function->node);
+
+    // Body, ending with the zero of a function that does not return.
+    syntax_node * last = function->node;
+    while (last != NULL && last->nodetype == SYNTAX_INSTRUCTION
+        && last->instruction == SYNTAX_STMT)
+        last = last->count > 0
+            ? SYNTAX_AT(last->list[last->count - 1]) : NULL;
+    bool returns = last != NULL && last->nodetype == SYNTAX_INSTRUCTION
+        && last->instruction == SYNTAX_RETURN;
+
+    FILE * output = program->output;
+    char * body = NULL;
+    size_t length = 0;
+    program->output = open_memstream(&body, &length);
+    program->depth = 1;
+    emit_statement(program, function->node);
+    if (!returns) emit_epilogue(program);
+    fclose(program->output);
+    program->output = output;
+
+    // Locals start like in a new frame, the parameters are the arguments.
+    emit_prototype(program, item);
+    fprintf(program->output, " {\n");
+    for (i=0; i<function->size; i++) {
+        if (program->frame[i] == '\0') continue;
+        bool parameter = false;
+        for (entry = function->list; entry != NULL; entry = entry->next)
+            if (entry->offset == i) parameter = true;
+        if (parameter) continue;
+
+        data_number zero;
+        zero.int_value = 0;
+        data_number initial = zero;
+        for (entry = function->locals; entry != NULL; entry = entry->next)
+            if (entry->offset == i) initial = entry->value.number;
+        emit_declare(program, program->frame[i], 'l',
+            program->locals[i], i, initial);
+    }
+    for (i=0; i<program->temporaries; i++)
+        fprintf(program->output, "    %s t%d;\n",
+            emit_type_name(program->types[i]), i);
+    if (function->size > 0) {
+        fprintf(program->output, "    if (rt_top + %d > RT_STACK) rt_full();\n",
+            function->size);
+        fprintf(program->output, "    rt_top += %d;\n", function->size);
+    }
+    fwrite(body, 1, length, program->output);
+    fprintf(program->output, "}\n\n");
+
+    free(body);
+    free(program->frame);
+    free(program->locals);
+    free(program->types);
+    program->frame = NULL;
+    program->locals = NULL;
+    program->types = NULL;
+    program->item = NULL;
+}
+
+/**
+ * Emit Epilogue writes the end of a function that does not return, which
+ * gives the value the function was declared with, zero.
+ * @param   program Program being translated.
+ */
+void emit_epilogue(emit_program * program) {
+    data_value value = program->item->function->value;
+    emit_indent(program);
+    fprintf(program->output, "v_%s = ", program->item->identifier);
+    emit_constant(program, value.number, value.numtype);
+    fprintf(program->output, ";\n");
+    emit_leave(program);
+}
+
+/**
+ * Emit Leave pops the frame of the function being written and returns the
+ * result kept in its slot.
+ * @param   program Program being translated.
+ */
+void emit_leave(emit_program * program) {
+    symbol_item * item = program->item;
+    if (item->function->size > 0) {
+        emit_indent(program);
+        fprintf(program->output, "rt_top -= %d;\n", item->function->size);
+    }
+    emit_indent(program);
+    fprintf(program->output, "return v_%s;\n", item->identifier);
+}
+
+/**
+ * Emit Main writes main, which runs the main program over the storage that
+ * no function uses, then prints the symbol table.
+ * @param   program Program being translated.
+ * @param   node    Root node of the main program.
+ */
+void emit_main(emit_program * program, syntax_node * node) {
+    int i;
+    symbol_table * table = program->table;
+    program->temporaries = 0;
+
+    FILE * output = program->output;
+    char * body = NULL;
+    size_t length = 0;
+    program->output = open_memstream(&body, &length);
+    program->depth = 1;
+    emit_statement(program, node);
+    fclose(program->output);
+    program->output = output;
+
+    fprintf(program->output, "int main(int argc, char * argv[]) {\n");
+    for (i=0; i<table->slots; i++)
+        if (!program->shared[i])
+            emit_declare(program, table->values[i].numtype,
+                'v', program->names[i], i, table->values[i].number);
+    for (i=0; i<program->temporaries; i++)
+        fprintf(program->output, "    %s t%d;\n",
+            emit_type_name(program->types[i]), i);
+    fprintf(program->output, "    rt_initialize(argc, argv);\n");
+    fwrite(body, 1, length, program->output);
+    if (program->finish) fprintf(program->output, "finish:\n");
+    emit_symbols(program);
+    fprintf(program->output, "    return 0;\n}\n");
+
+    free(body);
+    free(program->types);
+    program->types = NULL;
+}
+
+/**
+ * Emit Declare writes the declaration of a variable with its initial value.
+ * Globals are declared at the start of the file, the rest in their function.
+ * @param   program     Program being translated.
+ * @param   numtype     Type of the variable.
+ * @param   prefix      v for storage slots, l for frame offsets.
+ * @param   identifier  Identifier of the variable, NULL for temporaries.
+ * @param   index       Slot or offset of the variable.
+ * @param   initial     Initial value of the variable.
+ */
+void emit_declare(
+    emit_program * program, char numtype, char prefix, char * identifier,
+    int index, data_number initial
+) {
+    bool global = prefix == 'v' && program->shared[index];
+    fprintf(program->output, global ? "static %s " : "    %s ",
+        emit_type_name(numtype));
+    if (identifier != NULL)
+        fprintf(program->output, "%c_%s", prefix, identifier);
+    else fprintf(program->output, "%c%d", prefix, index);
+    fprintf(program->output, " = ");
+    emit_constant(program, initial, numtype);
+    fprintf(program->output, ";\n");
+}
+
+/**
+ * Emit Symbols writes the printing of the symbol table at the end of main, as
+ * symbol_print would print it. Everything but the values is known already.
+ * @param   program Program being translated.
+ */
+void emit_symbols(emit_program * program) {
+    int i;
+    char row[EMIT_ROW_SIZE];
+    symbol_table * table = program->table;
+    fprintf(program->output, "    rt_flush();\n");
+    fprintf(program->output, "    printf(\"\\nSymbol Table:\\n\");\n");
+    snprintf(row, sizeof(row), "%4s%10s%10s%10s%10s",
+        "pos", "key", "name", "type", "value");
+    fprintf(program->output, "    printf(\"%s\\n\\n\");\n", row);
+
+    for (i=0; i<table->buckets; i++) {
+        symbol_item * item = &table->items[i];
+        if (item->symtype == SYMBOL_EMPTY) continue;
+        data_value value = table->values[item->slot];
+        char * type = value.numtype == DATA_INTEGER ? "integer"
+            : value.numtype == DATA_FLOAT ? "float" : "unknown";
+        snprintf(row, sizeof(row), "[%2d]%10u%10s%10s",
+            i, item->key, item->identifier, type);
+
+        fprintf(program->output, "    printf(\"%s", row);
+        if (value.numtype == DATA_INTEGER || value.numtype == DATA_FLOAT) {
+            fprintf(program->output, value.numtype == DATA_INTEGER
+                ? "%%10d\\n\", " : "%%10f\\n\", ");
+            if (program->names[item->slot] != NULL)
+                fprintf(program->output, "v_%s", program->names[item->slot]);
+            else fprintf(program->output, "v%d", item->slot);
+        } else fprintf(program->output, "%10d\\n\"", 0);
+        fprintf(program->output, ");\n");
+    }
+    fprintf(program->output, "    printf(\"\\n\");\n");
+}
+
+/**
+ * Emit Statement writes a statement, or each one of a STMT list.
+ * @param   program Program being translated.
+ * @param   node    Node of the statement.
+ */
+void emit_statement(emit_program * program, syntax_node * node) {
+    FILE * output = program->output;
+    symbol_item * item = program->item;
+    int i;
+    char numtype;
+
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return;
+
+    switch (node->instruction) {
+        case SYNTAX_STMT:
+            for (i=0; i<node->count; i++)
+                emit_statement(program, SYNTAX_AT(node->list[i]));
+            break;
+        case SYNTAX_ASSIGN:
+            emit_indent(program);
+            emit_variable(program, SYNTAX_NODEA(node));
+            fprintf(output, " = ");
+            emit_expression(program, SYNTAX_NODEB(node),
+                emit_type(program, SYNTAX_NODEA(node)));
+            fprintf(output, ";\n");
+            break;
+        case SYNTAX_IF:
+        case SYNTAX_IFELSE:
+            emit_indent(program);
+            fprintf(output, "if ");
+            emit_condition(program, SYNTAX_NODEA(node));
+            fprintf(output, " {\n");
+            program->depth ++;
+            emit_statement(program, SYNTAX_NODEB(node));
+            program->depth --;
+            emit_indent(program);
+            if (node->instruction == SYNTAX_IF) {
+                fprintf(output, "}\n");
+                break;
+            }
+            fprintf(output, "} else {\n");
+            program->depth ++;
+            emit_statement(program, SYNTAX_NODEC(node));
+            program->depth --;
+            emit_indent(program);
+            fprintf(output, "}\n");
+            break;
+        case SYNTAX_WHILE:
+            emit_indent(program);
+            fprintf(output, "while ");
+            emit_condition(program, SYNTAX_NODEA(node));
+            fprintf(output, " {\n");
+            program->depth ++;
+            emit_statement(program, SYNTAX_NODEB(node));
+            program->depth --;
+            emit_indent(program);
+            fprintf(output, "}\n");
+            break;
+        case SYNTAX_READ:
+            // The read has the type of the node, the variable keeps its.
+            numtype = SYNTAX_NODEA(node)->value.numtype;
+            emit_indent(program);
+            emit_variable(program, SYNTAX_NODEA(node));
+            fprintf(output, " = ");
+            if (numtype != emit_type(program, SYNTAX_NODEA(node)))
+                fprintf(output, numtype == DATA_INTEGER
+                    ? "rt_as_float(" : "rt_as_int(");
+            fprintf(output, numtype == DATA_INTEGER
+                ? "rt_read_integer(\"%s\")" : "rt_read_float(\"%s\")",
+                SYNTAX_NODEA(node)->identifier);
+            if (numtype != emit_type(program, SYNTAX_NODEA(node)))
+                fprintf(output, ")");
+            fprintf(output, ";\n");
+            break;
+        case SYNTAX_PRINT:
+            numtype = SYNTAX_NODEA(node)->value.numtype;
+            emit_indent(program);
+            fprintf(output, numtype == DATA_INTEGER
+                ? "rt_print_integer(" : "rt_print_float(");
+            emit_expression(program, SYNTAX_NODEA(node), numtype);
+            fprintf(output, ");\n");
+            break;
+        case SYNTAX_RETURN:
+            // A return of the main program ends it.
+            if (item == NULL) {
+                if (bytecode_has_call(SYNTAX_NODEA(node))) {
+                    emit_indent(program);
+                    fprintf(output, "(void)");
+                    emit_value(program, SYNTAX_NODEA(node));
+                    fprintf(output, ";\n");
+                }
+                emit_indent(program);
+                fprintf(output, "goto finish;\n");
+                program->finish = true;
+                break;
+            }
+            emit_indent(program);
+            fprintf(output, "v_%s = ", item->identifier);
+            emit_expression(program, SYNTAX_NODEA(node),
+                program->table->values[item->slot].numtype);
+            fprintf(output, ";\n");
+            emit_leave(program);
+            break;
+        default:
+            if (!bytecode_has_call(node)) break;
+            emit_indent(program);
+            fprintf(output, "(void)");
+            emit_value(program, node);
+            fprintf(output, ";\n");
+            break;
+    }
+}
+
+/**
+ * Emit Condition writes an EXPRESSION as a C condition between parentheses.
+ * Both sides are compared with the type of the first one.
+ * @param   program Program being translated.
+ * @param   node    Node of the expression.
+ */
+void emit_condition(emit_program * program, syntax_node * node) {
+    char numtype = SYNTAX_NODEA(node)->value.numtype;
+    switch (node->operation) {
+        case DATA_ZERO:
+            fprintf(program->output, "(");
+            emit_expression(program, SYNTAX_NODEA(node), numtype);
+            fprintf(program->output, " != 0)");
+            break;
+        case DATA_LESS:
+            emit_binary(program, SYNTAX_NODEA(node), SYNTAX_NODEB(node),
+                numtype, "(", " < ", ")");
+            break;
+        case DATA_GREATER:
+            emit_binary(program, SYNTAX_NODEA(node), SYNTAX_NODEB(node),
+                numtype, "(", " > ", ")");
+            break;
+        case DATA_EQUALS:
+            emit_binary(program, SYNTAX_NODEA(node), SYNTAX_NODEB(node),
+                numtype, "(", " == ", ")");
+            break;
+        case DATA_LTE:
+            emit_binary(program, SYNTAX_NODEA(node), SYNTAX_NODEB(node),
+                numtype, "(", " <= ", ")");
+            break;
+        case DATA_GTE:
+            emit_binary(program, SYNTAX_NODEA(node), SYNTAX_NODEB(node),
+                numtype, "(", " >= ", ")");
+            break;
+        default:
+            // Unknown relops never evaluate to true.
+            fprintf(program->output, "(0)");
+            break;
+    }
+}
+
+/**
+ * Emit Expression writes an expression as a value of the given type. A value
+ * of the other type keeps its bits, as in the registers of the bytecode.
+ * @param   program Program being translated.
+ * @param   node    Node of the expression.
+ * @param   numtype Type wanted.
+ */
+void emit_expression(emit_program * program, syntax_node * node, char numtype) {
+    if (node->nodetype == SYNTAX_VALUE) {
+        emit_constant(program, node->value.number, numtype);
+        return;
+    }
+    if (emit_type(program, node) == numtype) {
+        emit_value(program, node);
+        return;
+    }
+    fprintf(program->output,
+        numtype == DATA_INTEGER ? "rt_as_int(" : "rt_as_float(");
+    emit_value(program, node);
+    fprintf(program->output, ")");
+}
+
+/**
+ * Emit Value writes an EXPR, TERM, FUNCTION, identifier or value with its own
+ * type. Mixed types evaluate to the integer zero, as in data_operation.
+ * @param   program Program being translated.
+ * @param   node    Node of the expression.
+ */
+void emit_value(emit_program * program, syntax_node * node) {
+    FILE * output = program->output;
+    char numtype;
+
+    switch (node->nodetype) {
+        case SYNTAX_IDENTIFIER:
+        case SYNTAX_LOCAL:
+            emit_variable(program, node);
+            return;
+        case SYNTAX_VALUE:
+            emit_constant(program, node->value.number, node->value.numtype);
+            return;
+        case SYNTAX_INSTRUCTION:
+            break;
+        default:
+            fprintf(output, "0");
+            return;
+    }
+
+    switch (node->instruction) {
+        case SYNTAX_EXPR:
+        case SYNTAX_TERM:
+            numtype = SYNTAX_NODEA(node)->value.numtype;
+            if (node->operation == DATA_NEGATIVE) {
+                fprintf(output, numtype == DATA_INTEGER ? "RT_NEG(" : "(");
+                emit_expression(program, SYNTAX_NODEA(node), numtype);
+                fprintf(output, numtype == DATA_INTEGER ? ")" : " * -1.0f)");
+                return;
+            }
+            if (numtype != SYNTAX_NODEB(node)->value.numtype) {
+                fprintf(output, "0");
+                return;
+            }
+
+            bool integer = numtype == DATA_INTEGER;
+            switch (node->operation) {
+                case DATA_SUM:
+                    emit_binary(program, SYNTAX_NODEA(node), SYNTAX_NODEB(node),
+                        numtype, integer ? "RT_ADD(" : "(",
+                        integer ? ", " : " + ", ")");
+                    break;
+                case DATA_SUBSTRACT:
+                    emit_binary(program, SYNTAX_NODEA(node), SYNTAX_NODEB(node),
+                        numtype, integer ? "RT_SUB(" : "(",
+                        integer ? ", " : " - ", ")");
+                    break;
+                case DATA_MULTIPLY:
+                    emit_binary(program, SYNTAX_NODEA(node), SYNTAX_NODEB(node),
+                        numtype, integer ? "RT_MUL(" : "(",
+                        integer ? ", " : " * ", ")");
+                    break;
+                case DATA_DIVIDE:
+                    emit_binary(program, SYNTAX_NODEA(node), SYNTAX_NODEB(node),
+                        numtype, "(", " / ", ")");
+                    break;
+                default:
+                    fprintf(output, "0");
+                    break;
+            }
+            return;
+        case SYNTAX_FUNCTION:
+            emit_call(program, node);
+            return;
+        default:
+            fprintf(output, "0");
+            return;
+    }
+}
+
+/**
+ * Emit Binary writes two operands between open, middle and close. C does not
+ * order the evaluation of operands, so when one of them calls a function that
+ * may change what the other one reads, the first one goes to a temporary
+ * before, as the tree interpreter evaluates it first.
+ * @param   program Program being translated.
+ * @param   nodea   First operand.
+ * @param   nodeb   Second operand.
+ * @param   numtype Type of both operands.
+ * @param   open    Text before the first operand.
+ * @param   middle  Text between the operands.
+ * @param   close   Text after the second operand.
+ */
+void emit_binary(
+    emit_program * program, syntax_node * nodea, syntax_node * nodeb,
+    char numtype, char * open, char * middle, char * close
+) {
+    int temporary = -1;
+    bool calls = bytecode_has_call(nodea) || bytecode_has_call(nodeb);
+    if (calls && !emit_is_stable(program, nodea)
+        && !emit_is_stable(program, nodeb)) {
+        temporary = emit_temporary(program, numtype);
+        fprintf(program->output, "(t%d = ", temporary);
+        emit_expression(program, nodea, numtype);
+        fprintf(program->output, ", ");
+    }
+
+    fprintf(program->output, "%s", open);
+    if (temporary >= 0) fprintf(program->output, "t%d", temporary);
+    else emit_expression(program, nodea, numtype);
+    fprintf(program->output, "%s", middle);
+    emit_expression(program, nodeb, numtype);
+    fprintf(program->output, "%s", close);
+    if (temporary >= 0) fprintf(program->output, ")");
+}
+
+/**
+ * Emit Call writes a call, with each argument as the type of its parameter.
+ * Arguments are evaluated in order like in the tree interpreter, so the ones
+ * that call a function or read what one may change go to temporaries first,
+ * but for the last one.
+ * @param   program Program being translated.
+ * @param   node    Node of the FUNCTION.
+ */
+void emit_call(emit_program * program, syntax_node * node) {
+    int i;
+    int last = -1;
+    int count = node->function->args;
+    int * hoisted = (int *)malloc((count + 1) * sizeof(int));
+    syntax_node * arg;
+    param_list * param;
+
+    bool calls = false;
+    for (i=0, arg=SYNTAX_NODEA(node); arg != NULL; i++, arg=SYNTAX_NODEB(arg)) {
+        if (!emit_is_stable(program, SYNTAX_NODEA(arg))) last = i;
+        if (bytecode_has_call(SYNTAX_NODEA(arg))) calls = true;
+    }
+    if (!calls) last = -1;
+
+    bool sequence = false;
+    param = node->function->list;
+    for (i=0, arg=SYNTAX_NODEA(node); arg != NULL; i++, arg=SYNTAX_NODEB(arg)) {
+        hoisted[i] = -1;
+        if (i < last && !emit_is_stable(program, SYNTAX_NODEA(arg))) {
+            hoisted[i] = emit_temporary(program, param->value.numtype);
+            fprintf(program->output, "%st%d = ",
+                sequence ? "" : "(", hoisted[i]);
+            emit_expression(program, SYNTAX_NODEA(arg), param->value.numtype);
+            fprintf(program->output, ", ");
+            sequence = true;
+        }
+        param = param->next;
+    }
+
+    fprintf(program->output, "f_%s(", node->identifier);
+    param = node->function->list;
+    for (i=0, arg=SYNTAX_NODEA(node); arg != NULL; i++, arg=SYNTAX_NODEB(arg)) {
+        if (i > 0) fprintf(program->output, ", ");
+        if (hoisted[i] >= 0) fprintf(program->output, "t%d", hoisted[i]);
+        else emit_expression(program, SYNTAX_NODEA(arg), param->value.numtype);
+        param = param->next;
+    }
+    fprintf(program->output, sequence ? "))" : ")");
+    free(hoisted);
+}
+
+/**
+ * Emit Variable writes the name of the C variable of an identifier or local.
+ * @param   program Program being translated.
+ * @param   node    Node of the identifier or local.
+ */
+void emit_variable(emit_program * program, syntax_node * node) {
+    char prefix = node->nodetype == SYNTAX_LOCAL ? 'l' : 'v';
+    char * identifier = node->nodetype == SYNTAX_LOCAL
+        ? program->locals[node->slot] : program->names[node->slot];
+    if (identifier != NULL)
+        fprintf(program->output, "%c_%s", prefix, identifier);
+    else fprintf(program->output, "%c%d", prefix, node->slot);
+}
+
+/**
+ * Emit Constant writes a number as a C constant of the given type, keeping
+ * its bits. Floats are written in hexadecimal, which is exact.
+ * @param   program Program being translated.
+ * @param   number  Number to write.
+ * @param   numtype Type of the constant.
+ */
+void emit_constant(emit_program * program, data_number number, char numtype) {
+    FILE * output = program->output;
+    if (numtype == DATA_FLOAT) {
+        float value = number.float_value;
+        if (!isfinite(value))
+            fprintf(output, "rt_as_float(%d)", number.int_value);
+        else if (value == 0 && !signbit(value)) fprintf(output, "0.0f");
+        else if (signbit(value)) fprintf(output, "(%af)", value);
+        else fprintf(output, "%af", value);
+    } else if (number.int_value == INT_MIN)
+        fprintf(output, "(%d - 1)", INT_MIN + 1);
+    else if (number.int_value < 0)
+        fprintf(output, "(%d)", number.int_value);
+    else fprintf(output, "%d", number.int_value);
+}
+
+/**
+ * Emit Indent writes the indentation of the statement being written.
+ * @param   program Program being translated.
+ */
+void emit_indent(emit_program * program) {
+    fprintf(program->output, "%*s", program->depth * EMIT_INDENT, "");
+}
+
+/**
+ * Emit Temporary reserves a temporary of the function being written.
+ * @param   program Program being translated.
+ * @param   numtype Type of the temporary.
+ * @return  Index of the temporary.
+ */
+int emit_temporary(emit_program * program, char numtype) {
+    program->types = (char *)realloc(program->types,
+        (program->temporaries + 1) * sizeof(char));
+    program->types[program->temporaries] = numtype;
+    return program->temporaries ++;
+}
+
+/**
+ * Emit Type returns the type of the C value of a node. Variables have the
+ * type they were declared with, and operations the type of their first
+ * operand, as in the bytecode.
+ * @param   program Program being translated.
+ * @param   node    Node of the expression.
+ * @return  DATA_INTEGER or DATA_FLOAT.
+ */
+char emit_type(emit_program * program, syntax_node * node) {
+    switch (node->nodetype) {
+        case SYNTAX_IDENTIFIER:
+            return program->table->values[node->slot].numtype;
+        case SYNTAX_LOCAL:
+            return program->frame[node->slot];
+        case SYNTAX_VALUE:
+            return node->value.numtype;
+        case SYNTAX_INSTRUCTION:
+            break;
+        default:
+            return DATA_INTEGER;
+    }
+
+    switch (node->instruction) {
+        case SYNTAX_EXPR:
+        case SYNTAX_TERM:
+            if (node->operation != DATA_NEGATIVE
+                && SYNTAX_NODEA(node)->value.numtype
+                    != SYNTAX_NODEB(node)->value.numtype)
+                return DATA_INTEGER;
+            return SYNTAX_NODEA(node)->value.numtype;
+        case SYNTAX_FUNCTION:
+            return node->function->value.numtype;
+        default:
+            return DATA_INTEGER;
+    }
+}
+
+/**
+ * Emit Type Name returns the C type of a numtype.
+ * @param   numtype Type of the data.
+ * @return  Name of the C type.
+ */
+char * emit_type_name(char numtype) {
+    return numtype == DATA_FLOAT ? "float" : "int";
+}
+
+/**
+ * Emit Is Stable tells if an expression can be evaluated in any order with
+ * the ones around it, because it calls no function and only reads values,
+ * locals and storage that no function uses.
+ * @param   program Program being translated.
+ * @param   node    Node of the expression.
+ * @return  True if the expression is stable.
+ */
+bool emit_is_stable(emit_program * program, syntax_node * node) {
+    if (node == NULL) return true;
+    switch (node->nodetype) {
+        case SYNTAX_IDENTIFIER:
+            return !program->shared[node->slot];
+        case SYNTAX_INSTRUCTION:
+            if (node->instruction == SYNTAX_FUNCTION) return false;
+            return emit_is_stable(program, SYNTAX_NODEA(node))
+                && emit_is_stable(program, SYNTAX_NODEB(node))
+                && emit_is_stable(program, SYNTAX_NODEC(node));
+        default:
+            return true;
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef _EMITH_
+#define _EMITH_
+
+// Imports
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <math.h>
+#include "bytecode.h"
+#include "data.h"
+#include "symbol_table.h"
+#include "syntax_tree.h"
+
+// Definitions
+#define EMIT_INDENT         4
+#define EMIT_ROW_SIZE       128
+
+// Declarations
+typedef struct emit_program {
+    FILE * output;
+    int depth;
+    int temporaries;
+    bool finish;
+    char * types;
+    char ** names;
+    bool * shared;
+    char * frame;
+    char ** locals;
+    struct symbol_table * table;
+    struct symbol_item * item;
+} emit_program;
+
+bool emit_write(char *, char *, syntax_node *, symbol_table *);
+void emit_share(emit_program *, syntax_node *);
+void emit_frame(emit_program *, syntax_node *);
+void emit_prototype(emit_program *, symbol_item *);
+void emit_function(emit_program *, symbol_item *);
+void emit_epilogue(emit_program *);
+void emit_leave(emit_program *);
+void emit_main(emit_program *, syntax_node *);
+void emit_declare(emit_program *, char, char, char *, int, data_number);
+void emit_symbols(emit_program *);
+void emit_statement(emit_program *, syntax_node *);
+void emit_condition(emit_program *, syntax_node *);
+void emit_expression(emit_program *, syntax_node *, char);
+void emit_value(emit_program *, syntax_node *);
+void emit_binary(
+    emit_program *, syntax_node *, syntax_node *, char, char *, char *, char *
+);
+void emit_call(emit_program *, syntax_node *);
+void emit_variable(emit_program *, syntax_node *);
+void emit_constant(emit_program *, data_number, char);
+void emit_indent(emit_program *);
+int emit_temporary(emit_program *, char);
+char emit_type(emit_program *, syntax_node *);
+char * emit_type_name(char);
+bool emit_is_stable(emit_program *, syntax_node *);
+
+#endif
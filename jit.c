@@ -0,0 +1,895 @@
+#include "jit.h"
+
+/**
+ * Jit Loop is what is known of a while of the program, the iterations it ran
+ * while it was interpreted and the machine code once it was compiled.
+ * @param   count   Iterations it ran in the interpreter.
+ * @param   code    Machine code of the loop, NULL until it is compiled.
+ * @param   size    Size of the pages of the code.
+ */
+// typedef struct jit_loop {
+//     long count;
+//     jit_code code;
+//     size_t size;
+// } jit_loop;
+
+/**
+ * Jit Variable is an identifier or a local used by a loop being compiled.
+ * Its type is the one it has when the loop is compiled, and it is kept in a
+ * register while the loop runs if it is one of the most used of its type.
+ * @param   nodetype    SYNTAX_IDENTIFIER for storage, SYNTAX_LOCAL for frame.
+ * @param   numtype     Type of its value.
+ * @param   slot        Slot of the storage, or offset in the frame.
+ * @param   uses        Times it appears in the loop.
+ * @param   reg         Register that holds it, JIT_NONE if it is in memory.
+ */
+// typedef struct jit_variable {
+//     char nodetype;
+//     char numtype;
+//     int slot;
+//     int uses;
+//     int reg;
+// } jit_variable;
+
+/**
+ * Jit Compiler is the machine code of a loop while it is written, the jumps
+ * to its end and its variables.
+ * @param   code                Machine code written.
+ * @param   length              Length of the code.
+ * @param   capacity            Capacity of the code.
+ * @param   exits               Amount of jumps to the end of the loop.
+ * @param   exit                Positions of the jumps to the end of the loop.
+ * @param   exit_capacity       Capacity of the jumps.
+ * @param   variables           Variables of the loop.
+ * @param   variable_count      Amount of variables.
+ * @param   variable_capacity   Capacity of the variables.
+ */
+// typedef struct jit_compiler {
+//     unsigned char * code;
+//     int length;
+//     int capacity;
+//     int exits;
+//     int * exit;
+//     int exit_capacity;
+//     struct jit_variable * variables;
+//     int variable_count;
+//     int variable_capacity;
+// } jit_compiler;
+
+// Global Values.
+jit_loop * jit_loops = NULL;
+int jit_loop_count = 0;
+int jit_loop_capacity = 0;
+
+// Registers of the most used integer and float variables, the registers of
+// the integers are kept by the functions the loop calls. rax and rdx are left
+// out of the temporaries for the division, and xmm0 to xmm5 hold the float
+// temporaries.
+int jit_integers[JIT_INTEGERS] = { JIT_RBX, JIT_RBP, 14, 15 };
+int jit_floats[JIT_FLOATS] = { 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+int jit_scratch[JIT_SCRATCH] = { JIT_RCX, JIT_RSI, JIT_RDI, 8, 9, 10, 11 };
+
+/**
+ * Jit Initialize prepares the loops of a program to be compiled. The handler
+ * of every while of the main program and of the functions is swapped by one
+ * that counts its iterations, and compiles it once they reach JIT_THRESHOLD.
+ * It must be called after the optimizer and before running the program, and
+ * does nothing on machines other than x86-64.
+ * @param   node    Root of the main program.
+ * @param   table   Symbol table with the functions.
+ */
+void jit_initialize(syntax_node * node, symbol_table * table) {
+    if (!JIT_ENABLED) return;
+
+    int i;
+    for (i=0; i<table->buckets; i++)
+        if (table->items[i].symtype == SYMBOL_FUNCTION)
+            jit_statement_wrap(table->items[i].function->node);
+    jit_statement_wrap(node);
+}
+
+/**
+ * Jit Release frees the code of the loops that were compiled.
+ */
+void jit_release() {
+    int i;
+    for (i=0; i<jit_loop_count; i++)
+        if (jit_loops[i].code != NULL)
+            munmap((void *)jit_loops[i].code, jit_loops[i].size);
+    free(jit_loops);
+    jit_loops = NULL;
+    jit_loop_count = 0;
+    jit_loop_capacity = 0;
+}
+
+/**
+ * Jit Statement Wrap wraps the whiles of a list and the ones nested in them,
+ * the inner ones first.
+ * @param   node    Statement to walk.
+ */
+void jit_statement_wrap(syntax_node * node) {
+    int i;
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return;
+
+    switch (node->instruction) {
+        case SYNTAX_STMT:
+            for (i=0; i<node->count; i++)
+                jit_statement_wrap(SYNTAX_AT(node->list[i]));
+            return;
+        case SYNTAX_IF:
+        case SYNTAX_IFELSE:
+            jit_statement_wrap(SYNTAX_NODEB(node));
+            jit_statement_wrap(SYNTAX_NODEC(node));
+            return;
+        case SYNTAX_WHILE:
+            jit_statement_wrap(SYNTAX_NODEB(node));
+            break;
+        default:
+            return;
+    }
+    if (node->handler != syntax_execute_while) return;
+
+    if (jit_loop_count == jit_loop_capacity) {
+        jit_loop_capacity = jit_loop_capacity > 0 ? 2 * jit_loop_capacity : 8;
+        jit_loops = (jit_loop *)realloc(
+            jit_loops, jit_loop_capacity * sizeof(jit_loop));
+        if (jit_loops == NULL) {
+            printf("JIT: Out of memory.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    memset(&jit_loops[jit_loop_count], 0, sizeof(jit_loop));
+    profile_wrap(node, jit_execute_while, jit_loop_count ++);
+}
+
+/**
+ * Interpretation of a while that may be compiled. It runs like the original
+ * one and counts the iterations, and once they reach JIT_THRESHOLD the loop is
+ * compiled and the rest of it runs as machine code, starting with the next
+ * evaluation of the condition. Loops that failed to compile keep running in
+ * the interpreter.
+ * @param   node    Node to run.
+ */
+void jit_execute_while(syntax_node * node) {
+    jit_loop * loop = &jit_loops[node->slot];
+    syntax_node * inner = SYNTAX_NODEA(node);
+    if (loop->code != NULL) {
+        loop->code(global_table->values, global_frame);
+        return;
+    }
+
+    syntax_execute_nodetype(SYNTAX_NODEA(inner));
+    while (SYNTAX_NODEA(inner)->evaluation) {
+        syntax_execute_nodetype(SYNTAX_NODEB(inner));
+        if (global_value != NULL) return;
+        if (++ loop->count == JIT_THRESHOLD && jit_compile(loop, inner)) {
+            loop->code(global_table->values, global_frame);
+            return;
+        }
+        syntax_execute_nodetype(SYNTAX_NODEA(inner));
+    }
+}
+
+/**
+ * Jit Compile writes the machine code of a while, called with the storage and
+ * the frame of the call it runs in. Integer variables are kept in registers,
+ * float ones in xmm registers, and operations of both types are done on them
+ * directly. Statements that read, print, call or return, and the ones with
+ * mixed types, run in the interpreter: the registers are written back to
+ * memory, the statement runs, and the registers are loaded again. The code is
+ * copied to pages that are executable but not writable.
+ * @param   loop    Loop to compile.
+ * @param   node    Original node of the while.
+ * @return  Whether the loop was compiled.
+ */
+bool jit_compile(jit_loop * loop, syntax_node * node) {
+    int i;
+    jit_compiler compiler = { 0 };
+    jit_compiler * c = &compiler;
+    c->capacity = JIT_CODE_SIZE;
+    c->code = (unsigned char *)malloc(c->capacity);
+    c->variable_capacity = JIT_VARIABLES_SIZE;
+    c->variables = (jit_variable *)malloc(
+        c->variable_capacity * sizeof(jit_variable));
+    if (c->code == NULL || c->variables == NULL) {
+        printf("JIT: Out of memory.\n");
+        exit(EXIT_FAILURE);
+    }
+    jit_collect(c, node);
+    jit_assign(c);
+
+    // Keep the registers of the caller, with the stack aligned for calls, and
+    // the storage in r12 and the frame in r13.
+    static unsigned char prologue[] = {
+        0x53, 0x55, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57,
+        0x48, 0x83, 0xEC, 0x08, 0x49, 0x89, 0xFC, 0x49, 0x89, 0xF5
+    };
+    static unsigned char epilogue[] = {
+        0x48, 0x83, 0xC4, 0x08, 0x41, 0x5F, 0x41, 0x5E, 0x41, 0x5D,
+        0x41, 0x5C, 0x5D, 0x5B, 0xC3
+    };
+    for (i=0; i<(int)sizeof(prologue); i++) jit_byte(c, prologue[i]);
+    jit_reload(c);
+    jit_statement(c, node);
+    for (i=0; i<c->exits; i++) jit_patch(c, c->exit[i], c->length);
+    jit_spill(c);
+    for (i=0; i<(int)sizeof(epilogue); i++) jit_byte(c, epilogue[i]);
+
+    // Copy the code to its pages, then make them executable.
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t size = (c->length + page - 1) / page * page;
+    void * code = mmap(NULL, size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    bool success = code != MAP_FAILED;
+    if (success) {
+        memcpy(code, c->code, c->length);
+        if (mprotect(code, size, PROT_READ | PROT_EXEC) == 0) {
+            loop->code = (jit_code)code;
+            loop->size = size;
+        } else {
+            munmap(code, size);
+            success = false;
+        }
+    }
+    free(c->code);
+    free(c->exit);
+    free(c->variables);
+    return success;
+}
+
+/**
+ * Jit Collect counts the uses of the variables of a loop, including the ones
+ * of the statements that will run in the interpreter.
+ * @param   c       Compiler of the loop.
+ * @param   node    Node to walk.
+ */
+void jit_collect(jit_compiler * c, syntax_node * node) {
+    if (node == NULL) return;
+    if (node->handler == jit_execute_while) node = SYNTAX_NODEA(node);
+
+    int i;
+    jit_variable * variable = jit_variable_find(c, node);
+    if (variable != NULL) variable->uses ++;
+    jit_collect(c, SYNTAX_NODEA(node));
+    jit_collect(c, SYNTAX_NODEB(node));
+    jit_collect(c, SYNTAX_NODEC(node));
+    for (i=0; i<node->count; i++) jit_collect(c, SYNTAX_AT(node->list[i]));
+}
+
+/**
+ * Jit Assign gives the registers to the most used variables of each type.
+ * @param   c       Compiler of the loop.
+ */
+void jit_assign(jit_compiler * c) {
+    int i;
+    int j;
+    int integers = 0;
+    int floats = 0;
+    while (true) {
+        jit_variable * best = NULL;
+        for (i=0; i<c->variable_count; i++) {
+            jit_variable * variable = &c->variables[i];
+            bool available = variable->numtype == DATA_INTEGER
+                ? integers < JIT_INTEGERS
+                : variable->numtype == DATA_FLOAT && floats < JIT_FLOATS;
+            if (variable->reg == JIT_NONE && available
+                && (best == NULL || variable->uses > best->uses))
+                best = variable;
+        }
+        if (best == NULL) return;
+
+        j = best->numtype == DATA_INTEGER ? integers ++ : floats ++;
+        best->reg = best->numtype == DATA_INTEGER
+            ? jit_integers[j] : jit_floats[j];
+    }
+}
+
+/**
+ * Jit Variable Find returns the variable read by a node, adding it if it is
+ * the first time it is seen.
+ * @param   c       Compiler of the loop.
+ * @param   node    Node of an identifier or a local.
+ * @return  Variable of the node, NULL if the node does not read one.
+ */
+jit_variable * jit_variable_find(jit_compiler * c, syntax_node * node) {
+    int i;
+    char nodetype = node->nodetype;
+    if (!(nodetype == SYNTAX_IDENTIFIER
+        && node->handler == syntax_operate_identifier)
+        && !(nodetype == SYNTAX_LOCAL && node->handler == syntax_operate_local))
+        return NULL;
+
+    for (i=0; i<c->variable_count; i++)
+        if (c->variables[i].nodetype == nodetype
+            && c->variables[i].slot == node->slot)
+            return &c->variables[i];
+
+    if (c->variable_count == c->variable_capacity) {
+        c->variable_capacity *= 2;
+        c->variables = (jit_variable *)realloc(
+            c->variables, c->variable_capacity * sizeof(jit_variable));
+        if (c->variables == NULL) {
+            printf("JIT: Out of memory.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    jit_variable * variable = &c->variables[c->variable_count ++];
+    variable->nodetype = nodetype;
+    variable->numtype = nodetype == SYNTAX_IDENTIFIER
+        ? global_table->values[node->slot].numtype
+        : global_frame[node->slot].numtype;
+    variable->slot = node->slot;
+    variable->uses = 0;
+    variable->reg = JIT_NONE;
+    return variable;
+}
+
+/**
+ * Jit Statement writes a statement of a loop. Whiles, ifs and lists are
+ * compiled, assigns are compiled unless their types are mixed, and every
+ * other statement runs in the interpreter.
+ * @param   c       Compiler of the loop.
+ * @param   node    Statement to write.
+ */
+void jit_statement(jit_compiler * c, syntax_node * node) {
+    int i;
+    int count;
+    int jumps[2];
+    if (node == NULL) return;
+    if (node->handler == jit_execute_while) node = SYNTAX_NODEA(node);
+    syntax_handler handler = node->handler;
+
+    if (handler == syntax_execute_stmt) {
+        for (i=0; i<node->count; i++)
+            jit_statement(c, SYNTAX_AT(node->list[i]));
+    } else if (handler == syntax_execute_while
+        && node->nodea != SYNTAX_NONE && node->nodeb != SYNTAX_NONE) {
+        int top = c->length;
+        jit_condition(c, SYNTAX_NODEA(node), jumps, &count);
+        jit_statement(c, SYNTAX_NODEB(node));
+        jit_patch(c, jit_jump(c, 0xE9), top);
+        for (i=0; i<count; i++) jit_patch(c, jumps[i], c->length);
+    } else if (handler == syntax_execute_if
+        && node->nodea != SYNTAX_NONE && node->nodeb != SYNTAX_NONE) {
+        jit_condition(c, SYNTAX_NODEA(node), jumps, &count);
+        jit_statement(c, SYNTAX_NODEB(node));
+        for (i=0; i<count; i++) jit_patch(c, jumps[i], c->length);
+    } else if (handler == syntax_execute_ifelse && node->nodea != SYNTAX_NONE
+        && node->nodeb != SYNTAX_NONE && node->nodec != SYNTAX_NONE) {
+        jit_condition(c, SYNTAX_NODEA(node), jumps, &count);
+        jit_statement(c, SYNTAX_NODEB(node));
+        int end = jit_jump(c, 0xE9);
+        for (i=0; i<count; i++) jit_patch(c, jumps[i], c->length);
+        jit_statement(c, SYNTAX_NODEC(node));
+        jit_patch(c, end, c->length);
+    } else if (!((handler == syntax_execute_assign
+        || handler == syntax_execute_assign_local)
+        && jit_assignment(c, node)))
+        jit_interpret(c, node);
+}
+
+/**
+ * Jit Assignment writes an assign whose value has the type of its variable,
+ * the only ones that leave the type in memory as it was.
+ * @param   c       Compiler of the loop.
+ * @param   node    Assign to write.
+ * @return  Whether it was written, nothing is written otherwise.
+ */
+bool jit_assignment(jit_compiler * c, syntax_node * node) {
+    syntax_node * value = SYNTAX_NODEB(node);
+    if (node->nodea == SYNTAX_NONE || value == NULL) return false;
+    jit_variable * variable = jit_variable_find(c, SYNTAX_NODEA(node));
+    jit_variable * source = jit_variable_find(c, value);
+    if (variable == NULL) return false;
+
+    char numtype = source != NULL ? source->numtype : value->value.numtype;
+    if (source == NULL && value->nodetype != SYNTAX_VALUE
+        && jit_kernel_type(value) != numtype)
+        return false;
+    if (numtype != variable->numtype) return false;
+
+    int length = c->length;
+    if (numtype == DATA_INTEGER && jit_integer(c, value, 0)) {
+        if (variable->reg != JIT_NONE)
+            jit_register(c, 0, 0x8B, variable->reg, jit_scratch[0]);
+        else jit_memory(c, 0, 0x89, jit_scratch[0], variable);
+        return true;
+    }
+    if (numtype == DATA_FLOAT && jit_float(c, value, 0)) {
+        if (variable->reg != JIT_NONE)
+            jit_register(c, 0, 0x0F28, variable->reg, 0);
+        else jit_memory(c, 0xF3, 0x0F11, 0, variable);
+        return true;
+    }
+    c->length = length;
+    return false;
+}
+
+/**
+ * Jit Interpret writes a statement that runs in the interpreter. The variables
+ * are in memory while it runs, and the loop ends if it returned.
+ * @param   c       Compiler of the loop.
+ * @param   node    Statement to run.
+ */
+void jit_interpret(jit_compiler * c, syntax_node * node) {
+    jit_spill(c);
+    jit_call(c, jit_run, node);
+    jit_reload(c);
+
+    // test al, al then jne to the end of the loop.
+    jit_byte(c, 0x84);
+    jit_byte(c, 0xC0);
+    if (c->exits == c->exit_capacity) {
+        c->exit_capacity = c->exit_capacity > 0 ? 2 * c->exit_capacity : 8;
+        c->exit = (int *)realloc(c->exit, c->exit_capacity * sizeof(int));
+        if (c->exit == NULL) {
+            printf("JIT: Out of memory.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    c->exit[c->exits ++] = jit_jump(c, 0x0F80 | JIT_JNE);
+}
+
+/**
+ * Jit Condition writes a condition that jumps when it is false. Conditions
+ * that can not be compiled run in the interpreter.
+ * @param   c       Compiler of the loop.
+ * @param   node    Expression of the condition.
+ * @param   jumps   Where to store the positions of the jumps to patch.
+ * @param   count   Where to store the amount of jumps, one or two.
+ */
+void jit_condition(
+    jit_compiler * c, syntax_node * node, int * jumps, int * count
+) {
+    int length = c->length;
+    *count = 0;
+    if (jit_compare(c, node, jumps, count)) return;
+
+    c->length = length;
+    *count = 0;
+    jit_spill(c);
+    jit_call(c, jit_test, node);
+    jit_reload(c);
+    jit_byte(c, 0x84);
+    jit_byte(c, 0xC0);
+    jumps[(*count) ++] = jit_jump(c, 0x0F80 | JIT_JE);
+}
+
+/**
+ * Jit Compare writes the comparison of a condition and the jumps taken when it
+ * is false. Floats are compared like in C, so comparisons with NaN are false
+ * except for the one with zero.
+ * @param   c       Compiler of the loop.
+ * @param   node    Expression of the condition.
+ * @param   jumps   Where to store the positions of the jumps to patch.
+ * @param   count   Where to store the amount of jumps.
+ * @return  Whether it was written.
+ */
+bool jit_compare(
+    jit_compiler * c, syntax_node * node, int * jumps, int * count
+) {
+    syntax_handler handler = node->handler;
+    char numtype = jit_kernel_type(node);
+    int r = jit_scratch[0];
+    int condition;
+
+    if (numtype == DATA_INTEGER) {
+        if (!jit_integer(c, SYNTAX_NODEA(node), 0)) return false;
+        if (handler == syntax_evaluate_zeroi) {
+            jit_register(c, 0, 0x85, r, r);
+            jumps[(*count) ++] = jit_jump(c, 0x0F80 | JIT_JE);
+            return true;
+        }
+        if (handler == syntax_evaluate_lessi) condition = JIT_JGE;
+        else if (handler == syntax_evaluate_greateri) condition = JIT_JLE;
+        else if (handler == syntax_evaluate_equalsi) condition = JIT_JNE;
+        else if (handler == syntax_evaluate_ltei) condition = JIT_JG;
+        else if (handler == syntax_evaluate_gtei) condition = JIT_JL;
+        else return false;
+        if (!jit_integer_operand(c, SYNTAX_NODEB(node), 0, 0x3B, 7))
+            return false;
+        jumps[(*count) ++] = jit_jump(c, 0x0F80 | condition);
+        return true;
+    }
+    if (numtype != DATA_FLOAT || !jit_float(c, SYNTAX_NODEA(node), 0))
+        return false;
+
+    if (handler == syntax_evaluate_zerof) {
+        // xorps xmm1, xmm1 then ucomiss xmm0, xmm1, NaN is not zero.
+        jit_register(c, 0, 0x0F57, 1, 1);
+        jit_register(c, 0, 0x0F2E, 0, 1);
+        jit_byte(c, 0x7A);
+        jit_byte(c, 0x06);
+        jumps[(*count) ++] = jit_jump(c, 0x0F80 | JIT_JE);
+        return true;
+    }
+    if (!jit_float(c, SYNTAX_NODEB(node), 1)) return false;
+
+    // The unordered result sets the carry, so jb and jbe take NaN as false.
+    if (handler == syntax_evaluate_lessf || handler == syntax_evaluate_ltef)
+        jit_register(c, 0, 0x0F2E, 1, 0);
+    else jit_register(c, 0, 0x0F2E, 0, 1);
+    if (handler == syntax_evaluate_lessf
+        || handler == syntax_evaluate_greaterf)
+        condition = JIT_JBE;
+    else if (handler == syntax_evaluate_ltef
+        || handler == syntax_evaluate_gtef)
+        condition = JIT_JB;
+    else if (handler == syntax_evaluate_equalsf) {
+        jumps[(*count) ++] = jit_jump(c, 0x0F80 | JIT_JP);
+        condition = JIT_JNE;
+    } else return false;
+    jumps[(*count) ++] = jit_jump(c, 0x0F80 | condition);
+    return true;
+}
+
+/**
+ * Jit Integer writes an integer expression, its value is left in the
+ * temporary of the depth. Integers wrap around and the division traps like
+ * in the kernels.
+ * @param   c       Compiler of the loop.
+ * @param   node    Node of the expression.
+ * @param   depth   Temporary of the value.
+ * @return  Whether it was written.
+ */
+bool jit_integer(jit_compiler * c, syntax_node * node, int depth) {
+    if (depth >= JIT_SCRATCH) return false;
+    int r = jit_scratch[depth];
+    jit_variable * variable = jit_variable_find(c, node);
+    syntax_handler handler = node->handler;
+
+    if (node->nodetype == SYNTAX_VALUE) {
+        jit_move_immediate(c, r, node->value.number.int_value);
+        return true;
+    }
+    if (variable != NULL) {
+        if (variable->numtype != DATA_INTEGER) return false;
+        jit_operand(c, 0, 0x8B, r, variable);
+        return true;
+    }
+    if (jit_kernel_type(node) != DATA_INTEGER
+        || !jit_integer(c, SYNTAX_NODEA(node), depth))
+        return false;
+
+    if (handler == syntax_operate_negi) {
+        jit_register(c, 0, 0xF7, 3, r);
+        return true;
+    }
+    if (handler == syntax_operate_addi)
+        return jit_integer_operand(c, SYNTAX_NODEB(node), depth, 0x03, 0);
+    if (handler == syntax_operate_subi)
+        return jit_integer_operand(c, SYNTAX_NODEB(node), depth, 0x2B, 5);
+    if (handler == syntax_operate_muli)
+        return jit_integer_operand(c, SYNTAX_NODEB(node), depth, 0x0FAF, 0);
+    if (handler != syntax_operate_divi) return false;
+
+    // mov eax, r then cdq, idiv and mov r, eax.
+    variable = jit_variable_find(c, SYNTAX_NODEB(node));
+    if (variable == NULL) {
+        if (!jit_integer(c, SYNTAX_NODEB(node), depth + 1)) return false;
+    } else if (variable->numtype != DATA_INTEGER) return false;
+    jit_register(c, 0, 0x8B, JIT_RAX, r);
+    jit_byte(c, 0x99);
+    if (variable != NULL) jit_operand(c, 0, 0xF7, 7, variable);
+    else jit_register(c, 0, 0xF7, 7, jit_scratch[depth + 1]);
+    jit_register(c, 0, 0x8B, r, JIT_RAX);
+    return true;
+}
+
+/**
+ * Jit Integer Operand writes a binary operation between the temporary of the
+ * depth and an operand, taken from its register, its memory or as an
+ * immediate when it can, and from the next temporary otherwise.
+ * @param   c           Compiler of the loop.
+ * @param   node        Node of the operand.
+ * @param   depth       Temporary of the left operand and of the result.
+ * @param   opcode      Opcode of the operation with a register or memory.
+ * @param   extension   Extension of the opcode 0x81 for an immediate.
+ * @return  Whether it was written.
+ */
+bool jit_integer_operand(
+    jit_compiler * c, syntax_node * node, int depth, int opcode, int extension
+) {
+    int r = jit_scratch[depth];
+    jit_variable * variable = jit_variable_find(c, node);
+    if (node->nodetype == SYNTAX_VALUE) {
+        if (opcode == 0x0FAF) jit_register(c, 0, 0x69, r, r);
+        else jit_register(c, 0, 0x81, extension, r);
+        jit_word(c, node->value.number.int_value);
+        return true;
+    }
+    if (variable != NULL) {
+        if (variable->numtype != DATA_INTEGER) return false;
+        jit_operand(c, 0, opcode, r, variable);
+        return true;
+    }
+    if (!jit_integer(c, node, depth + 1)) return false;
+    jit_register(c, 0, opcode, r, jit_scratch[depth + 1]);
+    return true;
+}
+
+/**
+ * Jit Float writes a float expression, its value is left in the xmm register
+ * of the depth. The operations are the scalar ones of SSE, which round like
+ * the kernels.
+ * @param   c       Compiler of the loop.
+ * @param   node    Node of the expression.
+ * @param   depth   xmm register of the value.
+ * @return  Whether it was written.
+ */
+bool jit_float(jit_compiler * c, syntax_node * node, int depth) {
+    if (depth >= JIT_SCRATCHF) return false;
+    jit_variable * variable = jit_variable_find(c, node);
+    syntax_handler handler = node->handler;
+    int opcode;
+
+    if (node->nodetype == SYNTAX_VALUE) {
+        // mov eax, bits then movd xmm, eax.
+        jit_move_immediate(c, JIT_RAX, node->value.number.int_value);
+        jit_register(c, 0x66, 0x0F6E, depth, JIT_RAX);
+        return true;
+    }
+    if (variable != NULL) {
+        if (variable->numtype != DATA_FLOAT) return false;
+        if (variable->reg != JIT_NONE)
+            jit_register(c, 0, 0x0F28, depth, variable->reg);
+        else jit_memory(c, 0xF3, 0x0F10, depth, variable);
+        return true;
+    }
+    if (jit_kernel_type(node) != DATA_FLOAT
+        || !jit_float(c, SYNTAX_NODEA(node), depth))
+        return false;
+
+    if (handler == syntax_operate_negf) {
+        // movd eax, xmm then xor eax, sign and movd xmm, eax.
+        jit_register(c, 0x66, 0x0F7E, depth, JIT_RAX);
+        jit_byte(c, 0x35);
+        jit_word(c, (int)0x80000000u);
+        jit_register(c, 0x66, 0x0F6E, depth, JIT_RAX);
+        return true;
+    }
+    if (handler == syntax_operate_addf) opcode = 0x0F58;
+    else if (handler == syntax_operate_mulf) opcode = 0x0F59;
+    else if (handler == syntax_operate_subf) opcode = 0x0F5C;
+    else if (handler == syntax_operate_divf) opcode = 0x0F5E;
+    else return false;
+
+    variable = jit_variable_find(c, SYNTAX_NODEB(node));
+    if (variable != NULL) {
+        if (variable->numtype != DATA_FLOAT) return false;
+        jit_operand(c, 0xF3, opcode, depth, variable);
+        return true;
+    }
+    if (!jit_float(c, SYNTAX_NODEB(node), depth + 1)) return false;
+    jit_register(c, 0xF3, opcode, depth, depth + 1);
+    return true;
+}
+
+/**
+ * Jit Kernel Type returns the type of the kernel that runs a node.
+ * @param   node    Node of an operation or a comparison.
+ * @return  DATA_INTEGER, DATA_FLOAT, or SYNTAX_NULLT if it is not a kernel.
+ */
+char jit_kernel_type(syntax_node * node) {
+    syntax_handler handler = node->handler;
+    if (handler == syntax_operate_addi || handler == syntax_operate_subi
+        || handler == syntax_operate_negi || handler == syntax_operate_muli
+        || handler == syntax_operate_divi || handler == syntax_evaluate_lessi
+        || handler == syntax_evaluate_greateri
+        || handler == syntax_evaluate_equalsi
+        || handler == syntax_evaluate_ltei || handler == syntax_evaluate_gtei
+        || handler == syntax_evaluate_zeroi)
+        return DATA_INTEGER;
+    if (handler == syntax_operate_addf || handler == syntax_operate_subf
+        || handler == syntax_operate_negf || handler == syntax_operate_mulf
+        || handler == syntax_operate_divf || handler == syntax_evaluate_lessf
+        || handler == syntax_evaluate_greaterf
+        || handler == syntax_evaluate_equalsf
+        || handler == syntax_evaluate_ltef || handler == syntax_evaluate_gtef
+        || handler == syntax_evaluate_zerof)
+        return DATA_FLOAT;
+    return SYNTAX_NULLT;
+}
+
+/**
+ * Jit Spill writes the variables in registers to memory.
+ * @param   c       Compiler of the loop.
+ */
+void jit_spill(jit_compiler * c) {
+    int i;
+    for (i=0; i<c->variable_count; i++) {
+        jit_variable * variable = &c->variables[i];
+        if (variable->reg == JIT_NONE) continue;
+        if (variable->numtype == DATA_INTEGER)
+            jit_memory(c, 0, 0x89, variable->reg, variable);
+        else jit_memory(c, 0xF3, 0x0F11, variable->reg, variable);
+    }
+}
+
+/**
+ * Jit Reload loads the variables in registers from memory.
+ * @param   c       Compiler of the loop.
+ */
+void jit_reload(jit_compiler * c) {
+    int i;
+    for (i=0; i<c->variable_count; i++) {
+        jit_variable * variable = &c->variables[i];
+        if (variable->reg == JIT_NONE) continue;
+        if (variable->numtype == DATA_INTEGER)
+            jit_memory(c, 0, 0x8B, variable->reg, variable);
+        else jit_memory(c, 0xF3, 0x0F10, variable->reg, variable);
+    }
+}
+
+/**
+ * Jit Byte appends a byte to the code.
+ * @param   c       Compiler of the loop.
+ * @param   byte    Byte to append.
+ */
+void jit_byte(jit_compiler * c, int byte) {
+    if (c->length == c->capacity) {
+        c->capacity *= 2;
+        c->code = (unsigned char *)realloc(c->code, c->capacity);
+        if (c->code == NULL) {
+            printf("JIT: Out of memory.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    c->code[c->length ++] = (unsigned char)byte;
+}
+
+/**
+ * Jit Word appends a 32 bit value to the code, little endian.
+ * @param   c       Compiler of the loop.
+ * @param   word    Value to append.
+ */
+void jit_word(jit_compiler * c, int word) {
+    int i;
+    unsigned int bits = (unsigned int)word;
+    for (i=0; i<4; i++) jit_byte(c, (bits >> (8 * i)) & 0xFF);
+}
+
+/**
+ * Jit Address appends a 64 bit value to the code, little endian.
+ * @param   c       Compiler of the loop.
+ * @param   address Value to append.
+ */
+void jit_address(jit_compiler * c, long address) {
+    int i;
+    unsigned long bits = (unsigned long)address;
+    for (i=0; i<8; i++) jit_byte(c, (bits >> (8 * i)) & 0xFF);
+}
+
+/**
+ * Jit Register appends an instruction between two registers, of 32 bits for
+ * the general purpose ones.
+ * @param   c       Compiler of the loop.
+ * @param   prefix  Mandatory prefix of the instruction, 0 if it has none.
+ * @param   opcode  Opcode, of two bytes if it is above 0xFF.
+ * @param   reg     Register of the reg field, or extension of the opcode.
+ * @param   rm      Register of the rm field.
+ */
+void jit_register(jit_compiler * c, int prefix, int opcode, int reg, int rm) {
+    int rex = 0x40 | (reg & 8 ? 4 : 0) | (rm & 8 ? 1 : 0);
+    if (prefix != 0) jit_byte(c, prefix);
+    if (rex != 0x40) jit_byte(c, rex);
+    if (opcode > 0xFF) jit_byte(c, opcode >> 8);
+    jit_byte(c, opcode & 0xFF);
+    jit_byte(c, 0xC0 | (reg & 7) << 3 | (rm & 7));
+}
+
+/**
+ * Jit Memory appends an instruction between a register and the value of a
+ * variable in memory, from r12 for the storage and from r13 for the frame.
+ * @param   c           Compiler of the loop.
+ * @param   prefix      Mandatory prefix of the instruction, 0 if it has none.
+ * @param   opcode      Opcode, of two bytes if it is above 0xFF.
+ * @param   reg         Register of the reg field, or extension of the opcode.
+ * @param   variable    Variable in memory.
+ */
+void jit_memory(
+    jit_compiler * c, int prefix, int opcode, int reg, jit_variable * variable
+) {
+    int base = variable->nodetype == SYNTAX_IDENTIFIER ? JIT_R12 : JIT_R13;
+    if (prefix != 0) jit_byte(c, prefix);
+    jit_byte(c, 0x41 | (reg & 8 ? 4 : 0));
+    if (opcode > 0xFF) jit_byte(c, opcode >> 8);
+    jit_byte(c, opcode & 0xFF);
+    jit_byte(c, 0x80 | (reg & 7) << 3 | (base & 7));
+    if ((base & 7) == JIT_RSP) jit_byte(c, 0x24);
+    jit_word(c, variable->slot * (int)sizeof(data_value)
+        + (int)offsetof(data_value, number));
+}
+
+/**
+ * Jit Operand appends an instruction between a register and a variable,
+ * wherever the variable is kept.
+ * @param   c           Compiler of the loop.
+ * @param   prefix      Mandatory prefix of the instruction, 0 if it has none.
+ * @param   opcode      Opcode, of two bytes if it is above 0xFF.
+ * @param   reg         Register of the reg field, or extension of the opcode.
+ * @param   variable    Variable of the rm field.
+ */
+void jit_operand(
+    jit_compiler * c, int prefix, int opcode, int reg, jit_variable * variable
+) {
+    if (variable->reg != JIT_NONE)
+        jit_register(c, prefix, opcode, reg, variable->reg);
+    else jit_memory(c, prefix, opcode, reg, variable);
+}
+
+/**
+ * Jit Move Immediate appends the move of a 32 bit value to a register.
+ * @param   c       Compiler of the loop.
+ * @param   reg     Register to write.
+ * @param   value   Value to write.
+ */
+void jit_move_immediate(jit_compiler * c, int reg, int value) {
+    if (reg & 8) jit_byte(c, 0x41);
+    jit_byte(c, 0xB8 | (reg & 7));
+    jit_word(c, value);
+}
+
+/**
+ * Jit Jump appends a jump with a displacement of 32 bits to patch later.
+ * @param   c       Compiler of the loop.
+ * @param   opcode  0xE9 for jmp, 0x0F80 and a condition for jcc.
+ * @return  Position of the displacement.
+ */
+int jit_jump(jit_compiler * c, int opcode) {
+    if (opcode > 0xFF) jit_byte(c, opcode >> 8);
+    jit_byte(c, opcode & 0xFF);
+    jit_word(c, 0);
+    return c->length - 4;
+}
+
+/**
+ * Jit Patch points a jump to a position of the code.
+ * @param   c       Compiler of the loop.
+ * @param   at      Position of the displacement of the jump.
+ * @param   target  Position the jump goes to.
+ */
+void jit_patch(jit_compiler * c, int at, int target) {
+    int i;
+    unsigned int bits = (unsigned int)(target - (at + 4));
+    for (i=0; i<4; i++) c->code[at + i] = (bits >> (8 * i)) & 0xFF;
+}
+
+/**
+ * Jit Call appends a call to a function of the interpreter with a node, its
+ * result is left in al.
+ * @param   c       Compiler of the loop.
+ * @param   helper  Function to call.
+ * @param   node    Node given to it.
+ */
+void jit_call(jit_compiler * c, jit_helper helper, syntax_node * node) {
+    // mov rdi, node then mov rax, helper and call rax.
+    jit_byte(c, 0x48);
+    jit_byte(c, 0xBF);
+    jit_address(c, (long)node);
+    jit_byte(c, 0x48);
+    jit_byte(c, 0xB8);
+    jit_address(c, (long)helper);
+    jit_byte(c, 0xFF);
+    jit_byte(c, 0xD0);
+}
+
+/**
+ * Jit Run runs a statement of a compiled loop in the interpreter.
+ * @param   node    Statement to run.
+ * @return  Whether it returned.
+ */
+bool jit_run(syntax_node * node) {
+    syntax_execute_nodetype(node);
+    return global_value != NULL;
+}
+
+/**
+ * Jit Test runs a condition of a compiled loop in the interpreter.
+ * @param   node    Expression of the condition.
+ * @return  Its evaluation.
+ */
+bool jit_test(syntax_node * node) {
+    syntax_execute_nodetype(node);
+    return node->evaluation;
+}
@@ -0,0 +1,115 @@
+#ifndef _JITH_
+#define _JITH_
+
+// Imports
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "data.h"
+#include "profile.h"
+#include "symbol_table.h"
+#include "syntax_tree.h"
+
+// Definitions
+#if defined(__x86_64__) && !defined(JIT_DISABLE)
+#define JIT_ENABLED         true
+#else
+#define JIT_ENABLED         false
+#endif
+#define JIT_THRESHOLD       1000
+#define JIT_CODE_SIZE       4096
+#define JIT_VARIABLES_SIZE  16
+#define JIT_INTEGERS        4
+#define JIT_FLOATS          10
+#define JIT_SCRATCH         7
+#define JIT_SCRATCHF        6
+#define JIT_NONE            -1
+
+// Registers of x86-64, the xmm ones are numbered on their own.
+#define JIT_RAX             0
+#define JIT_RCX             1
+#define JIT_RDX             2
+#define JIT_RBX             3
+#define JIT_RSP             4
+#define JIT_RBP             5
+#define JIT_RSI             6
+#define JIT_RDI             7
+#define JIT_R12             12
+#define JIT_R13             13
+
+// Condition codes of jcc, added to 0x0F80.
+#define JIT_JB              0x2
+#define JIT_JAE             0x3
+#define JIT_JE              0x4
+#define JIT_JNE             0x5
+#define JIT_JBE             0x6
+#define JIT_JP              0xA
+#define JIT_JL              0xC
+#define JIT_JGE             0xD
+#define JIT_JLE             0xE
+#define JIT_JG              0xF
+
+// Declarations
+typedef void (*jit_code)(data_value *, data_value *);
+typedef bool (*jit_helper)(syntax_node *);
+typedef struct jit_loop {
+    long count;
+    jit_code code;
+    size_t size;
+} jit_loop;
+typedef struct jit_variable {
+    char nodetype;
+    char numtype;
+    int slot;
+    int uses;
+    int reg;
+} jit_variable;
+typedef struct jit_compiler {
+    unsigned char * code;
+    int length;
+    int capacity;
+    int exits;
+    int * exit;
+    int exit_capacity;
+    struct jit_variable * variables;
+    int variable_count;
+    int variable_capacity;
+} jit_compiler;
+
+void jit_initialize(syntax_node *, symbol_table *);
+void jit_release();
+void jit_statement_wrap(syntax_node *);
+void jit_execute_while(syntax_node *);
+bool jit_compile(jit_loop *, syntax_node *);
+void jit_collect(jit_compiler *, syntax_node *);
+void jit_assign(jit_compiler *);
+jit_variable * jit_variable_find(jit_compiler *, syntax_node *);
+void jit_statement(jit_compiler *, syntax_node *);
+bool jit_assignment(jit_compiler *, syntax_node *);
+void jit_interpret(jit_compiler *, syntax_node *);
+void jit_condition(jit_compiler *, syntax_node *, int *, int *);
+bool jit_compare(jit_compiler *, syntax_node *, int *, int *);
+bool jit_integer(jit_compiler *, syntax_node *, int);
+bool jit_integer_operand(jit_compiler *, syntax_node *, int, int, int);
+bool jit_float(jit_compiler *, syntax_node *, int);
+char jit_kernel_type(syntax_node *);
+void jit_spill(jit_compiler *);
+void jit_reload(jit_compiler *);
+void jit_byte(jit_compiler *, int);
+void jit_word(jit_compiler *, int);
+void jit_address(jit_compiler *, long);
+void jit_register(jit_compiler *, int, int, int, int);
+void jit_memory(jit_compiler *, int, int, int, jit_variable *);
+void jit_operand(jit_compiler *, int, int, int, jit_variable *);
+void jit_move_immediate(jit_compiler *, int, int);
+int jit_jump(jit_compiler *, int);
+void jit_patch(jit_compiler *, int, int);
+void jit_call(jit_compiler *, jit_helper, syntax_node *);
+bool jit_run(syntax_node *);
+bool jit_test(syntax_node *);
+
+#endif
@@ -0,0 +1,1401 @@
+#include "optimize.h"
+
+/**
+ * Optimize Stats counts what the optimizer did to a program.
+ * @param   before      Nodes of the program before the passes.
+ * @param   after       Nodes of the program after the passes.
+ * @param   folded      Operations replaced by their value.
+ * @param   identities  Operations replaced by one of their operands.
+ * @param   propagated  Identifiers replaced by the constant they hold.
+ * @param   pruned      Branches and loops removed because they never run.
+ * @param   hoisted     Operations moved out of a loop.
+ * @param   inlined     Calls replaced by a copy of the body.
+ * @param   pure        Functions whose result only depends on the arguments.
+ * @param   memoized    Pure functions whose calls keep their results.
+ * @param   hits        Calls answered by the memo, counted while running.
+ * @param   misses      Calls of memoized functions that had to run.
+ */
+// typedef struct optimize_stats {
+//     int before;
+//     int after;
+//     int folded;
+//     int identities;
+//     int propagated;
+//     int pruned;
+//     int hoisted;
+//     int inlined;
+//     int pure;
+//     int memoized;
+//     long hits;
+//     long misses;
+// } optimize_stats;
+
+/**
+ * Optimize Fact is what is known about a variable at a point of the program.
+ * @param   known   Whether the variable holds a known constant.
+ * @param   value   Constant held by the variable.
+ */
+// typedef struct optimize_fact {
+//     bool known;
+//     data_value value;
+// } optimize_fact;
+
+/**
+ * Optimize State is the fact of every variable a body can reach, the storage
+ * slots of the symbol table first and then the frame of the function.
+ * @param   globals     Amount of storage slots, where the frame starts.
+ * @param   size        Amount of facts.
+ * @param   facts       Fact of each variable.
+ */
+// typedef struct optimize_state {
+//     int globals;
+//     int size;
+//     struct optimize_fact * facts;
+// } optimize_state;
+
+/**
+ * Optimize Program runs the passes over the main program and the body of
+ * every function, between the parsing and the execution. Propagation needs
+ * folding, so it only runs along with it.
+ * Inlining runs first, so the other passes work on the copies, and before
+ * the functions that may change the storage are found, since a copy writes
+ * the slot of its function like the call did.
+ * Hoisting adds the temporaries it needs to the storage of the table for the
+ * main program, and to the frame for functions. The functions are classified
+ * for memoization once the passes changed their bodies.
+ * @param   node    Root of the main program.
+ * @param   table   Symbol table with the functions.
+ * @param   passes  Passes to run, OPTIMIZE_FOLD, OPTIMIZE_PROPAGATE and
+ *                  OPTIMIZE_HOIST, with the budget of the inliner above
+ *                  OPTIMIZE_BUDGET_SHIFT.
+ * @param   stats   Where to count what was done.
+ * @return  Root of the main program after the passes.
+ */
+syntax_node * optimize_program(
+    syntax_node * node, symbol_table * table, int passes, optimize_stats * stats
+) {
+    int i;
+    stats->folded = 0;
+    stats->identities = 0;
+    stats->propagated = 0;
+    stats->pruned = 0;
+    stats->hoisted = 0;
+    stats->inlined = 0;
+    stats->hits = 0;
+    stats->misses = 0;
+    stats->before = optimize_count_program(node, table);
+
+    int budget = passes >> OPTIMIZE_BUDGET_SHIFT;
+    if (budget > 0) {
+        node = optimize_inline(node, table, NULL, budget, stats);
+        for (i=0; i<table->buckets; i++)
+            if (table->items[i].symtype == SYMBOL_FUNCTION)
+                table->items[i].function->node = optimize_inline(
+                    table->items[i].function->node, table,
+                    table->items[i].function, budget, stats);
+    }
+    optimize_summarize(table);
+
+    if (passes & OPTIMIZE_FOLD) {
+        node = optimize_fold(node, stats);
+        for (i=0; i<table->buckets; i++)
+            if (table->items[i].symtype == SYMBOL_FUNCTION)
+                table->items[i].function->node =
+                    optimize_fold(table->items[i].function->node, stats);
+    }
+
+    if ((passes & OPTIMIZE_FOLD) && (passes & OPTIMIZE_PROPAGATE)) {
+        // The main program starts with the declared values of the storage.
+        optimize_state * state = optimize_state_create(table->slots, 0);
+        for (i=0; i<table->slots; i++) {
+            state->facts[i].known = true;
+            state->facts[i].value = table->values[i];
+        }
+        node = optimize_propagate_body(node, state, stats);
+        optimize_state_release(state);
+
+        // A function can be called at any point, so it knows nothing of the
+        // storage, but its locals start at zero.
+        for (i=0; i<table->buckets; i++) {
+            if (table->items[i].symtype != SYMBOL_FUNCTION) continue;
+            symbol_function * function = table->items[i].function;
+            state = optimize_state_create(table->slots, function->size);
+            param_list * local;
+            for (local = function->locals; local != NULL; local = local->next) {
+                state->facts[table->slots + local->offset].known = true;
+                state->facts[table->slots + local->offset].value = local->value;
+            }
+            function->node = optimize_propagate_body(
+                function->node, state, stats);
+            optimize_state_release(state);
+        }
+    }
+
+    if (passes & OPTIMIZE_HOIST) {
+        node = optimize_hoist(node, table, NULL, stats);
+        for (i=0; i<table->buckets; i++)
+            if (table->items[i].symtype == SYMBOL_FUNCTION)
+                table->items[i].function->node = optimize_hoist(
+                    table->items[i].function->node, table,
+                    table->items[i].function, stats);
+    }
+
+    optimize_classify(table, stats);
+    stats->after = optimize_count_program(node, table);
+    return node;
+}
+
+/**
+ * Optimize Count returns the amount of nodes of a tree.
+ * @param   node    Root of the tree.
+ * @return  Amount of nodes.
+ */
+int optimize_count(syntax_node * node) {
+    int i;
+    if (node == NULL) return 0;
+    int count = 1 + optimize_count(SYNTAX_NODEA(node))
+        + optimize_count(SYNTAX_NODEB(node))
+        + optimize_count(SYNTAX_NODEC(node));
+    for (i=0; i<node->count; i++)
+        count += optimize_count(SYNTAX_AT(node->list[i]));
+    return count;
+}
+
+/**
+ * Optimize Count Program returns the amount of nodes of the main program and
+ * the bodies of the functions.
+ * @param   node    Root of the main program.
+ * @param   table   Symbol table with the functions.
+ * @return  Amount of nodes.
+ */
+int optimize_count_program(syntax_node * node, symbol_table * table) {
+    int i;
+    int count = optimize_count(node);
+    for (i=0; i<table->buckets; i++)
+        if (table->items[i].symtype == SYMBOL_FUNCTION)
+            count += optimize_count(table->items[i].function->node);
+    return count;
+}
+
+/**
+ * Optimize Fold folds the children of a node first, so that constants reach
+ * the top of each operation, and then the node itself.
+ * @param   node    Node to fold.
+ * @param   stats   Where to count what was done.
+ * @return  Node that takes the place of this one.
+ */
+syntax_node * optimize_fold(syntax_node * node, optimize_stats * stats) {
+    int i;
+    if (node == NULL) return NULL;
+
+    node->nodea = syntax_locate(optimize_fold(SYNTAX_NODEA(node), stats));
+    node->nodeb = syntax_locate(optimize_fold(SYNTAX_NODEB(node), stats));
+    node->nodec = syntax_locate(optimize_fold(SYNTAX_NODEC(node), stats));
+    for (i=0; i<node->count; i++)
+        node->list[i] = syntax_locate(
+            optimize_fold(SYNTAX_AT(node->list[i]), stats));
+
+    if (node->nodetype != SYNTAX_INSTRUCTION) return node;
+    if (node->instruction != SYNTAX_EXPRESSION
+        && node->instruction != SYNTAX_EXPR
+        && node->instruction != SYNTAX_TERM) return node;
+    return optimize_fold_operation(node, stats);
+}
+
+/**
+ * Optimize Fold Operation replaces an EXPR or TERM whose operands are values
+ * by a value, and one that is an identity, x+0 0+x x-0 x*1 1*x x/1 or ~~x,
+ * by its other operand. The sums with zero are only taken on integers, since
+ * -0.0 + 0.0 gives 0.0. Integer divisions by zero and the one overflow of
+ * division are left for the execution. An EXPRESSION whose operands are
+ * values becomes a ZERO test of 1 or 0, since if and while need an
+ * EXPRESSION.
+ * @param   node    Node to fold, its children already folded.
+ * @param   stats   Where to count what was done.
+ * @return  Node that takes the place of this one.
+ */
+syntax_node * optimize_fold_operation(
+    syntax_node * node, optimize_stats * stats
+) {
+    syntax_node * nodea = SYNTAX_NODEA(node);
+    syntax_node * nodeb = SYNTAX_NODEB(node);
+    bool integer = nodea->value.numtype == DATA_INTEGER;
+
+    // Operations with one operand.
+    if (node->operation == DATA_NEGATIVE) {
+        if (optimize_is_constant(nodea)) {
+            optimize_make_value(node, data_negative(nodea->value));
+            stats->folded ++;
+        } else if (nodea->nodetype == SYNTAX_INSTRUCTION
+            && nodea->instruction == SYNTAX_EXPR
+            && nodea->operation == DATA_NEGATIVE) {
+            stats->identities ++;
+            return SYNTAX_NODEA(nodea);
+        }
+        return node;
+    } else if (node->operation == DATA_ZERO) return node;
+
+    // Operations with two values.
+    if (optimize_is_constant(nodea) && optimize_is_constant(nodeb)) {
+        if (node->instruction == SYNTAX_EXPRESSION) {
+            bool evaluation = data_evaluation(
+                nodea->value, nodeb->value, node->operation);
+            optimize_make_value(nodea, data_create_integer(evaluation));
+            node->operation = DATA_ZERO;
+            node->nodeb = SYNTAX_NONE;
+            node->handler = syntax_resolve_kernel(
+                SYNTAX_EXPRESSION, DATA_ZERO, DATA_INTEGER);
+            stats->folded ++;
+            return node;
+        }
+
+        int dividend = nodea->value.number.int_value;
+        int divisor = nodeb->value.number.int_value;
+        if (integer && node->operation == DATA_DIVIDE
+            && (divisor == 0 || (dividend == INT_MIN && divisor == -1)))
+            return node;
+        optimize_make_value(node,
+            data_operation(nodea->value, nodeb->value, node->operation));
+        stats->folded ++;
+        return node;
+    }
+
+    // Identities.
+    syntax_node * operand = NULL;
+    switch (node->operation) {
+        case DATA_SUM:
+            if (integer && optimize_is_number(nodeb, 0)) operand = nodea;
+            else if (integer && optimize_is_number(nodea, 0)) operand = nodeb;
+            break;
+        case DATA_SUBSTRACT:
+            if (optimize_is_number(nodeb, 0)) operand = nodea;
+            break;
+        case DATA_MULTIPLY:
+            if (optimize_is_number(nodeb, 1)) operand = nodea;
+            else if (optimize_is_number(nodea, 1)) operand = nodeb;
+            break;
+        case DATA_DIVIDE:
+            if (optimize_is_number(nodeb, 1)) operand = nodea;
+            break;
+    }
+    if (operand == NULL) return node;
+    stats->identities ++;
+    return operand;
+}
+
+/**
+ * Optimize Is Constant tells if a node is a value.
+ * @param   node    Node to check.
+ * @return  True if it is a value.
+ */
+bool optimize_is_constant(syntax_node * node) {
+    return node != NULL && node->nodetype == SYNTAX_VALUE;
+}
+
+/**
+ * Optimize Is Number tells if a node is a value equal to a whole number,
+ * compared in the type of the value.
+ * @param   node    Node to check.
+ * @param   number  Number to compare with.
+ * @return  True if it is that number.
+ */
+bool optimize_is_number(syntax_node * node, int number) {
+    if (!optimize_is_constant(node)) return false;
+    if (node->value.numtype == DATA_INTEGER)
+        return node->value.number.int_value == number;
+    return node->value.number.float_value == (float)number;
+}
+
+/**
+ * Optimize Make Value turns a node into a value in place, so the node that
+ * points to it does not change.
+ * @param   node    Node to turn.
+ * @param   value   Value of the node.
+ */
+void optimize_make_value(syntax_node * node, data_value value) {
+    node->nodetype = SYNTAX_VALUE;
+    node->operation = SYNTAX_NULLT;
+    node->instruction = SYNTAX_NULLT;
+    node->identifier = SYNTAX_NULLV;
+    node->value = value;
+    node->nodea = SYNTAX_NONE;
+    node->nodeb = SYNTAX_NONE;
+    node->nodec = SYNTAX_NONE;
+    node->handler = syntax_resolve_handler(SYNTAX_VALUE, SYNTAX_NULLT);
+}
+
+/**
+ * Optimize State Create returns a state where nothing is known.
+ * @param   globals     Amount of storage slots.
+ * @param   locals      Size of the frame.
+ * @return  State created.
+ */
+optimize_state * optimize_state_create(int globals, int locals) {
+    optimize_state * state;
+    state = (optimize_state *)malloc(sizeof(optimize_state));
+    state->globals = globals;
+    state->size = globals + locals;
+    state->facts = (optimize_fact *)calloc(
+        state->size + 1, sizeof(optimize_fact));
+    return state;
+}
+
+/**
+ * Optimize State Copy returns a copy of a state, for a branch to change.
+ * @param   state   State to copy.
+ * @return  State created.
+ */
+optimize_state * optimize_state_copy(optimize_state * state) {
+    optimize_state * copy;
+    copy = optimize_state_create(state->globals, state->size - state->globals);
+    memcpy(copy->facts, state->facts, state->size * sizeof(optimize_fact));
+    return copy;
+}
+
+/**
+ * Optimize State Meet keeps in state only the facts that also hold in other,
+ * which is what is known after either of two branches ran.
+ * @param   state   State to update.
+ * @param   other   State of the other branch.
+ */
+void optimize_state_meet(optimize_state * state, optimize_state * other) {
+    int i;
+    for (i=0; i<state->size; i++) {
+        optimize_fact * one = &state->facts[i];
+        optimize_fact * two = &other->facts[i];
+        if (!one->known) continue;
+        one->known = two->known
+            && one->value.numtype == two->value.numtype
+            && one->value.number.int_value == two->value.number.int_value;
+    }
+}
+
+/**
+ * Optimize State Forget forgets the facts of the storage, because a call may
+ * have changed it, or of everything.
+ * @param   state   State to update.
+ * @param   all     Whether to forget the frame too.
+ */
+void optimize_state_forget(optimize_state * state, bool all) {
+    int i;
+    int size = all ? state->size : state->globals;
+    for (i=0; i<size; i++) state->facts[i].known = false;
+}
+
+/**
+ * Optimize State Release frees a state.
+ * @param   state   State to free.
+ */
+void optimize_state_release(optimize_state * state) {
+    free(state->facts);
+    free(state);
+}
+
+/**
+ * Optimize State Fact returns the fact of the variable a node reads or
+ * writes. Anything that is not a variable gets a spare fact past the end,
+ * which is never known.
+ * @param   state   State to look in.
+ * @param   node    IDENTIFIER or LOCAL node.
+ * @return  Fact of the variable.
+ */
+optimize_fact * optimize_state_fact(optimize_state * state, syntax_node * node) {
+    int index = state->size;
+    if (node->nodetype == SYNTAX_IDENTIFIER) index = node->slot;
+    else if (node->nodetype == SYNTAX_LOCAL) index = state->globals + node->slot;
+    if (index < 0 || index > state->size) index = state->size;
+    state->facts[state->size].known = false;
+    return &state->facts[index];
+}
+
+/**
+ * Optimize Propagate walks the statements in the order they run, replacing
+ * the variables that hold a known constant by it, and removing the branches
+ * and loops whose condition is known to be false, or the test of those known
+ * to be true. The state holds what is known before the statement, and is
+ * updated to what is known after it.
+ * @param   node    Statement to walk.
+ * @param   state   What is known before the statement.
+ * @param   stats   Where to count what was done.
+ * @return  Statement that takes the place of this one, NULL if none.
+ */
+syntax_node * optimize_propagate(
+    syntax_node * node, optimize_state * state, optimize_stats * stats
+) {
+    int i, count;
+    bool truth;
+    data_value entry;
+    optimize_state * copy;
+    optimize_fact * fact;
+
+    if (node == NULL) return NULL;
+    if (node->nodetype != SYNTAX_INSTRUCTION) return node;
+
+    switch (node->instruction) {
+        case SYNTAX_STMT:
+            // Statements that are removed are left out of the list.
+            for (i=0, count=0; i<node->count; i++) {
+                syntax_node * stmt = optimize_propagate(
+                    SYNTAX_AT(node->list[i]), state, stats);
+                if (stmt != NULL) node->list[count++] = syntax_locate(stmt);
+            }
+            node->count = count;
+            return count == 0 ? NULL : node;
+        case SYNTAX_ASSIGN:
+            node->nodeb = syntax_locate(optimize_propagate_expression(
+                SYNTAX_NODEB(node), state, stats));
+            fact = optimize_state_fact(state, SYNTAX_NODEA(node));
+            fact->known = optimize_is_constant(SYNTAX_NODEB(node));
+            fact->value = SYNTAX_NODEB(node)->value;
+            return node;
+        case SYNTAX_READ:
+            optimize_state_fact(state, SYNTAX_NODEA(node))->known = false;
+            return node;
+        case SYNTAX_PRINT:
+        case SYNTAX_RETURN:
+            node->nodea = syntax_locate(optimize_propagate_expression(
+                SYNTAX_NODEA(node), state, stats));
+            return node;
+        case SYNTAX_IF:
+            node->nodea = syntax_locate(optimize_propagate_expression(
+                SYNTAX_NODEA(node), state, stats));
+            if (optimize_is_condition(SYNTAX_NODEA(node), &truth)) {
+                stats->pruned ++;
+                return truth
+                    ? optimize_propagate(SYNTAX_NODEB(node), state, stats)
+                    : NULL;
+            }
+            copy = optimize_state_copy(state);
+            node->nodeb = syntax_locate(optimize_propagate_body(
+                SYNTAX_NODEB(node), copy, stats));
+            optimize_state_meet(state, copy);
+            optimize_state_release(copy);
+            return node;
+        case SYNTAX_IFELSE:
+            node->nodea = syntax_locate(optimize_propagate_expression(
+                SYNTAX_NODEA(node), state, stats));
+            if (optimize_is_condition(SYNTAX_NODEA(node), &truth)) {
+                stats->pruned ++;
+                return optimize_propagate(truth
+                    ? SYNTAX_NODEB(node) : SYNTAX_NODEC(node), state, stats);
+            }
+            copy = optimize_state_copy(state);
+            node->nodeb = syntax_locate(optimize_propagate_body(
+                SYNTAX_NODEB(node), state, stats));
+            node->nodec = syntax_locate(optimize_propagate_body(
+                SYNTAX_NODEC(node), copy, stats));
+            optimize_state_meet(state, copy);
+            optimize_state_release(copy);
+            return node;
+        case SYNTAX_WHILE:
+            // A loop whose condition is false on entry never runs.
+            if (optimize_evaluate(SYNTAX_NODEA(node), state, &entry)
+                && data_zero(entry)) {
+                stats->pruned ++;
+                return NULL;
+            }
+
+            // Otherwise what the loop changes is not known at any iteration.
+            optimize_kill(node, state);
+            node->nodea = syntax_locate(optimize_propagate_expression(
+                SYNTAX_NODEA(node), state, stats));
+            copy = optimize_state_copy(state);
+            node->nodeb = syntax_locate(optimize_propagate_body(
+                SYNTAX_NODEB(node), copy, stats));
+            optimize_state_release(copy);
+            return node;
+        default:
+            return node;
+    }
+}
+
+/**
+ * Optimize Propagate Body propagates into the body of a branch or a loop,
+ * which can not be left empty.
+ * @param   node    Body to walk.
+ * @param   state   What is known before the body.
+ * @param   stats   Where to count what was done.
+ * @return  Body that takes the place of this one.
+ */
+syntax_node * optimize_propagate_body(
+    syntax_node * node, optimize_state * state, optimize_stats * stats
+) {
+    node = optimize_propagate(node, state, stats);
+    if (node == NULL) node = syntax_initialize();
+    return node;
+}
+
+/**
+ * Optimize Propagate Expression replaces the known variables of an
+ * expression and folds it again.
+ * @param   node    Expression to walk.
+ * @param   state   What is known before the expression.
+ * @param   stats   Where to count what was done.
+ * @return  Expression that takes the place of this one.
+ */
+syntax_node * optimize_propagate_expression(
+    syntax_node * node, optimize_state * state, optimize_stats * stats
+) {
+    optimize_substitute(node, state, stats);
+    return optimize_fold(node, stats);
+}
+
+/**
+ * Optimize Substitute replaces, in the order they are read, the variables
+ * that hold a known constant by a value. A call may change the storage, so
+ * the storage read after one that may change it is not replaced.
+ * @param   node    Expression to walk.
+ * @param   state   What is known, updated after calls.
+ * @param   stats   Where to count what was done.
+ */
+void optimize_substitute(
+    syntax_node * node, optimize_state * state, optimize_stats * stats
+) {
+    if (node == NULL) return;
+    if (node->nodetype == SYNTAX_IDENTIFIER || node->nodetype == SYNTAX_LOCAL) {
+        optimize_fact * fact = optimize_state_fact(state, node);
+        if (!fact->known) return;
+        optimize_make_value(node, fact->value);
+        stats->propagated ++;
+        return;
+    } else if (node->nodetype != SYNTAX_INSTRUCTION) return;
+
+    optimize_substitute(SYNTAX_NODEA(node), state, stats);
+    optimize_substitute(SYNTAX_NODEB(node), state, stats);
+    if (node->instruction == SYNTAX_FUNCTION && node->function->writes)
+        optimize_state_forget(state, false);
+}
+
+/**
+ * Optimize Kill forgets every variable a statement may change, the ones it
+ * assigns or reads, and the storage if it calls a function that may change
+ * it.
+ * @param   node    Statement to walk.
+ * @param   state   State to update.
+ */
+void optimize_kill(syntax_node * node, optimize_state * state) {
+    int i;
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return;
+
+    switch (node->instruction) {
+        case SYNTAX_STMT:
+            for (i=0; i<node->count; i++)
+                optimize_kill(SYNTAX_AT(node->list[i]), state);
+            break;
+        case SYNTAX_ASSIGN:
+            optimize_state_fact(state, SYNTAX_NODEA(node))->known = false;
+            if (optimize_may_write(SYNTAX_NODEB(node)))
+                optimize_state_forget(state, false);
+            break;
+        case SYNTAX_READ:
+            optimize_state_fact(state, SYNTAX_NODEA(node))->known = false;
+            break;
+        case SYNTAX_IF:
+        case SYNTAX_IFELSE:
+        case SYNTAX_WHILE:
+            if (optimize_may_write(SYNTAX_NODEA(node)))
+                optimize_state_forget(state, false);
+            optimize_kill(SYNTAX_NODEB(node), state);
+            optimize_kill(SYNTAX_NODEC(node), state);
+            break;
+        default:
+            // PRINT and RETURN.
+            if (optimize_may_write(SYNTAX_NODEA(node)))
+                optimize_state_forget(state, false);
+            break;
+    }
+}
+
+/**
+ * Optimize May Write tells if an expression calls a function that may change
+ * the storage.
+ * @param   node    Expression to check.
+ * @return  True if there is such a call.
+ */
+bool optimize_may_write(syntax_node * node) {
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return false;
+    if (node->instruction == SYNTAX_FUNCTION && node->function->writes)
+        return true;
+    return optimize_may_write(SYNTAX_NODEA(node))
+        || optimize_may_write(SYNTAX_NODEB(node));
+}
+
+/**
+ * Optimize Summarize finds the functions that may change the storage, the
+ * ones that assign or read into a variable of it or call one that may. It
+ * starts with none and repeats until nothing changes, so that recursive
+ * functions are covered. Calls to the other ones only change their own frame.
+ * @param   table   Symbol table with the functions.
+ */
+void optimize_summarize(symbol_table * table) {
+    int i, j;
+    bool changed = true;
+    for (i=0; i<table->buckets; i++)
+        if (table->items[i].symtype == SYMBOL_FUNCTION)
+            table->items[i].function->writes = false;
+
+    while (changed) {
+        changed = false;
+        for (i=0; i<table->buckets; i++) {
+            if (table->items[i].symtype != SYMBOL_FUNCTION) continue;
+            symbol_function * function = table->items[i].function;
+            if (function->writes) continue;
+
+            // What the body forgets of a known storage is what it may change.
+            optimize_state * state = optimize_state_create(table->slots, 0);
+            for (j=0; j<table->slots; j++) state->facts[j].known = true;
+            optimize_kill(function->node, state);
+            for (j=0; j<table->slots; j++)
+                if (!state->facts[j].known) function->writes = true;
+            optimize_state_release(state);
+            if (function->writes) changed = true;
+        }
+    }
+}
+
+/**
+ * Optimize Classify finds the pure functions, the ones that neither read nor
+ * print, do not touch the storage and only call pure functions. It starts
+ * with all of them and repeats until nothing changes, so that recursive
+ * functions are covered. A call also stores its result in the slot of its
+ * function, which the symbol table shows, so only the pure functions that
+ * call nobody but themselves are memoized, since a result taken from the
+ * memo skips the calls inside.
+ * @param   table   Symbol table with the functions.
+ * @param   stats   Where to count the pure and memoized functions.
+ */
+void optimize_classify(symbol_table * table, optimize_stats * stats) {
+    int i;
+    bool alone;
+    bool changed = true;
+    for (i=0; i<table->buckets; i++)
+        if (table->items[i].symtype == SYMBOL_FUNCTION)
+            table->items[i].function->pure = true;
+
+    while (changed) {
+        changed = false;
+        for (i=0; i<table->buckets; i++) {
+            if (table->items[i].symtype != SYMBOL_FUNCTION) continue;
+            symbol_function * function = table->items[i].function;
+            if (!function->pure) continue;
+            if (optimize_is_pure(function->node, function, &alone)) continue;
+            function->pure = false;
+            changed = true;
+        }
+    }
+
+    stats->pure = 0;
+    stats->memoized = 0;
+    for (i=0; i<table->buckets; i++) {
+        if (table->items[i].symtype != SYMBOL_FUNCTION) continue;
+        symbol_function * function = table->items[i].function;
+        alone = true;
+        function->memoize = function->pure
+            && optimize_is_pure(function->node, function, &alone) && alone
+            && function->args <= SYNTAX_MEMO_ARGS;
+        if (function->pure) stats->pure ++;
+        if (function->memoize) stats->memoized ++;
+    }
+}
+
+/**
+ * Optimize Is Pure tells if a body only depends on its frame, with the pure
+ * flags known so far.
+ * @param   node        Body to check.
+ * @param   function    Function of the body.
+ * @param   alone       Set to false if it calls another function.
+ * @return  True if the body is pure.
+ */
+bool optimize_is_pure(
+    syntax_node * node, symbol_function * function, bool * alone
+) {
+    int i;
+    if (node == NULL) return true;
+    if (node->nodetype == SYNTAX_IDENTIFIER) return false;
+    if (node->nodetype != SYNTAX_INSTRUCTION) return true;
+
+    if (node->instruction == SYNTAX_READ || node->instruction == SYNTAX_PRINT)
+        return false;
+    if (node->instruction == SYNTAX_FUNCTION) {
+        if (!node->function->pure) return false;
+        if (node->function != function) *alone = false;
+    }
+    for (i=0; i<node->count; i++)
+        if (!optimize_is_pure(SYNTAX_AT(node->list[i]), function, alone))
+            return false;
+    return optimize_is_pure(SYNTAX_NODEA(node), function, alone)
+        && optimize_is_pure(SYNTAX_NODEB(node), function, alone)
+        && optimize_is_pure(SYNTAX_NODEC(node), function, alone);
+}
+
+/**
+ * Optimize Evaluate computes the value of an expression from what is known,
+ * without changing it. A condition gives the integer 1 or 0.
+ * @param   node    Expression to compute.
+ * @param   state   What is known.
+ * @param   value   Where to store the value.
+ * @return  True if the value is known.
+ */
+bool optimize_evaluate(
+    syntax_node * node, optimize_state * state, data_value * value
+) {
+    data_value one, two;
+    if (node == NULL) return false;
+    if (node->nodetype == SYNTAX_VALUE) {
+        *value = node->value;
+        return true;
+    } else if (node->nodetype == SYNTAX_IDENTIFIER
+        || node->nodetype == SYNTAX_LOCAL) {
+        optimize_fact * fact = optimize_state_fact(state, node);
+        *value = fact->value;
+        return fact->known;
+    } else if (node->nodetype != SYNTAX_INSTRUCTION) return false;
+
+    switch (node->instruction) {
+        case SYNTAX_EXPRESSION:
+            if (!optimize_evaluate(SYNTAX_NODEA(node), state, &one))
+                return false;
+            if (node->operation == DATA_ZERO) {
+                *value = data_create_integer(!data_zero(one));
+                return true;
+            }
+            if (!optimize_evaluate(SYNTAX_NODEB(node), state, &two))
+                return false;
+            *value = data_create_integer(
+                data_evaluation(one, two, node->operation));
+            return true;
+        case SYNTAX_EXPR:
+        case SYNTAX_TERM:
+            if (!optimize_evaluate(SYNTAX_NODEA(node), state, &one))
+                return false;
+            if (node->operation == DATA_NEGATIVE) {
+                *value = data_negative(one);
+                return true;
+            }
+            if (!optimize_evaluate(SYNTAX_NODEB(node), state, &two))
+                return false;
+            if (one.numtype == DATA_INTEGER && node->operation == DATA_DIVIDE
+                && (two.number.int_value == 0 || (one.number.int_value == INT_MIN
+                    && two.number.int_value == -1))) return false;
+            *value = data_operation(one, two, node->operation);
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Optimize Is Condition tells if a folded EXPRESSION is known, which is a
+ * ZERO test of a value.
+ * @param   node    EXPRESSION to check.
+ * @param   truth   Where to store the result of the test.
+ * @return  True if the result is known.
+ */
+bool optimize_is_condition(syntax_node * node, bool * truth) {
+    if (node->operation != DATA_ZERO
+        || !optimize_is_constant(SYNTAX_NODEA(node))) return false;
+    *truth = !data_zero(SYNTAX_NODEA(node)->value);
+    return true;
+}
+
+/**
+ * Optimize Hoist moves the operations of each while that read nothing the
+ * loop changes into temporaries assigned right before it, innermost loops
+ * first. A while with something to hoist is replaced by the list of those
+ * assignments followed by the while.
+ * @param   node        Statement to walk.
+ * @param   table       Symbol table, for the temporaries of the main program.
+ * @param   function    Function of the statement, NULL for the main program.
+ * @param   stats       Where to count what was done.
+ * @return  Statement that takes the place of this one.
+ */
+syntax_node * optimize_hoist(
+    syntax_node * node,
+    symbol_table * table,
+    symbol_function * function,
+    optimize_stats * stats
+) {
+    int i;
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return node;
+
+    switch (node->instruction) {
+        case SYNTAX_STMT:
+            for (i=0; i<node->count; i++)
+                node->list[i] = syntax_locate(optimize_hoist(
+                    SYNTAX_AT(node->list[i]), table, function, stats));
+            return node;
+        case SYNTAX_IF:
+        case SYNTAX_IFELSE:
+            // Only statements can hold a while.
+            node->nodeb = syntax_locate(optimize_hoist(
+                SYNTAX_NODEB(node), table, function, stats));
+            node->nodec = syntax_locate(optimize_hoist(
+                SYNTAX_NODEC(node), table, function, stats));
+            return node;
+        case SYNTAX_WHILE:
+            break;
+        default:
+            return node;
+    }
+    node->nodeb = syntax_locate(optimize_hoist(
+        SYNTAX_NODEB(node), table, function, stats));
+
+    // What is still known after forgetting what the loop changes is what the
+    // loop does not change.
+    optimize_state * state = optimize_state_create(
+        table->slots, function == NULL ? 0 : function->size);
+    for (i=0; i<state->size; i++) state->facts[i].known = true;
+    optimize_kill(node, state);
+
+    syntax_node * list = NULL;
+    node->nodea = syntax_locate(optimize_hoist_expression(
+        SYNTAX_NODEA(node), state, table, function, &list, stats));
+    node->nodeb = syntax_locate(optimize_hoist_expression(
+        SYNTAX_NODEB(node), state, table, function, &list, stats));
+    optimize_state_release(state);
+
+    if (list == NULL) return node;
+    return syntax_append_stmt(list, node);
+}
+
+/**
+ * Optimize Hoist Expression replaces the largest invariant operations under a
+ * node by a read of a new temporary, and appends the assignment of each
+ * temporary to the list that runs before the loop. Assignment and read
+ * targets are identifiers, so they are never replaced.
+ * @param   node        Node to walk.
+ * @param   state       Variables the loop does not change.
+ * @param   table       Symbol table, for the temporaries of the main program.
+ * @param   function    Function of the loop, NULL for the main program.
+ * @param   list        List of assignments, created by the first one.
+ * @param   stats       Where to count what was done.
+ * @return  Node that takes the place of this one.
+ */
+syntax_node * optimize_hoist_expression(
+    syntax_node * node,
+    optimize_state * state,
+    symbol_table * table,
+    symbol_function * function,
+    syntax_node ** list,
+    optimize_stats * stats
+) {
+    int i;
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return node;
+
+    if ((node->instruction == SYNTAX_EXPR || node->instruction == SYNTAX_TERM)
+        && optimize_is_invariant(node, state)) {
+        data_value value = SYNTAX_NULLD;
+        value.numtype = node->value.numtype;
+        int slot = function == NULL
+            ? symbol_slot_create(table, value) : function->size ++;
+        syntax_node * target = optimize_temporary(function, slot, value);
+        SYNTAX_LINE(target) = SYNTAX_LINE(node);
+        syntax_node * assign = syntax_create_assign(target, node, NULL);
+        if (*list == NULL) *list = syntax_create_stmt(assign);
+        else syntax_append_stmt(*list, assign);
+        stats->hoisted ++;
+        syntax_node * temporary = optimize_temporary(function, slot, value);
+        SYNTAX_LINE(temporary) = SYNTAX_LINE(node);
+        return temporary;
+    }
+
+    for (i=0; i<node->count; i++)
+        node->list[i] = syntax_locate(optimize_hoist_expression(
+            SYNTAX_AT(node->list[i]), state, table, function, list, stats));
+    node->nodea = syntax_locate(optimize_hoist_expression(
+        SYNTAX_NODEA(node), state, table, function, list, stats));
+    node->nodeb = syntax_locate(optimize_hoist_expression(
+        SYNTAX_NODEB(node), state, table, function, list, stats));
+    node->nodec = syntax_locate(optimize_hoist_expression(
+        SYNTAX_NODEC(node), state, table, function, list, stats));
+    return node;
+}
+
+/**
+ * Optimize Is Invariant tells if an expression gives the same value at every
+ * iteration and can be computed before the loop, even if the loop would not
+ * have computed it. Calls may change things and integer divisions may stop
+ * the program, so only divisions by a constant other than 0 and -1 are.
+ * @param   node    Expression to check.
+ * @param   state   Variables the loop does not change.
+ * @return  True if it is invariant.
+ */
+bool optimize_is_invariant(syntax_node * node, optimize_state * state) {
+    if (node == NULL) return true;
+    if (node->nodetype == SYNTAX_VALUE) return true;
+    if (node->nodetype == SYNTAX_IDENTIFIER || node->nodetype == SYNTAX_LOCAL)
+        return optimize_state_fact(state, node)->known;
+    if (node->nodetype != SYNTAX_INSTRUCTION) return false;
+    if (node->instruction != SYNTAX_EXPR && node->instruction != SYNTAX_TERM)
+        return false;
+
+    if (node->operation == DATA_DIVIDE
+        && SYNTAX_NODEA(node)->value.numtype == DATA_INTEGER
+        && (!optimize_is_constant(SYNTAX_NODEB(node))
+            || optimize_is_number(SYNTAX_NODEB(node), 0)
+            || optimize_is_number(SYNTAX_NODEB(node), -1))) return false;
+    return optimize_is_invariant(SYNTAX_NODEA(node), state)
+        && optimize_is_invariant(SYNTAX_NODEB(node), state);
+}
+
+/**
+ * Optimize Temporary returns a node bound to a temporary, a storage slot in
+ * the main program or a frame offset in a function.
+ * @param   function    Function of the temporary, NULL for the main program.
+ * @param   slot        Slot or offset of the temporary.
+ * @param   value       Value with the type of the temporary.
+ * @return  Node created.
+ */
+syntax_node * optimize_temporary(
+    symbol_function * function, int slot, data_value value
+) {
+    if (function == NULL)
+        return syntax_create_identifier(SYNTAX_NULLV, slot, value);
+    return syntax_create_local(SYNTAX_NULLV, slot, value);
+}
+
+/**
+ * Optimize Inline replaces the calls of the statements under a node by a copy
+ * of the body of the function they call, which runs right before the
+ * statement. Moving the call ahead of the rest of the statement is only
+ * safe when nothing else in it can tell, so a statement is only changed if
+ * every call in it can be inlined and no argument calls anything. The
+ * condition of a while runs at every iteration, so it is left alone.
+ * @param   node        Statement to walk.
+ * @param   table       Symbol table, for the temporaries of the main program.
+ * @param   function    Function of the statement, NULL for the main program.
+ * @param   budget      Most nodes of a body that is inlined.
+ * @param   stats       Where to count what was done.
+ * @return  Node that takes the place of this one.
+ */
+syntax_node * optimize_inline(
+    syntax_node * node,
+    symbol_table * table,
+    symbol_function * function,
+    int budget,
+    optimize_stats * stats
+) {
+    int i;
+    syntax_node * list = NULL;
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return node;
+
+    switch (node->instruction) {
+        case SYNTAX_STMT:
+            for (i=0; i<node->count; i++)
+                node->list[i] = syntax_locate(optimize_inline(
+                    SYNTAX_AT(node->list[i]), table, function, budget, stats));
+            return node;
+        case SYNTAX_WHILE:
+            node->nodeb = syntax_locate(optimize_inline(
+                SYNTAX_NODEB(node), table, function, budget, stats));
+            return node;
+        case SYNTAX_IF:
+        case SYNTAX_IFELSE:
+            node->nodeb = syntax_locate(optimize_inline(
+                SYNTAX_NODEB(node), table, function, budget, stats));
+            node->nodec = syntax_locate(optimize_inline(
+                SYNTAX_NODEC(node), table, function, budget, stats));
+            if (optimize_can_inline(SYNTAX_NODEA(node), budget))
+                node->nodea = syntax_locate(optimize_inline_expression(
+                    SYNTAX_NODEA(node), table, function, &list,
+                    SYNTAX_LINE(node),
+                    optimize_count_calls(SYNTAX_NODEA(node)) > 1, stats));
+            break;
+        case SYNTAX_ASSIGN:
+            if (optimize_can_inline(SYNTAX_NODEB(node), budget))
+                node->nodeb = syntax_locate(optimize_inline_expression(
+                    SYNTAX_NODEB(node), table, function, &list,
+                    SYNTAX_LINE(node),
+                    optimize_count_calls(SYNTAX_NODEB(node)) > 1, stats));
+            break;
+        case SYNTAX_PRINT:
+        case SYNTAX_RETURN:
+            if (optimize_can_inline(SYNTAX_NODEA(node), budget))
+                node->nodea = syntax_locate(optimize_inline_expression(
+                    SYNTAX_NODEA(node), table, function, &list,
+                    SYNTAX_LINE(node),
+                    optimize_count_calls(SYNTAX_NODEA(node)) > 1, stats));
+            break;
+        default:
+            return node;
+    }
+
+    if (list == NULL) return node;
+    return syntax_append_stmt(list, node);
+}
+
+/**
+ * Optimize Can Inline tells if every call of an expression can be inlined,
+ * with arguments that call nothing.
+ * @param   node    Expression to check.
+ * @param   budget  Most nodes of a body that is inlined.
+ * @return  True if the calls can be inlined.
+ */
+bool optimize_can_inline(syntax_node * node, int budget) {
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return true;
+    if (node->instruction == SYNTAX_FUNCTION)
+        return optimize_is_inlinable(node->function, budget)
+            && !optimize_has_call(SYNTAX_NODEA(node));
+    return optimize_can_inline(SYNTAX_NODEA(node), budget)
+        && optimize_can_inline(SYNTAX_NODEB(node), budget)
+        && optimize_can_inline(SYNTAX_NODEC(node), budget);
+}
+
+/**
+ * Optimize Is Inlinable tells if a function is small enough and its body
+ * only changes its own frame, with a return only as its last statement. Such
+ * a body calls nothing, so it is never recursive.
+ * @param   function    Function to check.
+ * @param   budget      Most nodes of a body that is inlined.
+ * @return  True if its calls can be inlined.
+ */
+bool optimize_is_inlinable(symbol_function * function, int budget) {
+    int i;
+    syntax_node * node = function->node;
+    if (!optimize_is_small(node, &budget)) return false;
+    if (node == NULL) return true;
+    if (node->nodetype == SYNTAX_INSTRUCTION
+        && node->instruction == SYNTAX_RETURN)
+        return optimize_is_quiet(SYNTAX_NODEA(node));
+    if (node->nodetype != SYNTAX_INSTRUCTION
+        || node->instruction != SYNTAX_STMT)
+        return optimize_is_quiet(node);
+
+    for (i=0; i<node->count; i++) {
+        syntax_node * statement = SYNTAX_AT(node->list[i]);
+        if (i == node->count - 1
+            && statement->nodetype == SYNTAX_INSTRUCTION
+            && statement->instruction == SYNTAX_RETURN)
+            statement = SYNTAX_NODEA(statement);
+        if (!optimize_is_quiet(statement)) return false;
+    }
+    return true;
+}
+
+/**
+ * Optimize Is Quiet tells if a node neither reads, prints, calls nor
+ * returns, and only assigns to its frame.
+ * @param   node    Node to check.
+ * @return  True if it is quiet.
+ */
+bool optimize_is_quiet(syntax_node * node) {
+    int i;
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return true;
+
+    switch (node->instruction) {
+        case SYNTAX_READ:
+        case SYNTAX_PRINT:
+        case SYNTAX_FUNCTION:
+        case SYNTAX_RETURN:
+            return false;
+        case SYNTAX_ASSIGN:
+            if (SYNTAX_NODEA(node)->nodetype != SYNTAX_LOCAL) return false;
+            break;
+        default:
+            break;
+    }
+    for (i=0; i<node->count; i++)
+        if (!optimize_is_quiet(SYNTAX_AT(node->list[i]))) return false;
+    return optimize_is_quiet(SYNTAX_NODEA(node))
+        && optimize_is_quiet(SYNTAX_NODEB(node))
+        && optimize_is_quiet(SYNTAX_NODEC(node));
+}
+
+/**
+ * Optimize Is Small tells if a tree has at most the nodes left in the
+ * budget, and stops counting once it is spent.
+ * @param   node    Root of the tree.
+ * @param   budget  Nodes left, decreased by the ones of the tree.
+ * @return  True if the tree fits.
+ */
+bool optimize_is_small(syntax_node * node, int * budget) {
+    int i;
+    if (node == NULL) return true;
+    if (-- *budget < 0) return false;
+    for (i=0; i<node->count; i++)
+        if (!optimize_is_small(SYNTAX_AT(node->list[i]), budget))
+            return false;
+    return optimize_is_small(SYNTAX_NODEA(node), budget)
+        && optimize_is_small(SYNTAX_NODEB(node), budget)
+        && optimize_is_small(SYNTAX_NODEC(node), budget);
+}
+
+/**
+ * Optimize Is Assigned tells if a body assigns to an offset of its frame.
+ * @param   node    Body to check.
+ * @param   offset  Offset of the frame.
+ * @return  True if it is assigned.
+ */
+bool optimize_is_assigned(syntax_node * node, int offset) {
+    int i;
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return false;
+    if (node->instruction == SYNTAX_ASSIGN
+        && SYNTAX_NODEA(node)->nodetype == SYNTAX_LOCAL
+        && SYNTAX_NODEA(node)->slot == offset) return true;
+    for (i=0; i<node->count; i++)
+        if (optimize_is_assigned(SYNTAX_AT(node->list[i]), offset))
+            return true;
+    return optimize_is_assigned(SYNTAX_NODEB(node), offset)
+        || optimize_is_assigned(SYNTAX_NODEC(node), offset);
+}
+
+/**
+ * Optimize Has Call tells if an expression calls a function.
+ * @param   node    Expression to check.
+ * @return  True if there is a call.
+ */
+bool optimize_has_call(syntax_node * node) {
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return false;
+    if (node->instruction == SYNTAX_FUNCTION) return true;
+    return optimize_has_call(SYNTAX_NODEA(node))
+        || optimize_has_call(SYNTAX_NODEB(node));
+}
+
+/**
+ * Optimize Count Calls returns the amount of calls of an expression.
+ * @param   node    Expression to check.
+ * @return  Amount of calls.
+ */
+int optimize_count_calls(syntax_node * node) {
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return 0;
+    return (node->instruction == SYNTAX_FUNCTION)
+        + optimize_count_calls(SYNTAX_NODEA(node))
+        + optimize_count_calls(SYNTAX_NODEB(node));
+}
+
+/**
+ * Optimize Inline Expression inlines the calls of an expression in the order
+ * they run, appending their bodies to the list that runs before the
+ * statement.
+ * @param   node        Expression to walk, its calls can be inlined.
+ * @param   table       Symbol table, for the temporaries of the main program.
+ * @param   function    Function of the statement, NULL for the main program.
+ * @param   list        List of statements, created by the first one.
+ * @param   line        Line of the statement.
+ * @param   shared      Whether the statement has more than one call.
+ * @param   stats       Where to count what was done.
+ * @return  Node that takes the place of this one.
+ */
+syntax_node * optimize_inline_expression(
+    syntax_node * node,
+    symbol_table * table,
+    symbol_function * function,
+    syntax_node ** list,
+    int line,
+    bool shared,
+    optimize_stats * stats
+) {
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return node;
+    if (node->instruction == SYNTAX_FUNCTION) {
+        stats->inlined ++;
+        return optimize_inline_call(node, table, function, list, line, shared);
+    }
+
+    node->nodea = syntax_locate(optimize_inline_expression(
+        SYNTAX_NODEA(node), table, function, list, line, shared, stats));
+    node->nodeb = syntax_locate(optimize_inline_expression(
+        SYNTAX_NODEB(node), table, function, list, line, shared, stats));
+    return node;
+}
+
+/**
+ * Optimize Inline Call appends the copy of the body of a call to the list.
+ * The parameters and locals are renamed apart into temporaries of the
+ * caller, the parameters starting with their argument and the locals with
+ * zero, but an argument that is a value or a variable takes the place of a
+ * parameter that is never assigned, since nothing in the copy can change it.
+ * The return becomes an assignment to the slot of the function, which is
+ * where a call leaves its result, and that slot is read instead of the call.
+ * Another call of the statement may change the slot first, so with more than
+ * one the result is kept in a temporary as well.
+ * @param   node        Call to inline.
+ * @param   table       Symbol table, for the temporaries of the main program.
+ * @param   function    Function of the statement, NULL for the main program.
+ * @param   list        List of statements, created by the first one.
+ * @param   line        Line of the statement.
+ * @param   shared      Whether the statement has more than one call.
+ * @return  Node that takes the place of the call.
+ */
+syntax_node * optimize_inline_call(
+    syntax_node * node,
+    symbol_table * table,
+    symbol_function * function,
+    syntax_node ** list,
+    int line,
+    bool shared
+) {
+    int i;
+    param_list * param;
+    symbol_function * callee = node->function;
+    syntax_node * body = callee->node;
+    syntax_node ** frame = (syntax_node **)calloc(
+        callee->size + 1, sizeof(syntax_node *));
+    if (*list == NULL) *list = syntax_create_stmt(NULL);
+
+    // Bind the arguments in order, then the locals.
+    syntax_node * arg = SYNTAX_NODEA(node);
+    for (param = callee->list; param != NULL; param = param->next) {
+        syntax_node * value = SYNTAX_NODEA(arg);
+        arg = SYNTAX_NODEB(arg);
+        if (value->nodetype != SYNTAX_INSTRUCTION
+            && !optimize_is_assigned(body, param->offset)) {
+            frame[param->offset] = value;
+            continue;
+        }
+        frame[param->offset] = optimize_inline_temporary(
+            table, function, param->value, line);
+        syntax_node * assign = syntax_create_assign(
+            optimize_clone(frame[param->offset], line), value, NULL);
+        SYNTAX_LINE(assign) = line;
+        syntax_append_stmt(*list, assign);
+    }
+    for (param = callee->locals; param != NULL; param = param->next) {
+        frame[param->offset] = optimize_inline_temporary(
+            table, function, param->value, line);
+        syntax_node * zero = syntax_create_value(
+            SYNTAX_VALUE, SYNTAX_NULLV, param->value);
+        SYNTAX_LINE(zero) = line;
+        syntax_node * assign = syntax_create_assign(
+            optimize_clone(frame[param->offset], line), zero, NULL);
+        SYNTAX_LINE(assign) = line;
+        syntax_append_stmt(*list, assign);
+    }
+
+    // Copy the statements, the last one may be the return.
+    syntax_node * result = NULL;
+    int count = 1;
+    syntax_node ** statements = &body;
+    if (body != NULL && body->nodetype == SYNTAX_INSTRUCTION
+        && body->instruction == SYNTAX_STMT) {
+        count = body->count;
+        statements = (syntax_node **)calloc(count, sizeof(syntax_node *));
+        for (i=0; i<count; i++) statements[i] = SYNTAX_AT(body->list[i]);
+    }
+    for (i=0; i<count; i++) {
+        syntax_node * statement = statements[i];
+        if (statement != NULL && statement->nodetype == SYNTAX_INSTRUCTION
+            && statement->instruction == SYNTAX_RETURN)
+            result = optimize_copy(SYNTAX_NODEA(statement), frame, line);
+        else syntax_append_stmt(*list, optimize_copy(statement, frame, line));
+    }
+    if (statements != &body) free(statements);
+    free(frame);
+    if (result == NULL) {
+        result = syntax_create_value(
+            SYNTAX_VALUE, SYNTAX_NULLV, callee->value);
+        SYNTAX_LINE(result) = line;
+    }
+
+    // The call leaves its result in the slot of the function.
+    syntax_node * slot = syntax_create_identifier(
+        node->identifier, node->slot, callee->value);
+    SYNTAX_LINE(slot) = line;
+    syntax_node * assign = syntax_create_assign(slot, result, NULL);
+    SYNTAX_LINE(assign) = line;
+    syntax_append_stmt(*list, assign);
+    if (!shared) return optimize_clone(slot, line);
+
+    syntax_node * temporary = optimize_inline_temporary(
+        table, function, callee->value, line);
+    assign = syntax_create_assign(
+        optimize_clone(temporary, line), optimize_clone(slot, line), NULL);
+    SYNTAX_LINE(assign) = line;
+    syntax_append_stmt(*list, assign);
+    return temporary;
+}
+
+/**
+ * Optimize Inline Temporary takes a new temporary of the caller and returns
+ * a node bound to it.
+ * @param   table       Symbol table, for the temporaries of the main program.
+ * @param   function    Function of the temporary, NULL for the main program.
+ * @param   value       Value with the type of the temporary.
+ * @param   line        Line of the node.
+ * @return  Node created.
+ */
+syntax_node * optimize_inline_temporary(
+    symbol_table * table, symbol_function * function, data_value value,
+    int line
+) {
+    int slot = function == NULL
+        ? symbol_slot_create(table, value) : function->size ++;
+    syntax_node * temporary = optimize_temporary(function, slot, value);
+    SYNTAX_LINE(temporary) = line;
+    return temporary;
+}
+
+/**
+ * Optimize Copy returns a copy of a quiet tree, with each parameter and local
+ * replaced by a copy of the node of its offset in the frame.
+ * @param   node    Tree to copy.
+ * @param   frame   Node of each offset of the frame.
+ * @param   line    Line of the nodes.
+ * @return  Copy of the tree.
+ */
+syntax_node * optimize_copy(
+    syntax_node * node, syntax_node ** frame, int line
+) {
+    int i;
+    if (node == NULL) return NULL;
+    if (node->nodetype == SYNTAX_LOCAL)
+        return optimize_clone(frame[node->slot], line);
+
+    // An assignment to a temporary of the main program is not to the frame.
+    if (node->nodetype == SYNTAX_INSTRUCTION
+        && node->instruction == SYNTAX_ASSIGN) {
+        syntax_node * assign = syntax_create_assign(
+            optimize_copy(SYNTAX_NODEA(node), frame, line),
+            optimize_copy(SYNTAX_NODEB(node), frame, line), NULL);
+        SYNTAX_LINE(assign) = line;
+        return assign;
+    }
+    if (node->nodetype == SYNTAX_INSTRUCTION
+        && node->instruction == SYNTAX_STMT) {
+        syntax_node * list = syntax_create_stmt(NULL);
+        for (i=0; i<node->count; i++)
+            syntax_append_stmt(list,
+                optimize_copy(SYNTAX_AT(node->list[i]), frame, line));
+        SYNTAX_LINE(list) = line;
+        return list;
+    }
+
+    syntax_node * copy = optimize_clone(node, line);
+    copy->nodea = syntax_locate(optimize_copy(SYNTAX_NODEA(node), frame, line));
+    copy->nodeb = syntax_locate(optimize_copy(SYNTAX_NODEB(node), frame, line));
+    copy->nodec = syntax_locate(optimize_copy(SYNTAX_NODEC(node), frame, line));
+    return copy;
+}
+
+/**
+ * Optimize Clone returns a new node with the fields of another one.
+ * @param   node    Node to clone.
+ * @param   line    Line of the new node.
+ * @return  Node created.
+ */
+syntax_node * optimize_clone(syntax_node * node, int line) {
+    syntax_node * clone = syntax_allocate(1);
+    *clone = *node;
+    SYNTAX_LINE(clone) = line;
+    return clone;
+}
+
+/**
+ * Optimize Print prints what the optimizer did.
+ * @param   stats   Counts to print.
+ */
+void optimize_print(optimize_stats * stats) {
+    printf("\n");
+    printf("Optimization Statistics:\n");
+    printf("%12s%12s%12s%12s%12s%12s%12s%12s", "before", "after", "folded",
+        "identities", "propagated", "pruned", "hoisted", "inlined");
+    printf("\n\n");
+    printf("%12d%12d%12d%12d%12d%12d%12d%12d", stats->before, stats->after,
+        stats->folded, stats->identities, stats->propagated, stats->pruned,
+        stats->hoisted, stats->inlined);
+    printf("\n\n");
+    printf("%12s%12s%12s%12s", "pure", "memoized", "hits", "misses");
+    printf("\n\n");
+    printf("%12d%12d%12ld%12ld", stats->pure, stats->memoized, stats->hits,
+        stats->misses);
+    printf("\n");
+}
@@ -0,0 +1,107 @@
+#ifndef _OPTIMIZEH_
+#define _OPTIMIZEH_
+
+// Imports
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdbool.h>
+#include "data.h"
+#include "symbol_table.h"
+#include "syntax_tree.h"
+
+// Definitions
+// Passes
+#define OPTIMIZE_FOLD       1
+#define OPTIMIZE_PROPAGATE  2
+#define OPTIMIZE_HOIST      4
+#define OPTIMIZE_ALL        7
+
+// Inlining. The budget, in nodes of a body, is kept above the pass bits.
+#define OPTIMIZE_BUDGET_SHIFT   8
+#define OPTIMIZE_BUDGET         24
+#define OPTIMIZE_BUDGET_MAX     65535
+#define OPTIMIZE_DEFAULT    \
+    (OPTIMIZE_ALL | OPTIMIZE_BUDGET << OPTIMIZE_BUDGET_SHIFT)
+
+// Declarations
+typedef struct optimize_stats {
+    int before;
+    int after;
+    int folded;
+    int identities;
+    int propagated;
+    int pruned;
+    int hoisted;
+    int inlined;
+    int pure;
+    int memoized;
+    long hits;
+    long misses;
+} optimize_stats;
+typedef struct optimize_fact {
+    bool known;
+    data_value value;
+} optimize_fact;
+typedef struct optimize_state {
+    int globals;
+    int size;
+    struct optimize_fact * facts;
+} optimize_state;
+
+syntax_node * optimize_program(
+    syntax_node *, symbol_table *, int, optimize_stats *);
+int optimize_count(syntax_node *);
+int optimize_count_program(syntax_node *, symbol_table *);
+syntax_node * optimize_fold(syntax_node *, optimize_stats *);
+syntax_node * optimize_fold_operation(syntax_node *, optimize_stats *);
+bool optimize_is_constant(syntax_node *);
+bool optimize_is_number(syntax_node *, int);
+void optimize_make_value(syntax_node *, data_value);
+optimize_state * optimize_state_create(int, int);
+optimize_state * optimize_state_copy(optimize_state *);
+void optimize_state_meet(optimize_state *, optimize_state *);
+void optimize_state_forget(optimize_state *, bool);
+void optimize_state_release(optimize_state *);
+optimize_fact * optimize_state_fact(optimize_state *, syntax_node *);
+syntax_node * optimize_propagate(
+    syntax_node *, optimize_state *, optimize_stats *);
+syntax_node * optimize_propagate_body(
+    syntax_node *, optimize_state *, optimize_stats *);
+syntax_node * optimize_propagate_expression(
+    syntax_node *, optimize_state *, optimize_stats *);
+void optimize_substitute(syntax_node *, optimize_state *, optimize_stats *);
+void optimize_kill(syntax_node *, optimize_state *);
+bool optimize_may_write(syntax_node *);
+void optimize_summarize(symbol_table *);
+void optimize_classify(symbol_table *, optimize_stats *);
+bool optimize_is_pure(syntax_node *, symbol_function *, bool *);
+bool optimize_evaluate(syntax_node *, optimize_state *, data_value *);
+bool optimize_is_condition(syntax_node *, bool *);
+syntax_node * optimize_hoist(
+    syntax_node *, symbol_table *, symbol_function *, optimize_stats *);
+syntax_node * optimize_hoist_expression(syntax_node *, optimize_state *,
+    symbol_table *, symbol_function *, syntax_node **, optimize_stats *);
+bool optimize_is_invariant(syntax_node *, optimize_state *);
+syntax_node * optimize_temporary(symbol_function *, int, data_value);
+syntax_node * optimize_inline(
+    syntax_node *, symbol_table *, symbol_function *, int, optimize_stats *);
+bool optimize_can_inline(syntax_node *, int);
+bool optimize_is_inlinable(symbol_function *, int);
+bool optimize_is_quiet(syntax_node *);
+bool optimize_is_small(syntax_node *, int *);
+bool optimize_is_assigned(syntax_node *, int);
+bool optimize_has_call(syntax_node *);
+int optimize_count_calls(syntax_node *);
+syntax_node * optimize_inline_expression(syntax_node *, symbol_table *,
+    symbol_function *, syntax_node **, int, bool, optimize_stats *);
+syntax_node * optimize_inline_call(syntax_node *, symbol_table *,
+    symbol_function *, syntax_node **, int, bool);
+syntax_node * optimize_inline_temporary(
+    symbol_table *, symbol_function *, data_value, int);
+syntax_node * optimize_copy(syntax_node *, syntax_node **, int);
+syntax_node * optimize_clone(syntax_node *, int);
+void optimize_print(optimize_stats *);
+
+#endif
@@ -0,0 +1,339 @@
+#include "profile.h"
+
+/**
+ * Profile Entry is what was measured of a source line, or of a function.
+ * @param   line    Source line, or first line of the body of the function.
+ * @param   name    Name of the function, NULL for a line.
+ * @param   count   Times a statement of the line, or the function, ran.
+ * @param   active  Runs of it that have not finished, above one on recursion.
+ * @param   seconds Inclusive time of the runs in seconds.
+ */
+// typedef struct profile_entry {
+//     int line;
+//     char * name;
+//     long count;
+//     int active;
+//     double seconds;
+// } profile_entry;
+
+// Global Values.
+profile_entry * profile_lines = NULL;
+int profile_line_count = 0;
+profile_entry * profile_functions = NULL;
+int profile_function_count = 0;
+double profile_start = 0;
+double profile_total = 0;
+
+/**
+ * Profile Initialize prepares a program to be profiled. The handler of every
+ * statement and function call of the main program and of the functions is
+ * swapped by one that counts and times it, so a program that is not profiled
+ * runs exactly the same handlers as before. It must be called after the
+ * optimizer and before running the program.
+ * @param   node    Root of the main program.
+ * @param   table   Symbol table with the functions.
+ */
+void profile_initialize(syntax_node * node, symbol_table * table) {
+    int i;
+    profile_function_count = table->slots;
+    profile_functions = (profile_entry *)calloc(
+        table->slots + 1, sizeof(profile_entry));
+    if (profile_functions == NULL) {
+        printf("Profile: Out of memory.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (i=0; i<table->buckets; i++) {
+        if (table->items[i].symtype != SYMBOL_FUNCTION) continue;
+        symbol_function * function = table->items[i].function;
+        profile_entry * entry = &profile_functions[table->items[i].slot];
+        entry->name = table->items[i].identifier;
+        entry->line = SYNTAX_LINE(function->node);
+        profile_statement(function->node);
+    }
+    profile_statement(node);
+    profile_start = profile_seconds();
+}
+
+/**
+ * Profile Finish stops the clock of the whole run.
+ */
+void profile_finish() {
+    profile_total = profile_seconds() - profile_start;
+}
+
+/**
+ * Profile Release frees what was measured.
+ */
+void profile_release() {
+    free(profile_lines);
+    free(profile_functions);
+    profile_lines = NULL;
+    profile_functions = NULL;
+    profile_line_count = 0;
+    profile_function_count = 0;
+}
+
+/**
+ * Profile Seconds returns the monotonic clock in seconds.
+ * @return  Seconds elapsed since an arbitrary point.
+ */
+double profile_seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * Profile Line returns the index of the entry of a source line, growing the
+ * entries so that every line up to it has one.
+ * @param   line    Source line.
+ * @return  Index of its entry.
+ */
+int profile_line(int line) {
+    if (line < 0) line = 0;
+    if (line < profile_line_count) return line;
+
+    int i;
+    int count = 2 * profile_line_count > line ? 2 * profile_line_count : line + 1;
+    profile_lines = (profile_entry *)realloc(
+        profile_lines, count * sizeof(profile_entry));
+    if (profile_lines == NULL) {
+        printf("Profile: Out of memory.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(profile_lines + profile_line_count, 0,
+        (count - profile_line_count) * sizeof(profile_entry));
+    for (i=profile_line_count; i<count; i++) profile_lines[i].line = i;
+    profile_line_count = count;
+    return line;
+}
+
+/**
+ * Profile Wrap turns a node into one that measures it. The node is copied and
+ * its place runs the copy through the handler, so the parents and the other
+ * nodes that point to it need no change.
+ * @param   node    Node to measure.
+ * @param   handler Handler that measures it.
+ * @param   index   Index of its entry.
+ */
+void profile_wrap(syntax_node * node, syntax_handler handler, int index) {
+    syntax_node * inner = syntax_initialize();
+    *inner = *node;
+    SYNTAX_LINE(inner) = SYNTAX_LINE(node);
+    node->handler = handler;
+    node->slot = index;
+    node->nodea = syntax_locate(inner);
+    node->nodeb = SYNTAX_NONE;
+    node->nodec = SYNTAX_NONE;
+    node->count = 0;
+    node->list = NULL;
+}
+
+/**
+ * Profile Statement wraps the statements of a list, the ones nested in them
+ * and the calls in their expressions. The STMT lists are not measured, since
+ * their statements are.
+ * @param   node    Statement to walk.
+ */
+void profile_statement(syntax_node * node) {
+    int i;
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return;
+
+    switch (node->instruction) {
+        case SYNTAX_STMT:
+            for (i=0; i<node->count; i++)
+                profile_statement(SYNTAX_AT(node->list[i]));
+            return;
+        case SYNTAX_ASSIGN:
+            profile_expression(SYNTAX_NODEB(node));
+            break;
+        case SYNTAX_IF:
+        case SYNTAX_IFELSE:
+        case SYNTAX_WHILE:
+            profile_expression(SYNTAX_NODEA(node));
+            profile_statement(SYNTAX_NODEB(node));
+            profile_statement(SYNTAX_NODEC(node));
+            break;
+        default:
+            // READ, PRINT and RETURN.
+            profile_expression(SYNTAX_NODEA(node));
+            break;
+    }
+    profile_wrap(
+        node, profile_execute_statement, profile_line(SYNTAX_LINE(node)));
+}
+
+/**
+ * Profile Expression wraps the function calls of an expression, including
+ * the ones in the arguments of other calls.
+ * @param   node    Expression to walk.
+ */
+void profile_expression(syntax_node * node) {
+    if (node == NULL || node->nodetype != SYNTAX_INSTRUCTION) return;
+    profile_expression(SYNTAX_NODEA(node));
+    profile_expression(SYNTAX_NODEB(node));
+    if (node->instruction == SYNTAX_FUNCTION)
+        profile_wrap(node, profile_execute_function, node->slot);
+}
+
+/**
+ * Profile Run runs a node and adds its time to an entry. Only the outermost
+ * run of an entry is timed, so the time of a line or a function that runs
+ * again through a recursive call is not counted twice.
+ * @param   entry   Entry of the node.
+ * @param   node    Node to run.
+ */
+void profile_run(profile_entry * entry, syntax_node * node) {
+    entry->count ++;
+    if (entry->active ++ > 0) {
+        syntax_execute_nodetype(node);
+        entry->active --;
+        return;
+    }
+
+    double start = profile_seconds();
+    syntax_execute_nodetype(node);
+    entry->seconds += profile_seconds() - start;
+    entry->active --;
+}
+
+/**
+ * Interpretation of a measured statement, it runs the original one.
+ * @param   node    Node to run.
+ */
+void profile_execute_statement(syntax_node * node) {
+    profile_run(&profile_lines[node->slot], SYNTAX_NODEA(node));
+}
+
+/**
+ * Interpretation of a measured function call, it runs the original one and
+ * takes its value, which is what the parent reads.
+ * @param   node    Node to run.
+ */
+void profile_execute_function(syntax_node * node) {
+    profile_run(&profile_functions[node->slot], SYNTAX_NODEA(node));
+    node->value = SYNTAX_NODEA(node)->value;
+}
+
+/**
+ * Profile Compare orders entries from the most time to the least for qsort.
+ * @param   one     First entry.
+ * @param   two     Second entry.
+ * @return  Negative, zero or positive like strcmp.
+ */
+int profile_compare(const void * one, const void * two) {
+    const profile_entry * a = *(profile_entry * const *)one;
+    const profile_entry * b = *(profile_entry * const *)two;
+    if (a->seconds != b->seconds) return a->seconds < b->seconds ? 1 : -1;
+    return a->line - b->line;
+}
+
+/**
+ * Profile Sort returns the entries that ran, from the most time to the least.
+ * @param   entries Entries to sort.
+ * @param   size    Amount of entries.
+ * @param   count   Where to store the amount of entries that ran.
+ * @return  Array of the entries that ran, to be freed by the caller.
+ */
+profile_entry ** profile_sort(profile_entry * entries, int size, int * count) {
+    int i;
+    profile_entry ** sorted = (profile_entry **)malloc(
+        (size + 1) * sizeof(profile_entry *));
+    *count = 0;
+    for (i=0; i<size; i++)
+        if (entries[i].count > 0) sorted[(*count) ++] = &entries[i];
+    qsort(sorted, *count, sizeof(profile_entry *), profile_compare);
+    return sorted;
+}
+
+/**
+ * Profile Source copies a line of the program, without its indentation and
+ * cut to the size of the text.
+ * @param   source  Program file, may be NULL.
+ * @param   line    Line to copy.
+ * @param   text    Where to copy it.
+ * @param   size    Size of the text.
+ */
+void profile_source(FILE * source, int line, char * text, int size) {
+    int current = 1;
+    int length = 0;
+    int c;
+    text[0] = '\0';
+    if (source == NULL) return;
+
+    rewind(source);
+    while (current <= line && (c = fgetc(source)) != EOF) {
+        if (c == '\n') current ++;
+        else if (current == line && length < size - 1 && c != '\r'
+            && !(length == 0 && (c == ' ' || c == '\t'))) text[length ++] = c;
+    }
+    text[length] = '\0';
+}
+
+/**
+ * Profile Print prints the lines and the functions that took the most time,
+ * with the source of each line.
+ * @param   file    Program file.
+ */
+void profile_print(char * file) {
+    int i, count;
+    char text[PROFILE_SOURCE];
+    FILE * source = fopen(file, "r");
+    double total = profile_total > 0 ? profile_total : 1;
+    profile_entry ** sorted;
+
+    printf("\n");
+    printf("Profile: %.6f seconds\n", profile_total);
+    printf("%12s%12s%12s%12s  %s", "line", "count", "seconds", "percent",
+        "source");
+    printf("\n\n");
+    sorted = profile_sort(profile_lines, profile_line_count, &count);
+    for (i=0; i<count && i<PROFILE_TOP; i++) {
+        profile_source(source, sorted[i]->line, text, PROFILE_SOURCE);
+        printf("%12d%12ld%12.6f%11.2f%%  %s\n", sorted[i]->line,
+            sorted[i]->count, sorted[i]->seconds,
+            100 * sorted[i]->seconds / total, text);
+    }
+    free(sorted);
+
+    sorted = profile_sort(profile_functions, profile_function_count, &count);
+    if (count > 0) {
+        printf("\n");
+        printf("%12s%12s%12s%12s  %s", "line", "calls", "seconds", "percent",
+            "function");
+        printf("\n\n");
+    }
+    for (i=0; i<count && i<PROFILE_TOP; i++)
+        printf("%12d%12ld%12.6f%11.2f%%  %s\n", sorted[i]->line,
+            sorted[i]->count, sorted[i]->seconds,
+            100 * sorted[i]->seconds / total, sorted[i]->name);
+    free(sorted);
+
+    if (source != NULL) fclose(source);
+}
+
+/**
+ * Profile Write writes every line and function that ran as CSV, in the order
+ * of the lines, so that runs can be compared or loaded in other tools.
+ * @param   file    File to write.
+ * @return  Whether the file could be written.
+ */
+bool profile_write(char * file) {
+    int i;
+    FILE * csv = fopen(file, "w");
+    if (csv == NULL) return false;
+
+    fprintf(csv, "kind,line,name,count,seconds\n");
+    for (i=0; i<profile_line_count; i++)
+        if (profile_lines[i].count > 0)
+            fprintf(csv, "line,%d,,%ld,%.9f\n", profile_lines[i].line,
+                profile_lines[i].count, profile_lines[i].seconds);
+    for (i=0; i<profile_function_count; i++)
+        if (profile_functions[i].count > 0)
+            fprintf(csv, "function,%d,%s,%ld,%.9f\n", profile_functions[i].line,
+                profile_functions[i].name, profile_functions[i].count,
+                profile_functions[i].seconds);
+    fclose(csv);
+    return true;
+}
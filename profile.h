@@ -0,0 +1,43 @@
+#ifndef _PROFILEH_
+#define _PROFILEH_
+
+// Imports
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "symbol_table.h"
+#include "syntax_tree.h"
+
+// Definitions
+#define PROFILE_TOP         20
+#define PROFILE_SOURCE      48
+
+// Declarations
+typedef struct profile_entry {
+    int line;
+    char * name;
+    long count;
+    int active;
+    double seconds;
+} profile_entry;
+
+void profile_initialize(syntax_node *, symbol_table *);
+void profile_finish();
+void profile_release();
+double profile_seconds();
+int profile_line(int);
+void profile_wrap(syntax_node *, syntax_handler, int);
+void profile_statement(syntax_node *);
+void profile_expression(syntax_node *);
+void profile_run(profile_entry *, syntax_node *);
+void profile_execute_statement(syntax_node *);
+void profile_execute_function(syntax_node *);
+int profile_compare(const void *, const void *);
+profile_entry ** profile_sort(profile_entry *, int, int *);
+void profile_source(FILE *, int, char *, int);
+void profile_print(char *);
+bool profile_write(char *);
+
+#endif
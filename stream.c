@@ -0,0 +1,306 @@
+#include "stream.h"
+
+/**
+ * Stream Buffer is a block of characters between the interpreter and one of
+ * the standard streams, used in batch mode so that a print or a read does not
+ * cost a system call and a format string each.
+ * @param   size    Amount of characters reserved.
+ * @param   used    Characters written, or characters consumed when reading.
+ * @param   length  Characters available to read.
+ * @param   data    Characters of the buffer.
+ */
+// typedef struct stream_buffer {
+//     int size;
+//     int used;
+//     int length;
+//     char * data;
+// } stream_buffer;
+
+/**
+ * Stream Record is a set of values that a run reads and prints instead of the
+ * standard streams, used by the programs that embed the interpreter.
+ * @param   inputs          Values of the reads.
+ * @param   input_count     Amount of inputs.
+ * @param   input_used      Inputs already read.
+ * @param   outputs         Values printed.
+ * @param   output_capacity Amount of outputs reserved.
+ * @param   output_count    Values printed, including the ones that did not fit.
+ */
+// typedef struct stream_record {
+//     struct data_value * inputs;
+//     int input_count;
+//     int input_used;
+//     struct data_value * outputs;
+//     int output_capacity;
+//     int output_count;
+// } stream_record;
+
+// Global Values. Each thread has its own streams, such as a batch worker.
+_Thread_local bool global_batch = false;
+_Thread_local stream_buffer stream_output;
+_Thread_local stream_buffer stream_input;
+_Thread_local int stream_descriptor = STDIN_FILENO;
+_Thread_local FILE * stream_file = NULL;
+_Thread_local stream_record * stream_values = NULL;
+
+/**
+ * Stream Initialize chooses between the interactive mode, where prints and
+ * reads go straight through printf and scanf with their messages, and the
+ * batch mode, where prints write one raw value per line into a buffer that is
+ * flushed when full or at exit, and reads take the next number of the input
+ * without a prompt.
+ * @param   batch   Whether to use the batch mode.
+ */
+void stream_initialize(bool batch) {
+    global_batch = batch;
+    if (!batch) return;
+    stream_open(STDIN_FILENO, stdout);
+
+    // Values printed before an error are not lost.
+    atexit(stream_flush);
+}
+
+/**
+ * Stream Open puts the calling thread in batch mode over the given streams,
+ * so that a batch job reads its own input and its output can be kept apart.
+ * The buffers of the thread are kept from one job to the next.
+ * @param   descriptor  Descriptor to read from, -1 for an empty input.
+ * @param   file        File to write to.
+ */
+void stream_open(int descriptor, FILE * file) {
+    global_batch = true;
+    stream_descriptor = descriptor;
+    stream_file = file;
+    stream_output.size = STREAM_OUTPUT_SIZE;
+    stream_output.used = 0;
+    stream_input.size = STREAM_INPUT_SIZE;
+    stream_input.used = 0;
+    stream_input.length = 0;
+    if (stream_output.data == NULL)
+        stream_output.data = (char *)malloc(STREAM_OUTPUT_SIZE);
+    if (stream_input.data == NULL)
+        stream_input.data = (char *)malloc(STREAM_INPUT_SIZE);
+    if (stream_output.data == NULL || stream_input.data == NULL) {
+        printf("Stream: Out of memory.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Stream Close flushes the output of a thread opened with stream_open and
+ * leaves it back in the interactive mode, keeping the buffers.
+ */
+void stream_close() {
+    stream_flush();
+    stream_descriptor = STDIN_FILENO;
+    stream_file = NULL;
+    global_batch = false;
+}
+
+/**
+ * Stream Release frees the buffers of the calling thread.
+ */
+void stream_release() {
+    free(stream_output.data);
+    free(stream_input.data);
+    stream_output.data = NULL;
+    stream_input.data = NULL;
+}
+
+/**
+ * Stream Flush writes the output buffer through its file, stdout outside of
+ * the batch jobs, so it keeps its order with the messages printed by printf.
+ */
+void stream_flush() {
+    if (!global_batch || stream_output.used == 0) return;
+    fwrite(stream_output.data, 1, stream_output.used, stream_file);
+    fflush(stream_file);
+    stream_output.used = 0;
+}
+
+/**
+ * Stream Record Open makes the reads and prints of the calling thread use the
+ * values of a record, until it is closed.
+ * @param   record  Record of the run.
+ */
+void stream_record_open(stream_record * record) {
+    record->input_used = 0;
+    record->output_count = 0;
+    stream_values = record;
+}
+
+/**
+ * Stream Record Close gives the calling thread back its streams.
+ */
+void stream_record_close() {
+    stream_values = NULL;
+}
+
+/**
+ * Stream Record Read returns the next input of the record, converted to the
+ * type of the read. A missing input reads as zero, like an empty stream.
+ * @param   numtype Type of the read.
+ * @return  Number read.
+ */
+data_number stream_record_read(char numtype) {
+    data_number number;
+    number.int_value = 0;
+    if (stream_values->input_used == stream_values->input_count) return number;
+
+    data_value input = stream_values->inputs[stream_values->input_used ++];
+    if (numtype == DATA_INTEGER && input.numtype == DATA_FLOAT)
+        number.int_value = (int)input.number.float_value;
+    else if (numtype == DATA_FLOAT && input.numtype == DATA_INTEGER)
+        number.float_value = (float)input.number.int_value;
+    else number = input.number;
+    return number;
+}
+
+/**
+ * Stream Record Write appends a printed value to the outputs of the record.
+ * Values past the capacity are only counted.
+ * @param   value   Value printed.
+ */
+void stream_record_write(data_value value) {
+    if (stream_values->output_count < stream_values->output_capacity)
+        stream_values->outputs[stream_values->output_count] = value;
+    stream_values->output_count ++;
+}
+
+/**
+ * Stream Print Integer prints an integer, converted by hand in batch mode.
+ * @param   value   Value to print.
+ */
+void stream_print_integer(int value) {
+    if (stream_values != NULL) {
+        stream_record_write(data_create_integer(value));
+        return;
+    }
+    if (!global_batch) {
+        printf("\nThe value is %d\n", value);
+        return;
+    }
+    if (stream_output.used + STREAM_NUMBER_SIZE > stream_output.size)
+        stream_flush();
+
+    // Digits are written backwards, the unsigned copy also covers INT_MIN.
+    char digits[STREAM_NUMBER_SIZE];
+    int count = 0;
+    unsigned int magnitude = value < 0
+        ? 0u - (unsigned int)value : (unsigned int)value;
+    do {
+        digits[count ++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    char * data = stream_output.data + stream_output.used;
+    if (value < 0) *data ++ = '-';
+    while (count > 0) *data ++ = digits[-- count];
+    *data ++ = '\n';
+    stream_output.used = data - stream_output.data;
+}
+
+/**
+ * Stream Print Float prints a float with the six decimals of %f.
+ * @param   value   Value to print.
+ */
+void stream_print_float(float value) {
+    if (stream_values != NULL) {
+        stream_record_write(data_create_float(value));
+        return;
+    }
+    if (!global_batch) {
+        printf("\nThe value is %f\n", value);
+        return;
+    }
+    if (stream_output.used + STREAM_NUMBER_SIZE > stream_output.size)
+        stream_flush();
+    stream_output.used += snprintf(stream_output.data + stream_output.used,
+        STREAM_NUMBER_SIZE, "%f\n", value);
+}
+
+/**
+ * Stream Next returns the next character of the input, refilling the buffer
+ * when it runs out.
+ * @return  Character read, or EOF.
+ */
+int stream_next() {
+    if (stream_input.used == stream_input.length) {
+        if (stream_descriptor < 0) return EOF;
+        ssize_t length = read(
+            stream_descriptor, stream_input.data, stream_input.size);
+        if (length <= 0) return EOF;
+        stream_input.length = length;
+        stream_input.used = 0;
+    }
+    return (unsigned char)stream_input.data[stream_input.used ++];
+}
+
+/**
+ * Stream Skip consumes the whitespace before a number.
+ * @return  First character after the whitespace, or EOF.
+ */
+int stream_skip() {
+    int character;
+    do character = stream_next();
+    while (character == ' ' || character == '\n' || character == '\t'
+        || character == '\r');
+    return character;
+}
+
+/**
+ * Stream Read Integer reads an integer, parsed by hand in batch mode. A
+ * missing number reads as zero.
+ * @param   identifier  Identifier read, used for the prompt.
+ * @return  Value read.
+ */
+int stream_read_integer(char * identifier) {
+    if (stream_values != NULL)
+        return stream_record_read(DATA_INTEGER).int_value;
+    if (!global_batch) {
+        int input;
+        printf("\nEnter an integer for the identifier %s : ", identifier);
+        scanf("%d", &input);
+        return input;
+    }
+
+    int character = stream_skip();
+    bool negative = character == '-';
+    if (character == '-' || character == '+') character = stream_next();
+
+    unsigned int magnitude = 0;
+    while (character >= '0' && character <= '9') {
+        magnitude = magnitude * 10 + (character - '0');
+        character = stream_next();
+    }
+    return negative ? (int)(0u - magnitude) : (int)magnitude;
+}
+
+/**
+ * Stream Read Float reads a float. In batch mode the characters of the number
+ * are gathered by hand and converted with strtof, which rounds correctly. A
+ * missing number reads as zero.
+ * @param   identifier  Identifier read, used for the prompt.
+ * @return  Value read.
+ */
+float stream_read_float(char * identifier) {
+    if (stream_values != NULL)
+        return stream_record_read(DATA_FLOAT).float_value;
+    if (!global_batch) {
+        float input;
+        printf("\nEnter a float for the identifier %s :", identifier);
+        scanf("%f", &input);
+        return input;
+    }
+
+    char number[STREAM_NUMBER_SIZE];
+    int count = 0;
+    int character = stream_skip();
+    while (character != EOF && character != ' ' && character != '\n'
+        && character != '\t' && character != '\r') {
+        if (count < STREAM_NUMBER_SIZE - 1) number[count ++] = character;
+        character = stream_next();
+    }
+    number[count] = '\0';
+    return strtof(number, NULL);
+}
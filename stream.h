@@ -0,0 +1,52 @@
+#ifndef _STREAMH_
+#define _STREAMH_
+
+// Imports
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "data.h"
+
+// Definitions
+#define STREAM_OUTPUT_SIZE  1048576
+#define STREAM_INPUT_SIZE   65536
+#define STREAM_NUMBER_SIZE  64
+
+// Declarations
+typedef struct stream_buffer {
+    int size;
+    int used;
+    int length;
+    char * data;
+} stream_buffer;
+typedef struct stream_record {
+    struct data_value * inputs;
+    int input_count;
+    int input_used;
+    struct data_value * outputs;
+    int output_capacity;
+    int output_count;
+} stream_record;
+
+// Global Values.
+extern _Thread_local bool global_batch;
+
+void stream_initialize(bool);
+void stream_open(int, FILE *);
+void stream_close();
+void stream_release();
+void stream_record_open(stream_record *);
+void stream_record_close();
+data_number stream_record_read(char);
+void stream_record_write(data_value);
+void stream_flush();
+void stream_print_integer(int);
+void stream_print_float(float);
+int stream_read_integer(char *);
+float stream_read_float(char *);
+int stream_next();
+int stream_skip();
+
+#endif
@@ -3,47 +3,92 @@
 /**
  * Param List has the amount of parameters and the contents of them when the
  * symbol item is of type function. Using this we can observe if calling a
- * function was correct.
+ * function was correct. Locals of a function use the same list.
+ * @param   offset      Offset of the parameter in the frame of a call.
  * @param   identifier  Identifier of the parameter.
- * @param   value       Value of the parameter.
+ * @param   value       Value of the parameter, zero of its type.
  * @param   next        Next parameter.
  */
 // typedef struct param_list {
+//     int offset;
 //     char * identifier;
-//     data_value * value;
+//     data_value value;
 //     struct param_list * next;
 // } param_list;
 
+/**
+ * Symbol Function is what a call needs to run a function. Calls are bound to
+ * it while parsing, and it does not move when the table grows. The frame of
+ * a call has the parameters first and then the locals.
+ * @param   args        Argument count.
+ * @param   size        Amount of values in the frame of a call.
+ * @param   value       Zero of the return type.
+ * @param   list        Parameters of the function.
+ * @param   locals      Locals of the function.
+ * @param   node        Body of the function.
+ * @param   writes      Whether a call may change the storage, set by the
+ *                      optimizer.
+ * @param   pure        Whether the result only depends on the arguments, set
+ *                      by the optimizer.
+ * @param   memoize     Whether calls keep their results in memo, set by the
+ *                      optimizer.
+ * @param   memo        Results of the calls, taken on the first call.
+ */
+// typedef struct symbol_function {
+//     int args;
+//     int size;
+//     bool writes;
+//     bool pure;
+//     bool memoize;
+//     data_value value;
+//     struct param_list * list;
+//     struct param_list * locals;
+//     struct syntax_node * node;
+//     struct data_value * memo;
+// } symbol_function;
+
 /**
  * Symbols Item is each instance of a possible symbol item. It includes its hash
- * key, the identifier string, its numtype and the data_value union, which can 
- * be accessed depending on the numtype.
+ * key, the identifier string, and the slot of the table where its data_value
+ * is stored, which can be accessed depending on the numtype. Parameters and
+ * locals are only in the table while their function is parsed, their slot is
+ * the offset in the frame and their list is their own entry of the function.
  * @param   key         Hash key of this node.
- * @param   args        Argument count.
+ * @param   slot        Storage slot or frame offset of the value of this node.
  * @param   symtype     Type of this node.
  * @param   identifier  String identifier of this node.
- * @param   numtype     Numerical type of this node.
- * @param   value       Union value of this node.
  * @param   list        List of this node.
- * @param   node        Node of this node.
+ * @param   function    Function of this node.
  */
 // typedef struct symbol_item {
-//     int key;
-//     int args;
+//     unsigned int key;
+//     int slot;
 //     char symtype;
 //     char * identifier;
-//     struct data_value * value;
 //     struct param_list * list;
-//     struct syntax_node * node;
+//     struct symbol_function * function;
 // } symbol_item;
 
 /**
- * Symbol Table stores the array of symbol_items and the size of said array.
- * @param   size    Size of the table.
- * @param   items   Items of the table.    
+ * Symbol Table stores the array of symbol_items, an open addressing hash table
+ * whose amount of buckets doubles once the load factor would go over 0.7.
+ * The values live apart from the items in a storage array indexed by slot, so
+ * the syntax tree can bind identifiers to their slot while parsing and read
+ * or write them at run time without hashing the identifier.
+ * @param   size        Amount of items in the table.
+ * @param   buckets     Amount of buckets of the items array.
+ * @param   slots       Amount of storage slots in use.
+ * @param   capacity    Amount of storage slots reserved.
+ * @param   values      Storage of the values, indexed by slot.
+ * @param   items       Items of the table.    
  */
 // typedef struct symbol_table {
 //     int size;
+//     int buckets;
+//     int slots;
+//     int capacity;
+//     char symtype;
+//     struct data_value * values;
 //     struct symbol_item * items;
 // } symbol_table;
 
@@ -55,20 +100,59 @@ symbol_table * symbol_initialize() {
     symbol_table * table;
     table = (symbol_table *)calloc(1, sizeof(symbol_table));
     table->size = 0;
-    table->items = symbol_itemize();
+    table->buckets = SYMBOL_SIZE;
+    table->slots = 0;
+    table->capacity = SYMBOL_SLOTS;
+    table->values = (data_value *)calloc(SYMBOL_SLOTS, sizeof(data_value));
+    table->items = symbol_itemize(SYMBOL_SIZE);
     return table;
 }
 
+/**
+ * Symbol Table Release frees the table. The functions and parameters it points
+ * to live in the arena and are freed with it.
+ * @param   table   Symbol table.
+ */
+void symbol_release(symbol_table * table) {
+    if (table == NULL) return;
+    free(table->values);
+    free(table->items);
+    free(table);
+}
+
+/**
+ * Symbol Slot Create reserves a new storage slot initialized to value, and
+ * grows the storage array when it is full.
+ * @param   table   Symbol table.
+ * @param   value   Initial value of the slot.
+ * @return  Index of the slot.
+ */
+int symbol_slot_create(symbol_table * table, data_value value) {
+    if (table->slots == table->capacity) {
+        data_value * values = (data_value *)realloc(
+            table->values, 2 * table->capacity * sizeof(data_value));
+        if (values == NULL) {
+            printf("Symbol: Out of memory.\n");
+            exit(EXIT_FAILURE);
+        }
+        table->values = values;
+        table->capacity *= 2;
+    }
+    table->values[table->slots] = value;
+    return table->slots ++;
+}
+
 /**
  * Symbol Items Initialize returns the allocated symbol item array.
+ * @param   buckets Amount of buckets of the array.
  * @return  Initialized symbol item array pointer.
  */
-symbol_item * symbol_itemize() {
+symbol_item * symbol_itemize(int buckets) {
     symbol_item * items;
     items = (symbol_item *)calloc(
-        SYMBOL_SIZE, sizeof(symbol_item));
+        buckets, sizeof(symbol_item));
     int i;
-    for (i=0; i<SYMBOL_SIZE; i++)
+    for (i=0; i<buckets; i++)
         items[i].symtype = SYMBOL_EMPTY;
     return items;
 }
@@ -101,12 +185,17 @@ param_list * symbol_param_join(param_list * one, param_list * two) {
 /**
  * Symbol Paramize creates a single param list.
  * @param   identifier  Identifier of the parameter.
+ * @param   offset      Frame offset of the parameter.
  * @param   value       Value of the parameter.
  * @return  Single parameter.
  */
-param_list * symbol_param_create(char * identifier, data_value * value) {
+param_list * symbol_param_create(
+    char * identifier, int offset, data_value value
+) {
     param_list * list;
-    list = (param_list *)calloc(1, sizeof(param_list));
+    list = (param_list *)arena_allocate(
+        global_arena, ARENA_PARAM, sizeof(param_list));
+    list->offset = offset;
     list->identifier = identifier;
     list->value = value;
     list->next = NULL;
@@ -120,7 +209,7 @@ param_list * symbol_param_create(char * identifier, data_value * value) {
  * @param   index       Position where to get the argument.
  * @return  Data value of the function.
  */
-data_value * symbol_param_value(
+data_value symbol_param_value(
     symbol_table * table, char * identifier, int index
 ) {
     param_list * list = symbol_get_list(table, identifier);
@@ -169,17 +258,18 @@ void symbol_print(symbol_table * table) {
     printf("%4s%10s%10s%10s%10s", headerp, headerk, headeri, headert, headerv);
     printf("\n\n");
     
-    for (i=0; i<SYMBOL_SIZE; i++) {
-        if (table->items[i].value != NULL) {
+    for (i=0; i<table->buckets; i++) {
+        if (table->items[i].symtype != SYMBOL_EMPTY) {
         printf("[%2d]", i);
-        printf("%10d", table->items[i].key);
+        printf("%10u", table->items[i].key);
         printf("%10s", table->items[i].identifier);
-            if (table->items[i].value->numtype == DATA_INTEGER) {
+        data_value value = table->values[table->items[i].slot];
+            if (value.numtype == DATA_INTEGER) {
                 printf("%10s", typei);
-                printf("%10d", table->items[i].value->number.int_value);
-            } else if (table->items[i].value->numtype == DATA_FLOAT) {
+                printf("%10d", value.number.int_value);
+            } else if (value.numtype == DATA_FLOAT) {
                 printf("%10s", typef);
-                printf("%10f", table->items[i].value->number.float_value);
+                printf("%10f", value.number.float_value);
             } else {
                 printf("%10s", typen);
                 printf("%10d", 0);
@@ -191,51 +281,49 @@ void symbol_print(symbol_table * table) {
 }
 
 /**
- * Hash Key returns the hash of the identifier's string. Uses Java's hashCode()
- * equivalent, which exponentiates a constant of 31 to the length-i.
+ * Hash Key returns the hash of the identifier's string. Uses the 32 bit
+ * FNV-1a hash, which is a xor and a multiplication per character.
  * @param   identifier  String of the identifier.
  * @return  Hash key of the identifier.
  */
-int symbol_hash_key(char * identifier) {
-    int i, key, length;
-    double constant, left;
-
-    length = strlen(identifier);
-    left = (double)length - 1;
-    key = 0;
-    constant = 31;
-    for (i=0; i<length; i++){
-        key += identifier[i] * (int)(floor(pow(constant, left)));
-        left --;
+unsigned int symbol_hash_key(char * identifier) {
+    unsigned int key = SYMBOL_FNV_BASIS;
+    while (*identifier != '\0') {
+        key ^= (unsigned char)*identifier;
+        key *= SYMBOL_FNV_PRIME;
+        identifier ++;
     }
     return key;
 }
 
 /**
  * Hash Index returns the index where the item would be found in the array.
+ * The amount of buckets is always a power of two.
  * @param   key     Hash key of the item.
+ * @param   buckets Amount of buckets of the table.
  * @return  Expected array index of the identifier.
  */
-int symbol_hash_index(int key) {
-    return abs(key % SYMBOL_SIZE);
+int symbol_hash_index(unsigned int key, int buckets) {
+    return (int)(key & (unsigned int)(buckets - 1));
 }
 
 /**
- * Symbol Table Search looks for an item inside of the symbol table array.
+ * Symbol Table Search looks for an item inside of the symbol table array. It
+ * probes linearly from the hash index until an empty bucket, and compares the
+ * full identifier of the items whose key matches.
  * @param   table       Symbol table.
  * @param   identifier  String of the identifier.
  * @return  Position of the item, -1 is not found.
  */
 int symbol_search(symbol_table * table, char * identifier) {
-    int key = symbol_hash_key(identifier);
-    int index = symbol_hash_index(key);
-    int curr = index;
-
-    while (table->items[curr].key != 0) {
-        if (table->items[curr].key == key) return curr;
-        curr ++;
-        if (curr >= SYMBOL_SIZE) curr = 0;
-        if (curr == index) return SYMBOL_NOT_FOUND;
+    unsigned int key = symbol_hash_key(identifier);
+    int curr = symbol_hash_index(key, table->buckets);
+
+    while (table->items[curr].symtype != SYMBOL_EMPTY) {
+        if (table->items[curr].key == key &&
+            strcmp(table->items[curr].identifier, identifier) == 0)
+            return curr;
+        curr = (curr + 1) & (table->buckets - 1);
     }
     return SYMBOL_NOT_FOUND;
 }
@@ -252,12 +340,74 @@ bool symbol_exists(symbol_table * table, char * identifier) {
 }
 
 /**
- * Symbol Table Is Full tells about the occupancy of the symbol table.
+ * Symbol Table Is Full tells if one more item would go over the load factor.
  * @param   table   Symbol table.
- * @return  True if the symbol table is full.
+ * @return  True if the symbol table has to grow before inserting.
  */
 bool symbol_is_full(symbol_table * table) {
-    return table->size == SYMBOL_SIZE;
+    return (table->size + 1) * SYMBOL_LOAD_DIVISOR >
+        table->buckets * SYMBOL_LOAD_DIVIDEND;
+}
+
+/**
+ * Symbol Table Resize doubles the amount of buckets and places every item
+ * again. The storage slots do not move, so the nodes bound to them are kept.
+ * @param   table   Symbol table.
+ */
+void symbol_resize(symbol_table * table) {
+    int i;
+    int buckets = table->buckets;
+    symbol_item * items = table->items;
+
+    table->buckets = buckets * 2;
+    table->items = symbol_itemize(table->buckets);
+    for (i=0; i<buckets; i++) {
+        if (items[i].symtype == SYMBOL_EMPTY) continue;
+        int curr = symbol_hash_index(items[i].key, table->buckets);
+        while (table->items[curr].symtype != SYMBOL_EMPTY)
+            curr = (curr + 1) & (table->buckets - 1);
+        table->items[curr] = items[i];
+    }
+    free(items);
+}
+
+/**
+ * Symbol Close Scope removes the parameters and locals of the function that
+ * was just parsed, placing every other item again. Their names can be used
+ * again by the functions that follow.
+ * @param   table   Symbol table.
+ */
+void symbol_close_scope(symbol_table * table) {
+    int i;
+    symbol_item * items = table->items;
+
+    table->items = symbol_itemize(table->buckets);
+    table->size = 0;
+    for (i=0; i<table->buckets; i++) {
+        if (items[i].symtype == SYMBOL_EMPTY) continue;
+        if (items[i].symtype == SYMBOL_LOCAL) continue;
+        symbol_place(table, items[i]);
+    }
+    free(items);
+}
+
+/**
+ * Symbol Table Place stores an item in the first empty bucket found from its
+ * hash index, growing the table first if needed.
+ * @param   table   Symbol table.
+ * @param   item    Item to store.
+ * @return  True if the item was placed.
+ */
+bool symbol_place(symbol_table * table, symbol_item item) {
+    if (symbol_is_full(table)) symbol_resize(table);
+
+    int curr = symbol_hash_index(item.key, table->buckets);
+    while (table->items[curr].symtype != SYMBOL_EMPTY)
+        curr = (curr + 1) & (table->buckets - 1);
+
+    table->items[curr] = item;
+    table->size ++;
+    return true;
 }
 
 /**
@@ -268,7 +418,20 @@ bool symbol_is_full(symbol_table * table) {
 bool symbol_is_identifier(symbol_table * table, char * identifier) {
     int index = symbol_search(table, identifier);
     if (index == SYMBOL_NOT_FOUND) return false;
-    return table->items[index].symtype == SYMBOL_IDENTIFIER;
+    return table->items[index].symtype == SYMBOL_IDENTIFIER ||
+        table->items[index].symtype == SYMBOL_LOCAL;
+}
+
+/**
+ * Symbol is Local returns true if the symbol is found and is a parameter or
+ * local of the function being parsed.
+ * @param   table       Symbol table.
+ * @param   identifier  Identifier to look for.
+ */
+bool symbol_is_local(symbol_table * table, char * identifier) {
+    int index = symbol_search(table, identifier);
+    if (index == SYMBOL_NOT_FOUND) return false;
+    return table->items[index].symtype == SYMBOL_LOCAL;
 }
 
 /**
@@ -290,67 +453,108 @@ bool symbol_is_function(symbol_table * table, char * identifier) {
  * @return  True if the insertion was successful.
  */
 bool symbol_insert_identifier(
-    symbol_table * table, char * identifier, data_value * value
+    symbol_table * table, char * identifier, data_value value
 ) {
-    if (symbol_is_full(table)) return false;
-    
-    int key = symbol_hash_key(identifier);
-    int index = symbol_hash_index(key);
-    int curr = index;
-
-    while (table->items[curr].key != 0) {
-        curr ++;
-        if (curr >= SYMBOL_SIZE) curr = 0;
-        if (curr == index) return false;
-    }
-
     symbol_item item;
-    item.key = key;
-    item.args = 0;
+    item.key = symbol_hash_key(identifier);
+    item.slot = symbol_slot_create(table, value);
     item.symtype = SYMBOL_IDENTIFIER;
     item.identifier = identifier;
-    item.value = value;
     item.list = NULL;
-    item.node = NULL;
-    table->items[curr] = item;
+    item.function = NULL;
+    return symbol_place(table, item);
+}
+
+/**
+ * Symbol Insert Param places a parameter of the function being parsed, at
+ * the next offset of its frame.
+ * @param   table       Symbol table.
+ * @param   identifier  String of the identifier.
+ * @param   value       Value of the identifier.
+ * @param   function    Function being parsed.
+ * @return  Entry of the parameter, NULL if the insertion failed.
+ */
+param_list * symbol_insert_param(
+    symbol_table * table, char * identifier, data_value value,
+    symbol_function * function
+) {
+    symbol_item item;
+    item.key = symbol_hash_key(identifier);
+    item.slot = function->size ++;
+    item.symtype = SYMBOL_LOCAL;
+    item.identifier = identifier;
+    item.list = symbol_param_create(identifier, item.slot, value);
+    item.function = NULL;
+    if (!symbol_place(table, item)) return NULL;
+    return item.list;
+}
+
+/**
+ * Symbol Insert Local places a local of the function being parsed, at the
+ * next offset of its frame, and adds it to the locals of the function.
+ * @param   table       Symbol table.
+ * @param   identifier  String of the identifier.
+ * @param   value       Value of the identifier.
+ * @param   function    Function being parsed.
+ * @return  True if the insertion was successful.
+ */
+bool symbol_insert_local(
+    symbol_table * table, char * identifier, data_value value,
+    symbol_function * function
+) {
+    param_list * local;
+    local = symbol_insert_param(table, identifier, value, function);
+    if (local == NULL) return false;
+    local->next = function->locals;
+    function->locals = local;
     return true;
 }
 
+/**
+ * Symbol Function Create returns an empty function, to which the parameters
+ * and locals are added while it is parsed.
+ * @return  Function created.
+ */
+symbol_function * symbol_function_create() {
+    symbol_function * function;
+    function = (symbol_function *)arena_allocate(
+        global_arena, ARENA_FUNCTION, sizeof(symbol_function));
+    function->args = 0;
+    function->size = 0;
+    function->value = SYNTAX_NULLD;
+    function->list = NULL;
+    function->locals = NULL;
+    function->node = NULL;
+    function->memo = NULL;
+    return function;
+}
+
 /**
  * Symbol Table Insert creates an item node and places it depending on its key.
+ * It is inserted before its body is parsed so that it can call itself.
  * @param   table       Symbol table.
  * @param   identifier  String of the identifier.
  * @param   value       Value of the identifier.
  * @param   list        List of the identifier.
- * @param   node        Node of the identifier.
+ * @param   function    Function of the identifier.
  * @return  True if the insertion was successful.
  */
 bool symbol_insert_function(
-    symbol_table * table, char * identifier, data_value * value,
-    param_list * list, syntax_node * node
+    symbol_table * table, char * identifier, data_value value,
+    param_list * list, symbol_function * function
 ) {
-    if (symbol_is_full(table)) return false;
-    
-    int key = symbol_hash_key(identifier);
-    int index = symbol_hash_index(key);
-    int curr = index;
-
-    while (table->items[curr].key != 0) {
-        curr ++;
-        if (curr >= SYMBOL_SIZE) curr = 0;
-        if (curr == index) return false;
-    }
+    function->args = symbol_param_count(list);
+    function->value = value;
+    function->list = list;
 
     symbol_item item;
-    item.key = key;
-    item.args = symbol_param_count(list);
+    item.key = symbol_hash_key(identifier);
+    item.slot = symbol_slot_create(table, value);
     item.symtype = SYMBOL_FUNCTION;
     item.identifier = identifier;
-    item.value = value;
     item.list = list;
-    item.node = node;
-    table->items[curr] = item;
-    return true;
+    item.function = function;
+    return symbol_place(table, item);
 }
 
 /**
@@ -362,13 +566,13 @@ bool symbol_insert_function(
  * @return  True if the assignment was successful.
  */
 bool symbol_assign(
-    symbol_table * table, char * identifier, data_value * value
+    symbol_table * table, char * identifier, data_value value
 ) {
     int index = symbol_search(table, identifier);
-    if (index == SYMBOL_NOT_FOUND)
+    if (index == SYMBOL_NOT_FOUND || table->items[index].symtype == SYMBOL_LOCAL)
         return false;
     else {
-        table->items[index].value = value;
+        table->values[table->items[index].slot] = value;
         return true;
     }
 }
@@ -381,21 +585,36 @@ bool symbol_assign(
  */
 int symbol_get_args(symbol_table * table, char * identifier) {
     int i = symbol_search(table, identifier);
-    if (i == SYMBOL_NOT_FOUND) return 0;
-    return table->items[i].args;
+    if (i == SYMBOL_NOT_FOUND || table->items[i].function == NULL) return 0;
+    return table->items[i].function->args;
 }
 
 
+/**
+ * Symbol Get Slot gets the storage slot of the identifier, or its frame
+ * offset for parameters and locals.
+ * @param   table       Symbol table.
+ * @param   identifier  Identifier to search for.
+ * @return  The slot of the identifier, SYMBOL_NOT_FOUND if missing.
+ */
+int symbol_get_slot(symbol_table * table, char * identifier) {
+    int i = symbol_search(table, identifier);
+    if (i == SYMBOL_NOT_FOUND) return SYMBOL_NOT_FOUND;
+    return table->items[i].slot;
+}
+
 /**
  * Function Get Value gets the data_value from the Function.
  * @param   table       Function table.
  * @param   identifier  Identifier to search for.
  * @return  The value inside of the function.
  */
-data_value * symbol_get_value(symbol_table * table, char * identifier) {
+data_value symbol_get_value(symbol_table * table, char * identifier) {
     int i = symbol_search(table, identifier);
     if (i == SYMBOL_NOT_FOUND) return data_create_integer(0);
-    return table->items[i].value;
+    if (table->items[i].symtype == SYMBOL_LOCAL)
+        return table->items[i].list->value;
+    return table->values[table->items[i].slot];
 }
 
 /**
@@ -418,6 +637,19 @@ param_list * symbol_get_list(symbol_table * table, char * identifier) {
  */
 syntax_node * symbol_get_node(symbol_table * table, char * identifier) {
     int i = symbol_search(table, identifier);
-    if (i == SYMBOL_NOT_FOUND) return syntax_initialize();
-    return table->items[i].node;
+    if (i == SYMBOL_NOT_FOUND || table->items[i].function == NULL)
+        return syntax_initialize();
+    return table->items[i].function->node;
+}
+
+/**
+ * Function Get Function gets the symbol_function from the function.
+ * @param   table       Function table.
+ * @param   identifier  Identifier to search for.
+ * @return  The function, NULL if it is not one.
+ */
+symbol_function * symbol_get_function(symbol_table * table, char * identifier) {
+    int i = symbol_search(table, identifier);
+    if (i == SYMBOL_NOT_FOUND) return NULL;
+    return table->items[i].function;
 }
\ No newline at end of file
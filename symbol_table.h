@@ -2,7 +2,6 @@
 #define _SYMBOLH_
 
 // Imports
-#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,60 +10,97 @@
 #include "syntax_tree.h"
 
 // Definitions
-#define SYMBOL_SIZE         30
+#define SYMBOL_SIZE         32
+#define SYMBOL_SLOTS        16
+#define SYMBOL_LOAD_DIVIDEND    7
+#define SYMBOL_LOAD_DIVISOR     10
+#define SYMBOL_FNV_BASIS    2166136261u
+#define SYMBOL_FNV_PRIME    16777619u
 #define SYMBOL_NOT_FOUND    -1
 #define SYMBOL_EMPTY        'E'
 #define SYMBOL_IDENTIFIER   'I'
 #define SYMBOL_FUNCTION     'F'
+#define SYMBOL_LOCAL        'L'
 
 // Declarations (Circular Header Inclusion)
 // typedef struct param_list {
+//     int offset;
 //     char * identifier;
-//     data_value * value;
+//     data_value value;
 //     struct param_list * next;
 // } param_list;
-// typedef struct symbol_item {
-//     int key;
+// typedef struct symbol_function {
 //     int args;
+//     int size;
+//     bool writes;
+//     bool pure;
+//     bool memoize;
+//     data_value value;
+//     struct param_list * list;
+//     struct param_list * locals;
+//     struct syntax_node * node;
+//     struct data_value * memo;
+// } symbol_function;
+// typedef struct symbol_item {
+//     unsigned int key;
+//     int slot;
 //     char symtype;
 //     char * identifier;
-//     struct data_value * value;
 //     struct param_list * list;
-//     struct syntax_node * node;
+//     struct symbol_function * function;
 // } symbol_item;
 // typedef struct symbol_table {
 //     int size;
+//     int buckets;
+//     int slots;
+//     int capacity;
 //     char symtype;
+//     struct data_value * values;
 //     struct symbol_item * items;
 // } symbol_table;
 
 symbol_table * symbol_initialize();
-symbol_item * symbol_itemize();
+void symbol_release(symbol_table *);
+symbol_item * symbol_itemize(int);
 
 int symbol_param_count(param_list *);
 param_list * symbol_param_join(param_list *, param_list *);
-param_list * symbol_param_create(char *, data_value *);
-data_value * symbol_param_value(symbol_table *, char *, int);
+param_list * symbol_param_create(char *, int, data_value);
+data_value symbol_param_value(symbol_table *, char *, int);
 bool symbol_param_equal(symbol_table *, char *, int);
 
 void symbol_print(symbol_table *);
-int symbol_hash_key(char *);
-int symbol_hash_index(int);
+unsigned int symbol_hash_key(char *);
+int symbol_hash_index(unsigned int, int);
 int symbol_search(symbol_table *, char *);
 bool symbol_exists(symbol_table *, char *);
 bool symbol_is_full(symbol_table *);
+void symbol_resize(symbol_table *);
+void symbol_close_scope(symbol_table *);
+bool symbol_place(symbol_table *, symbol_item);
 bool symbol_is_identifier(symbol_table *, char *);
 bool symbol_is_function(symbol_table *, char *);
-bool symbol_insert_identifier(symbol_table *, char *, data_value *);
+bool symbol_is_local(symbol_table *, char *);
+bool symbol_insert_identifier(symbol_table *, char *, data_value);
+param_list * symbol_insert_param(
+    symbol_table *, char *, data_value, symbol_function *
+);
+bool symbol_insert_local(
+    symbol_table *, char *, data_value, symbol_function *
+);
+symbol_function * symbol_function_create();
 bool symbol_insert_function(
-    symbol_table *, char *, data_value *,
-    param_list *, syntax_node *
+    symbol_table *, char *, data_value,
+    param_list *, symbol_function *
 );
 
+int symbol_slot_create(symbol_table *, data_value);
 int symbol_get_args(symbol_table *, char *);
-// bool symbol_assign(symbol_table *, char *, data_value *);
-// data_value * symbol_get_value(symbol_table *, char *);
+int symbol_get_slot(symbol_table *, char *);
+// bool symbol_assign(symbol_table *, char *, data_value);
+// data_value symbol_get_value(symbol_table *, char *);
 // param_list * symbol_get_list(symbol_table *, char *);
 // syntax_node * symbol_get_node(symbol_table *, char *);
+// symbol_function * symbol_get_function(symbol_table *, char *);
 
 #endif
\ No newline at end of file
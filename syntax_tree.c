@@ -3,45 +3,126 @@
 /**
  * Tree Node is each instance of a node that can be added in order to interpret
  * the compiler, and each instruction is ran depending on the nodetype showing
- * what to do with the info attribute.
+ * what to do with the info attribute. The handler that runs the node is
+ * resolved once from the nodetype and instruction when the node is created.
+ * Nodes live in the node pool of their arena and refer to each other by their
+ * index in it, so a node takes 64 bytes, a single cache line, with the fields
+ * read while running first. The line is only read by the profiler and the
+ * errors, so it is kept apart in the line pool, at the same index.
+ * @param   handler     Function that runs this node.
+ * @param   value       Value of this node.
+ * @param   nodea       Index of the first auxiliar node for usage.
+ * @param   nodeb       Index of the second auxiliar node for usage.
+ * @param   nodec       Index of the third auxiliar node for usage.
+ * @param   slot        Storage slot of the identifier of this node.
+ * @param   evaluation  Evaluation of this node.
  * @param   nodetype    Type of this node.
  * @param   operation   Operation of this node.
- * @param   evaluation  Evaluation of this node.
  * @param   instruction Instruction of this node.
+ * @param   count       Amount of statements of a STMT.
+ * @param   list        Indices of the statements of a STMT in order, NULL for
+ *                      other nodes.
+ * @param   function    Function called by this node.
  * @param   identifier  Identifier of this node.
- * @param   value       Value of this node.
- * @param   nodea       First auxiliar node for usage.
- * @param   nodeb       Second auxiliar node for usage.
- * @param   nodec       Third auxiliar node for usage.
  */
 // typedef struct syntax_node {
+//     syntax_handler handler;
+//     data_value value;
+//     syntax_index nodea;
+//     syntax_index nodeb;
+//     syntax_index nodec;
+//     int slot;
+//     bool evaluation;
 //     char nodetype;
 //     char operation;
-//     bool evaluation;
 //     char instruction;
+//     int count;
+//     syntax_index * list;
+//     struct symbol_function * function;
 //     char * identifier;
-//     data_value * value;
-//     struct syntax_node * nodea;
-//     struct syntax_node * nodeb;
-//     struct syntax_node * nodec;
 // } syntax_node;
 
+// Node Pool. The pools of the arena of the thread, set by syntax_arena.
+_Thread_local syntax_node * global_nodes;
+_Thread_local int * global_lines;
+
+// Global Values. Each thread runs its own program, such as a batch worker.
+_Thread_local data_value * global_value;
+_Thread_local symbol_table * global_table;
+
+// Memoization. Calls of memoized functions found and not found in their memo.
+_Thread_local long global_memo_hits;
+_Thread_local long global_memo_misses;
+
+// Recovery. Where a runtime error unwinds to and is printed, NULL to exit.
+_Thread_local jmp_buf * global_recover;
+_Thread_local FILE * global_errors;
+
+// Call Stack. Each call pushes a frame with its parameters and locals.
+_Thread_local data_value global_stack[SYNTAX_STACK];
+_Thread_local data_value * global_frame;
+_Thread_local data_value * global_top;
+
+/**
+ * Syntax Arena makes an arena the one of the calling thread, where nodes are
+ * created and found by their index. The first node of an arena is taken so
+ * that no node has the index of NULL.
+ * @param   region  Arena of the thread, may be NULL.
+ */
+void syntax_arena(arena * region) {
+    global_arena = region;
+    if (region != NULL && region->counts[ARENA_NODE] == 0) {
+        arena_allocate(region, ARENA_NODE, sizeof(syntax_node));
+        arena_allocate(region, ARENA_LINE, sizeof(int));
+    }
+    global_nodes = region == NULL ? NULL
+        : (syntax_node *)region->pools[ARENA_NODE].base;
+    global_lines = region == NULL ? NULL
+        : (int *)region->pools[ARENA_LINE].base;
+}
+
+/**
+ * Syntax Allocate takes zeroed nodes in a row from the node pool of the
+ * thread, and their lines from the line pool.
+ * @param   count   Amount of nodes.
+ * @return  First node.
+ */
+syntax_node * syntax_allocate(int count) {
+    arena_allocate(global_arena, ARENA_LINE, count * sizeof(int));
+    return (syntax_node *)arena_allocate(
+        global_arena, ARENA_NODE, count * sizeof(syntax_node));
+}
+
+/**
+ * Syntax Locate returns the index of a node in the node pool of the thread.
+ * @param   node    Node, may be NULL.
+ * @return  Index of the node, SYNTAX_NONE for NULL.
+ */
+syntax_index syntax_locate(syntax_node * node) {
+    if (node == NULL) return SYNTAX_NONE;
+    return (syntax_index)(node - global_nodes);
+}
+
 /**
  * Syntax Initialize simply returns an empty tree node.
  * @return  Node created.
  */
 syntax_node * syntax_initialize() {
-    syntax_node * node;
-    node = (syntax_node *)malloc(sizeof(syntax_node));
+    syntax_node * node = syntax_allocate(1);
 
+    node->handler       = syntax_execute_value;
     node->nodetype      = SYNTAX_NULLT;
     node->evaluation    = SYNTAX_NULLB;
     node->instruction   = SYNTAX_NULLT;
+    node->slot          = SYNTAX_NULLS;
+    node->count         = 0;
     node->identifier    = SYNTAX_NULLV;
-    node->value         = SYNTAX_NULLV;
-    node->nodea         = SYNTAX_NULLV;
-    node->nodeb         = SYNTAX_NULLV;
-    node->nodec         = SYNTAX_NULLV;
+    node->value         = SYNTAX_NULLD;
+    node->function      = SYNTAX_NULLV;
+    node->nodea         = SYNTAX_NONE;
+    node->nodeb         = SYNTAX_NONE;
+    node->nodec         = SYNTAX_NONE;
+    node->list          = SYNTAX_NULLV;
 
     return node;
 }
@@ -49,7 +130,8 @@ syntax_node * syntax_initialize() {
 /**
  * Syntax Create Node creates an node of the type specified on nodetype, which
  * will define the content inside of info. Documentation regarding how the
- * nodes will be used are in the README file.
+ * nodes will be used are in the README file. The node starts at the line of
+ * nodea, the parser sets it for the ones that start with a token.
  * @param   nodetype    Type of this node.
  * @param   evaluation  Evaluation of this node.
  * @param   instruction Instruction of this node.
@@ -66,23 +148,28 @@ syntax_node * syntax_create_node(
     bool evaluation,
     char instruction,
     char * identifier,
-    data_value * value,
+    data_value value,
     syntax_node * nodea,
     syntax_node * nodeb,
     syntax_node * nodec
 ) {
-    syntax_node * node;
-    node = (syntax_node *)malloc(sizeof(syntax_node));
+    syntax_node * node = syntax_allocate(1);
 
+    node->handler       = syntax_resolve_handler(nodetype, instruction);
     node->nodetype      = nodetype;
     node->operation     = operation;
     node->evaluation    = evaluation;
     node->instruction   = instruction;
+    node->slot          = SYNTAX_NULLS;
+    node->count         = 0;
     node->identifier    = identifier;
     node->value         = value;
-    node->nodea         = nodea;
-    node->nodeb         = nodeb;
-    node->nodec         = nodec;
+    node->function      = SYNTAX_NULLV;
+    node->nodea         = syntax_locate(nodea);
+    node->nodeb         = syntax_locate(nodeb);
+    node->nodec         = syntax_locate(nodec);
+    node->list          = SYNTAX_NULLV;
+    if (nodea != NULL) SYNTAX_LINE(node) = SYNTAX_LINE(nodea);
 
     return node;
 }
@@ -107,17 +194,21 @@ syntax_node * syntax_create_expression(
         evaluation = data_zero(nodea->value);
     else evaluation = data_evaluation(nodea->value, nodeb->value, operation);
 
-    return syntax_create_node(
+    syntax_node * node;
+    node = syntax_create_node(
         SYNTAX_INSTRUCTION,
         operation,
         evaluation,
         SYNTAX_EXPRESSION,
         SYNTAX_NULLV,
-        SYNTAX_NULLV,
+        SYNTAX_NULLD,
         nodea,
         nodeb,
         nodec
     );
+    node->handler = syntax_resolve_kernel(
+        SYNTAX_EXPRESSION, operation, nodea->value.numtype);
+    return node;
 }
 
 /**
@@ -135,12 +226,12 @@ syntax_node * syntax_create_expr(
     syntax_node * nodeb,
     syntax_node * nodec
 ) {
-    data_value * value;
-    if (operation == DATA_NEGATIVE)
-        value = data_negative(nodea->value);
-    else value = data_operation(nodea->value, nodeb->value, operation);
+    // Only the type is known here, the value is computed when running.
+    data_value value = SYNTAX_NULLD;
+    value.numtype = nodea->value.numtype;
 
-    return syntax_create_node(
+    syntax_node * node;
+    node = syntax_create_node(
         SYNTAX_INSTRUCTION,
         operation,
         SYNTAX_NULLB,
@@ -151,6 +242,9 @@ syntax_node * syntax_create_expr(
         nodeb,
         nodec
     );
+    node->handler = syntax_resolve_kernel(
+        SYNTAX_EXPR, operation, nodea->value.numtype);
+    return node;
 }
 
 /**
@@ -168,10 +262,12 @@ syntax_node * syntax_create_term(
     syntax_node * nodeb,
     syntax_node * nodec
 ) {
-    data_value * value;
-    value = data_operation(nodea->value, nodeb->value, operation);
+    // Only the type is known here, the value is computed when running.
+    data_value value = SYNTAX_NULLD;
+    value.numtype = nodea->value.numtype;
 
-    return syntax_create_node(
+    syntax_node * node;
+    node = syntax_create_node(
         SYNTAX_INSTRUCTION,
         operation,
         SYNTAX_NULLB,
@@ -182,6 +278,9 @@ syntax_node * syntax_create_term(
         nodeb,
         nodec
     );
+    node->handler = syntax_resolve_kernel(
+        SYNTAX_TERM, operation, nodea->value.numtype);
+    return node;
 }
 
 /**
@@ -195,7 +294,7 @@ syntax_node * syntax_create_term(
 syntax_node * syntax_create_value(
     char nodetype,
     char * identifier,
-    data_value * value
+    data_value value
 ) {
     return syntax_create_node(
         nodetype,
@@ -211,18 +310,62 @@ syntax_node * syntax_create_value(
 }
 
 /**
- * Syntax Create Function is used for the creation of a function.
+ * Syntax Create Identifier is used for the creation of identifiers that are
+ * bound to the storage slot of the symbol table they read and write.
+ * @param   identifier  Identifier of the node.
+ * @param   slot        Storage slot of the identifier.
+ * @param   value       Value included.
+ * @return  Node created.
+ */
+syntax_node * syntax_create_identifier(
+    char * identifier,
+    int slot,
+    data_value value
+) {
+    syntax_node * node;
+    node = syntax_create_value(SYNTAX_IDENTIFIER, identifier, value);
+    node->slot = slot;
+    return node;
+}
+
+/**
+ * Syntax Create Local is used for the creation of parameters and locals of a
+ * function, which are bound to their offset in the frame of the call.
+ * @param   identifier  Identifier of the node.
+ * @param   offset      Frame offset of the identifier.
+ * @param   value       Value included.
+ * @return  Node created.
+ */
+syntax_node * syntax_create_local(
+    char * identifier,
+    int offset,
+    data_value value
+) {
+    syntax_node * node;
+    node = syntax_create_value(SYNTAX_LOCAL, identifier, value);
+    node->slot = offset;
+    return node;
+}
+
+/**
+ * Syntax Create Function is used for the creation of a function call, bound
+ * to the function it calls so that no lookup is done when running it.
  * @param   identifier  Identifier of the function.
+ * @param   slot        Storage slot of the function.
  * @param   value       Value of the function.
+ * @param   function    Function called.
  * @param   nodea       First node.
  * @return  Node created.
  */
 syntax_node * syntax_create_function(
     char * identifier,
-    data_value * value,
+    int slot,
+    data_value value,
+    symbol_function * function,
     syntax_node * nodea
 ) {
-    return syntax_create_node(
+    syntax_node * node;
+    node = syntax_create_node(
         SYNTAX_INSTRUCTION,
         SYNTAX_NULLT,
         SYNTAX_NULLB,
@@ -233,31 +376,56 @@ syntax_node * syntax_create_function(
         SYNTAX_NULLV,
         SYNTAX_NULLV
     );
+    node->slot = slot;
+    node->function = function;
+    return node;
 }
 
 /**
- * Basic Node Creation for the Instructions named below.
- * @param   nodea   First node.
- * @param   nodeb   Second node.
- * @param   nodec   Third node.
+ * Syntax Create Stmt creates a STMT, a list of statements that starts with
+ * the one given. The statements are kept in an array instead of a chain of
+ * nodes, so a list of any length is walked with a loop.
+ * @param   node    First statement, NULL for an empty list.
  * @return  Node created.
  */
-syntax_node * syntax_create_stmt(
-    syntax_node * nodea,
-    syntax_node * nodeb,
-    syntax_node * nodec
-) {
-    return syntax_create_node(
+syntax_node * syntax_create_stmt(syntax_node * node) {
+    syntax_node * list = syntax_create_node(
         SYNTAX_INSTRUCTION,
         SYNTAX_NULLT,
         SYNTAX_NULLB,
         SYNTAX_STMT,
         SYNTAX_NULLV,
+        SYNTAX_NULLD,
         SYNTAX_NULLV,
-        nodea,
-        nodeb,
-        nodec
+        SYNTAX_NULLV,
+        SYNTAX_NULLV
     );
+    return syntax_append_stmt(list, node);
+}
+
+/**
+ * Syntax Append Stmt adds a statement at the end of a STMT. The array is taken
+ * from the arena and doubles each time its size reaches a power of two, so
+ * the capacity needs no field and appending costs a constant on average.
+ * @param   list    STMT to add to.
+ * @param   node    Statement to add, nothing is added for NULL.
+ * @return  The STMT.
+ */
+syntax_node * syntax_append_stmt(syntax_node * list, syntax_node * node) {
+    if (node == NULL) return list;
+    if (list->count == 0) SYNTAX_LINE(list) = SYNTAX_LINE(node);
+
+    if ((list->count & (list->count - 1)) == 0) {
+        int capacity = list->count > 0 ? 2 * list->count : 1;
+        syntax_index * statements = (syntax_index *)arena_allocate(
+            global_arena, ARENA_LIST, capacity * sizeof(syntax_index));
+        if (list->count > 0)
+            memcpy(statements, list->list,
+                list->count * sizeof(syntax_index));
+        list->list = statements;
+    }
+    list->list[list->count ++] = syntax_locate(node);
+    return list;
 }
 
 /**
@@ -272,17 +440,21 @@ syntax_node * syntax_create_assign(
     syntax_node * nodeb,
     syntax_node * nodec
 ) {
-    return syntax_create_node(
+    syntax_node * node;
+    node = syntax_create_node(
         SYNTAX_INSTRUCTION,
         SYNTAX_NULLT,
         SYNTAX_NULLB,
         SYNTAX_ASSIGN,
         SYNTAX_NULLV,
-        SYNTAX_NULLV,
+        SYNTAX_NULLD,
         nodea,
         nodeb,
         nodec
     );
+    if (nodea->nodetype == SYNTAX_LOCAL)
+        node->handler = syntax_execute_assign_local;
+    return node;
 }
 
 /**
@@ -303,7 +475,7 @@ syntax_node * syntax_create_if(
         SYNTAX_NULLB,
         SYNTAX_IF,
         SYNTAX_NULLV,
-        SYNTAX_NULLV,
+        SYNTAX_NULLD,
         nodea,
         nodeb,
         nodec
@@ -328,7 +500,7 @@ syntax_node * syntax_create_ifelse(
         SYNTAX_NULLB,
         SYNTAX_IFELSE,
         SYNTAX_NULLV,
-        SYNTAX_NULLV,
+        SYNTAX_NULLD,
         nodea,
         nodeb,
         nodec
@@ -353,7 +525,7 @@ syntax_node * syntax_create_while(
         SYNTAX_NULLB,
         SYNTAX_WHILE,
         SYNTAX_NULLV,
-        SYNTAX_NULLV,
+        SYNTAX_NULLD,
         nodea,
         nodeb,
         nodec
@@ -378,7 +550,7 @@ syntax_node * syntax_create_read(
         SYNTAX_NULLB,
         SYNTAX_READ,
         SYNTAX_NULLV,
-        SYNTAX_NULLV,
+        SYNTAX_NULLD,
         nodea,
         nodeb,
         nodec
@@ -397,17 +569,21 @@ syntax_node * syntax_create_print(
     syntax_node * nodeb,
     syntax_node * nodec
 ) {
-    return syntax_create_node(
+    syntax_node * node;
+    node = syntax_create_node(
         SYNTAX_INSTRUCTION,
         SYNTAX_NULLT,
         SYNTAX_NULLB,
         SYNTAX_PRINT,
         SYNTAX_NULLV,
-        SYNTAX_NULLV,
+        SYNTAX_NULLD,
         nodea,
         nodeb,
         nodec
     );
+    node->handler = syntax_resolve_kernel(
+        SYNTAX_PRINT, SYNTAX_NULLT, nodea->value.numtype);
+    return node;
 }
 
 /**
@@ -428,7 +604,7 @@ syntax_node * syntax_create_return(
         SYNTAX_NULLB,
         SYNTAX_RETURN,
         SYNTAX_NULLV,
-        SYNTAX_NULLV,
+        SYNTAX_NULLD,
         nodea,
         nodeb,
         nodec
@@ -453,7 +629,7 @@ syntax_node * syntax_create_arg(
         SYNTAX_NULLB,
         SYNTAX_ARG,
         SYNTAX_NULLV,
-        SYNTAX_NULLV,
+        SYNTAX_NULLD,
         nodea,
         nodeb,
         nodec
@@ -469,7 +645,7 @@ syntax_node * syntax_create_arg(
  */
 bool syntax_check_types(syntax_node * one, syntax_node * two) {
     if (one == NULL || two == NULL) return false;
-    return one->value->numtype == two->value->numtype;
+    return one->value.numtype == two->value.numtype;
 }
 
 /**
@@ -486,23 +662,73 @@ void syntax_print_node(syntax_node * node) {
     printf("evaluation = %d\n", node->evaluation);
     printf("instruction = %c\n", node->instruction);
     printf("identifier = %s\n", node->identifier);
-    if (node->value != NULL) {
-        if (node->value->numtype == DATA_INTEGER) {
-            printf("numtype = %c\n", node->value->numtype);
-            printf("integer = %d\n", node->value->number.int_value);
+    if (node->value.numtype != SYNTAX_NULLT) {
+        if (node->value.numtype == DATA_INTEGER) {
+            printf("numtype = %c\n", node->value.numtype);
+            printf("integer = %d\n", node->value.number.int_value);
         } else {
-            printf("numtype = %c\n", node->value->numtype);
-            printf("floating = %f\n", node->value->number.float_value);
+            printf("numtype = %c\n", node->value.numtype);
+            printf("floating = %f\n", node->value.number.float_value);
         }
     }
-    if (node->value != NULL) printf("value = %c\n", node->value->numtype);
-    if (node->nodea != NULL) printf("nodea = %c\n", node->nodea->nodetype);
-    if (node->nodeb != NULL) printf("nodeb = %c\n", node->nodeb->nodetype);
-    if (node->nodec != NULL) printf("nodec = %c\n", node->nodec->nodetype);
+    if (node->value.numtype != SYNTAX_NULLT)
+        printf("value = %c\n", node->value.numtype);
+    if (node->nodea != SYNTAX_NONE)
+        printf("nodea = %c\n", SYNTAX_NODEA(node)->nodetype);
+    if (node->nodeb != SYNTAX_NONE)
+        printf("nodeb = %c\n", SYNTAX_NODEB(node)->nodetype);
+    if (node->nodec != SYNTAX_NONE)
+        printf("nodec = %c\n", SYNTAX_NODEC(node)->nodetype);
+    if (node->list != NULL) printf("count = %d\n", node->count);
+}
+
+/**
+ * Syntax Prepare readies the calling thread to run a program, with the storage
+ * of its table and an empty call stack.
+ * @param   table   Symbol table of the program.
+ */
+void syntax_prepare(symbol_table * table) {
+    global_table = table;
+    global_value = NULL;
+    global_frame = global_stack;
+    global_top = global_stack;
+    global_memo_hits = 0;
+    global_memo_misses = 0;
+}
+
+/**
+ * Syntax Recover sets where the runtime errors of the calling thread go, so
+ * that a program that fails ends alone instead of the whole process, such as
+ * a batch job.
+ * @param   recover Point to unwind to, NULL to exit on an error.
+ * @param   errors  Where to print the errors, used along with recover.
+ */
+void syntax_recover(jmp_buf * recover, FILE * errors) {
+    global_recover = recover;
+    global_errors = errors;
+}
+
+/**
+ * Syntax Fail ends the program being run with a runtime error. Without a
+ * recovery point it is printed and the process exits, otherwise the prints
+ * so far are flushed, it is printed after them and the thread unwinds to the
+ * point.
+ * @param   error   Error to print.
+ */
+_Noreturn void syntax_fail(char * error) {
+    if (global_recover == NULL) {
+        printf("%s\n", error);
+        exit(EXIT_FAILURE);
+    }
+    stream_flush();
+    fprintf(global_errors, "%s\n", error);
+    longjmp(*global_recover, 1);
 }
 
 /**
- * Interpretation of the Node. It decides what to do depending on the nodetype.
+ * Interpretation of the Node. The node runs its own handler, so there is a
+ * single indirect call per node instead of a switch on the nodetype and
+ * another one on the instruction.
  * @param   node    Node to run.
  */
 void syntax_execute_nodetype(syntax_node * node) {
@@ -510,85 +736,475 @@ void syntax_execute_nodetype(syntax_node * node) {
     // syntax_print_node(node);
     if (node == NULL) return;
 
-    // Decide what to do depending on the type of node.
-    switch (node->nodetype) {
-        case SYNTAX_INSTRUCTION:
-            syntax_execute_instruction(node);
-            break;
-        case SYNTAX_IDENTIFIER:
-            syntax_operate_identifier(node);
-            break;
-        case SYNTAX_VALUE:
-            break;
-        default:
-            break;
-    }
+    node->handler(node);
 }
 
 /**
- * Interpretation of the Instruction. It decides what to do depending on the
- * instruction value.
- * @param   node    Node to run.
+ * Syntax Resolve Handler decides what to do depending on the nodetype, and on
+ * the instruction value for instructions. It is called once per node while
+ * the tree is built.
+ * @param   nodetype    Type of the node.
+ * @param   instruction Instruction of the node.
+ * @return  Handler that runs the node.
  */
-void syntax_execute_instruction(syntax_node * node) {
-    // Check if the node is null.
-    if (node == NULL) return;
+syntax_handler syntax_resolve_handler(char nodetype, char instruction) {
+    // Decide what to do depending on the type of node.
+    if (nodetype == SYNTAX_IDENTIFIER) return syntax_operate_identifier;
+    if (nodetype == SYNTAX_LOCAL) return syntax_operate_local;
+    if (nodetype != SYNTAX_INSTRUCTION) return syntax_execute_value;
 
     // Decide what to do depending on the instruction of the node.
-    switch (node->instruction) {
+    switch (instruction) {
         case SYNTAX_STMT:
-            syntax_execute_stmt(node);
-            break;
+            return syntax_execute_stmt;
         case SYNTAX_ASSIGN:
-            syntax_execute_assign(node);
-            break;
+            return syntax_execute_assign;
         case SYNTAX_IF:
-            syntax_execute_if(node);
-            break;
+            return syntax_execute_if;
         case SYNTAX_IFELSE:
-            syntax_execute_ifelse(node);
-            break;
+            return syntax_execute_ifelse;
         case SYNTAX_WHILE:
-            syntax_execute_while(node);
-            break;
+            return syntax_execute_while;
         case SYNTAX_READ:
-            syntax_execute_read(node);
-            break;
+            return syntax_execute_read;
         case SYNTAX_PRINT:
-            syntax_execute_print(node);
-            break;
+            return syntax_execute_print;
         case SYNTAX_EXPRESSION:
-            syntax_evaluate_expression(node);
-            break;
+            return syntax_evaluate_expression;
         case SYNTAX_EXPR:
-            syntax_operate_expr(node);
-            break;
+            return syntax_operate_expr;
         case SYNTAX_TERM:
-            syntax_operate_term(node);
-            break;
+            return syntax_operate_term;
         case SYNTAX_FUNCTION:
-            syntax_execute_function(node);
-            break;
+            return syntax_execute_function;
         case SYNTAX_RETURN:
-            syntax_execute_return(node);
-            break;
+            return syntax_execute_return;
+        default:
+            return syntax_execute_value;
+    }
+}
+
+/**
+ * Syntax Resolve Kernel chooses the handler of an operation whose operand
+ * types were checked while parsing, so it can skip the checks on the nodes
+ * and the numtype. Unknown types keep the generic handler of the instruction.
+ * @param   instruction Instruction of the node, EXPRESSION EXPR TERM or PRINT.
+ * @param   operation   Operation of the node.
+ * @param   numtype     Type of the operands.
+ * @return  Handler that runs the node.
+ */
+syntax_handler syntax_resolve_kernel(
+    char instruction,
+    char operation,
+    char numtype
+) {
+    bool integer = numtype == DATA_INTEGER;
+    if (numtype != DATA_INTEGER && numtype != DATA_FLOAT)
+        return syntax_resolve_handler(SYNTAX_INSTRUCTION, instruction);
+
+    // Decide depending on the instruction, the operation and then the type.
+    if (instruction == SYNTAX_PRINT)
+        return integer ? syntax_print_integer : syntax_print_float;
+    switch (operation) {
+        case DATA_SUM:
+            return integer ? syntax_operate_addi : syntax_operate_addf;
+        case DATA_SUBSTRACT:
+            return integer ? syntax_operate_subi : syntax_operate_subf;
+        case DATA_NEGATIVE:
+            return integer ? syntax_operate_negi : syntax_operate_negf;
+        case DATA_MULTIPLY:
+            return integer ? syntax_operate_muli : syntax_operate_mulf;
+        case DATA_DIVIDE:
+            return integer ? syntax_operate_divi : syntax_operate_divf;
+        case DATA_LESS:
+            return integer ? syntax_evaluate_lessi : syntax_evaluate_lessf;
+        case DATA_GREATER:
+            return integer
+                ? syntax_evaluate_greateri : syntax_evaluate_greaterf;
+        case DATA_EQUALS:
+            return integer ? syntax_evaluate_equalsi : syntax_evaluate_equalsf;
+        case DATA_LTE:
+            return integer ? syntax_evaluate_ltei : syntax_evaluate_ltef;
+        case DATA_GTE:
+            return integer ? syntax_evaluate_gtei : syntax_evaluate_gtef;
+        case DATA_ZERO:
+            return integer ? syntax_evaluate_zeroi : syntax_evaluate_zerof;
         default:
-            break;
+            return syntax_resolve_handler(SYNTAX_INSTRUCTION, instruction);
     }
 }
 
+// Kernels. Each one runs an operation on a single type, EXPRESSION EXPR TERM
+// or PRINT, chosen by syntax_resolve_kernel. The parser rejects operands of
+// different types, so the kernels read the number of their children without
+// checking the nodes or their numtype.
+
+/**
+ * Expr kernel for the sum of integers. The value of the left operand is kept
+ * aside, like in every other binary kernel, because a recursive call in the
+ * right one runs the same nodes.
+ * @param   node    Node to run.
+ */
+void syntax_operate_addi(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->value.number.int_value =
+        left.number.int_value + nodeb->value.number.int_value;
+}
+
+/**
+ * Expr kernel for the sum of floats.
+ * @param   node    Node to run.
+ */
+void syntax_operate_addf(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->value.number.float_value =
+        left.number.float_value + nodeb->value.number.float_value;
+}
+
+/**
+ * Expr kernel for the substraction of integers.
+ * @param   node    Node to run.
+ */
+void syntax_operate_subi(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->value.number.int_value =
+        left.number.int_value - nodeb->value.number.int_value;
+}
+
 /**
- * Interpretation of the stmt. The stmt will run the conents in nodea, and then
- * run the contents in nodeb.
+ * Expr kernel for the substraction of floats.
+ * @param   node    Node to run.
+ */
+void syntax_operate_subf(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->value.number.float_value =
+        left.number.float_value - nodeb->value.number.float_value;
+}
+
+/**
+ * Expr kernel for the negative of integers.
+ * @param   node    Node to run.
+ */
+void syntax_operate_negi(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    SYNTAX_RUN(nodea);
+    node->value.number.int_value = -nodea->value.number.int_value;
+}
+
+/**
+ * Expr kernel for the negative of floats.
+ * @param   node    Node to run.
+ */
+void syntax_operate_negf(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    SYNTAX_RUN(nodea);
+    node->value.number.float_value =
+        -nodea->value.number.float_value;
+}
+
+/**
+ * Term kernel for the multiplication of integers.
+ * @param   node    Node to run.
+ */
+void syntax_operate_muli(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->value.number.int_value =
+        left.number.int_value * nodeb->value.number.int_value;
+}
+
+/**
+ * Term kernel for the multiplication of floats.
+ * @param   node    Node to run.
+ */
+void syntax_operate_mulf(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->value.number.float_value =
+        left.number.float_value * nodeb->value.number.float_value;
+}
+
+/**
+ * Term kernel for the division of integers.
+ * @param   node    Node to run.
+ */
+void syntax_operate_divi(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->value.number.int_value =
+        left.number.int_value / nodeb->value.number.int_value;
+}
+
+/**
+ * Term kernel for the division of floats.
+ * @param   node    Node to run.
+ */
+void syntax_operate_divf(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->value.number.float_value =
+        left.number.float_value / nodeb->value.number.float_value;
+}
+
+/**
+ * Expression kernel for integers, less.
+ * @param   node    Node to run.
+ */
+void syntax_evaluate_lessi(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->evaluation =
+        left.number.int_value < nodeb->value.number.int_value;
+}
+
+/**
+ * Expression kernel for floats, less.
+ * @param   node    Node to run.
+ */
+void syntax_evaluate_lessf(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->evaluation =
+        left.number.float_value < nodeb->value.number.float_value;
+}
+
+/**
+ * Expression kernel for integers, greater.
+ * @param   node    Node to run.
+ */
+void syntax_evaluate_greateri(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->evaluation =
+        left.number.int_value > nodeb->value.number.int_value;
+}
+
+/**
+ * Expression kernel for floats, greater.
+ * @param   node    Node to run.
+ */
+void syntax_evaluate_greaterf(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->evaluation =
+        left.number.float_value > nodeb->value.number.float_value;
+}
+
+/**
+ * Expression kernel for integers, equals.
+ * @param   node    Node to run.
+ */
+void syntax_evaluate_equalsi(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->evaluation =
+        left.number.int_value == nodeb->value.number.int_value;
+}
+
+/**
+ * Expression kernel for floats, equals.
+ * @param   node    Node to run.
+ */
+void syntax_evaluate_equalsf(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->evaluation =
+        left.number.float_value == nodeb->value.number.float_value;
+}
+
+/**
+ * Expression kernel for integers, less or equal.
+ * @param   node    Node to run.
+ */
+void syntax_evaluate_ltei(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->evaluation =
+        left.number.int_value <= nodeb->value.number.int_value;
+}
+
+/**
+ * Expression kernel for floats, less or equal.
+ * @param   node    Node to run.
+ */
+void syntax_evaluate_ltef(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->evaluation =
+        left.number.float_value <= nodeb->value.number.float_value;
+}
+
+/**
+ * Expression kernel for integers, greater or equal.
+ * @param   node    Node to run.
+ */
+void syntax_evaluate_gtei(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->evaluation =
+        left.number.int_value >= nodeb->value.number.int_value;
+}
+
+/**
+ * Expression kernel for floats, greater or equal.
+ * @param   node    Node to run.
+ */
+void syntax_evaluate_gtef(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodea);
+    data_value left = nodea->value;
+    SYNTAX_RUN(nodeb);
+    node->evaluation =
+        left.number.float_value >= nodeb->value.number.float_value;
+}
+
+/**
+ * Expression kernel for an integer compared against zero.
+ * @param   node    Node to run.
+ */
+void syntax_evaluate_zeroi(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    SYNTAX_RUN(nodea);
+    node->evaluation = nodea->value.number.int_value != 0;
+}
+
+/**
+ * Expression kernel for a float compared against zero.
+ * @param   node    Node to run.
+ */
+void syntax_evaluate_zerof(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    SYNTAX_RUN(nodea);
+    node->evaluation = nodea->value.number.float_value != 0;
+}
+
+/**
+ * Print kernel for integers.
+ * @param   node    Node to run.
+ */
+void syntax_print_integer(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    SYNTAX_RUN(nodea);
+    stream_print_integer(nodea->value.number.int_value);
+}
+
+/**
+ * Print kernel for floats.
+ * @param   node    Node to run.
+ */
+void syntax_print_float(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    SYNTAX_RUN(nodea);
+    stream_print_float(nodea->value.number.float_value);
+}
+
+/**
+ * Interpretation of values and empty nodes. There is nothing to do, the value
+ * was stored in the node while parsing.
+ * @param   node    Node to run.
+ */
+void syntax_execute_value(syntax_node * node) {
+    (void)node;
+}
+
+/**
+ * Interpretation of the stmt. The stmt will run its statements in order,
+ * until one of them returned.
  * @param   node    Node to run.
  */
 void syntax_execute_stmt(syntax_node * node) {
     // Check if the node is null.
     if (node == NULL) return;
 
-    // Run contents in nodea and nodeb.
-    syntax_execute_nodetype(node->nodea);
-    syntax_execute_nodetype(node->nodeb);
+    // Run the statements in order with a loop, so the C stack does not grow
+    // with the length of the list. The pool never moves while running.
+    int i;
+    syntax_node * nodes = global_nodes;
+    for (i=0; i<node->count; i++) {
+        syntax_node * statement = &nodes[node->list[i]];
+        SYNTAX_RUN(statement);
+        if (global_value != NULL) return;
+    }
 }
 
 /**
@@ -601,31 +1217,37 @@ void syntax_execute_assign(syntax_node * node) {
     if (node == NULL) return;
 
     // Check if the nodes are null.
-    if (node->nodea == NULL) {
-        printf("Assign: The nodea is empty.\n");
-        exit(EXIT_FAILURE);
-    } else if (node->nodeb == NULL) {
-        printf("Assign: The nodeb is empty.\n");
-        exit(EXIT_FAILURE);
+    if (node->nodea == SYNTAX_NONE) {
+        syntax_fail("Assign: The nodea is empty.");
+    } else if (node->nodeb == SYNTAX_NONE) {
+        syntax_fail("Assign: The nodeb is empty.");
     }
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
 
     // Update nodes.
-    syntax_execute_nodetype(node->nodea);
-    syntax_execute_nodetype(node->nodeb);
-
-    // Get the value of the nodes.
-    data_value * nodea_value = node->nodea->value;
-    data_value * nodeb_value = node->nodeb->value;
+    SYNTAX_RUN(nodeb);
 
-    // Type check the values.
-    if (nodea_value->numtype != nodeb_value->numtype) {
-        printf("Assign: The nodea and nodeb differ in types.\n");
-        exit(EXIT_FAILURE);
-    }
+    // Assign the value in nodeb to nodea, the types were checked while parsing.
+    data_value nodeb_value = nodeb->value;
+    nodea->value = nodeb_value;
+    global_table->values[nodea->slot] = nodeb_value;
+}
 
-    // Assign the value in nodeb to nodea.
-    nodea_value->number = nodeb_value->number;
-    symbol_assign(global_table, node->nodea->identifier, nodeb_value);
+/**
+ * Interpretation of the assign to a parameter or local, which is stored in
+ * the frame of the current call instead of the symbol table.
+ * @param   node    Node to run.
+ */
+void syntax_execute_assign_local(syntax_node * node) {
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+    SYNTAX_RUN(nodeb);
+    data_value nodeb_value = nodeb->value;
+    nodea->value = nodeb_value;
+    global_frame[nodea->slot] = nodeb_value;
 }
 
 /**
@@ -638,22 +1260,25 @@ void syntax_execute_if(syntax_node * node) {
     if (node == NULL) return;
 
     // Check if the children nodes are null.
-    if (node->nodea == NULL) {
-        printf("If: The nodea is empty.\n");
-        exit(EXIT_FAILURE);
-    } else if (node->nodeb == NULL) {
-        printf("If: The nodeb is empty.\n");
-        exit(EXIT_FAILURE);
+    if (node->nodea == SYNTAX_NONE) {
+        syntax_fail("If: The nodea is empty.");
+    } else if (node->nodeb == SYNTAX_NONE) {
+        syntax_fail("If: The nodeb is empty.");
     }
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
 
     // Update nodes.
-    syntax_execute_nodetype(node->nodea);
+    SYNTAX_RUN(nodea);
 
     // Get the evaluation of the node.
-    node->evaluation = node->nodea->evaluation;
+    node->evaluation = nodea->evaluation;
 
     // Execute nodeb is the evaluation was true.
-    if (node->evaluation) syntax_execute_nodetype(node->nodeb);
+    if (node->evaluation) {
+        syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
+        SYNTAX_RUN(nodeb);
+    }
 }
 
 /**
@@ -666,26 +1291,23 @@ void syntax_execute_ifelse(syntax_node * node) {
     if (node == NULL) return;
 
     // Check if the children nodes are null.
-    if (node->nodea == NULL) {
-        printf("IfElse: The nodea is empty.\n");
-        exit(EXIT_FAILURE);
-    } else if (node->nodeb == NULL) {
-        printf("IfElse: The nodeb is empty.\n");
-        exit(EXIT_FAILURE);
-    } else if (node->nodec == NULL) {
-        printf("IfElse: The nodec is empty.\n");
-        exit(EXIT_FAILURE);
+    if (node->nodea == SYNTAX_NONE) {
+        syntax_fail("IfElse: The nodea is empty.");
+    } else if (node->nodeb == SYNTAX_NONE) {
+        syntax_fail("IfElse: The nodeb is empty.");
+    } else if (node->nodec == SYNTAX_NONE) {
+        syntax_fail("IfElse: The nodec is empty.");
     }
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
 
     // Update nodes.
-    syntax_execute_nodetype(node->nodea);
-
-    // Get the evaluation of the node.
-    bool evaluation = node->nodea->evaluation;
+    SYNTAX_RUN(nodea);
 
     // Execute nodeb is the evaluation was true. nodec otherwise
-    if (evaluation) syntax_execute_nodetype(node->nodeb);
-    else syntax_execute_nodetype(node->nodec);
+    syntax_node * branch = nodea->evaluation
+        ? SYNTAX_CHILDB(nodes, node) : SYNTAX_CHILDC(nodes, node);
+    SYNTAX_RUN(branch);
 }
 
 /**
@@ -698,30 +1320,32 @@ void syntax_execute_while(syntax_node * node) {
     if (node == NULL) return;
 
     // Check if the children nodes are null.
-    if (node->nodea == NULL) {
-        printf("While: The nodea is empty.\n");
-        exit(EXIT_FAILURE);
-    } else if (node->nodeb == NULL) {
-        printf("While: The nodeb is empty.\n");
-        exit(EXIT_FAILURE);
+    if (node->nodea == SYNTAX_NONE) {
+        syntax_fail("While: The nodea is empty.");
+    } else if (node->nodeb == SYNTAX_NONE) {
+        syntax_fail("While: The nodeb is empty.");
     }
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+    syntax_node * nodeb = SYNTAX_CHILDB(nodes, node);
 
     // Update nodes.
-    syntax_execute_nodetype(node->nodea);
+    SYNTAX_RUN(nodea);
 
     // Get the evaluation of the node.
-    bool evaluation = node->nodea->evaluation;
+    bool evaluation = nodea->evaluation;
 
     while (evaluation) {
-        syntax_execute_nodetype(node->nodeb);
-        syntax_execute_nodetype(node->nodea);
-        evaluation = node->nodea->evaluation;
+        SYNTAX_RUN(nodeb);
+        if (global_value != NULL) return;
+        SYNTAX_RUN(nodea);
+        evaluation = nodea->evaluation;
     }
 }
 
 /**
- * Interpretation of read. The read will scanf depending on the type of nodea
- * and then assign a new value to nodea's value from the console.
+ * Interpretation of read. The read will take a number of the stream depending
+ * on the type of nodea and then assign it to nodea's value.
  * @param   node    Node to run.
  */
 void syntax_execute_read(syntax_node * node) {
@@ -729,33 +1353,28 @@ void syntax_execute_read(syntax_node * node) {
     if (node == NULL) return;
 
     // Check if the children nodes are null.
-    if (node->nodea == NULL) {
-        printf("Read: The nodea is empty.\n");
-        exit(EXIT_FAILURE);
+    if (node->nodea == SYNTAX_NONE) {
+        syntax_fail("Read: The nodea is empty.");
     }
 
     // Get the data of the node.
-    char * nodea_identifier = node->nodea->identifier;
-    data_value * nodea_value = node->nodea->value;
+    char * nodea_identifier = SYNTAX_NODEA(node)->identifier;
+    data_value * nodea_value = &SYNTAX_NODEA(node)->value;
     char numtype = nodea_value->numtype;
 
     // Decide how to scan.
-    if (numtype == DATA_INTEGER) {
-        int input;
-        printf("\nEnter an integer for the identifier %s : ", nodea_identifier);
-        scanf("%d", &input);
-        nodea_value->number.int_value = input;
-        symbol_assign(global_table, node->nodea->identifier, node->nodea->value);
-    } else if (numtype == DATA_FLOAT) {
-        float input;
-        printf("\nEnter a float for the identifier %s :", nodea_identifier);
-        scanf("%f", &input);
-        nodea_value->number.float_value = input;
-        symbol_assign(global_table, node->nodea->identifier, node->nodea->value);
-    } else {
-        printf("Read: The nodea is of type unknown.\n");
-        exit(EXIT_FAILURE);
+    if (numtype == DATA_INTEGER)
+        nodea_value->number.int_value = stream_read_integer(nodea_identifier);
+    else if (numtype == DATA_FLOAT)
+        nodea_value->number.float_value = stream_read_float(nodea_identifier);
+    else {
+        syntax_fail("Read: The nodea is of type unknown.");
     }
+
+    // Store the value in the frame for locals, in the table otherwise.
+    if (SYNTAX_NODEA(node)->nodetype == SYNTAX_LOCAL)
+        global_frame[SYNTAX_NODEA(node)->slot] = *nodea_value;
+    else global_table->values[SYNTAX_NODEA(node)->slot] = *nodea_value;
 }
 
 /**
@@ -768,23 +1387,26 @@ void syntax_execute_print(syntax_node * node) {
     if (node == NULL) return;
 
     // Check if the children nodes are null.
-    if (node->nodea == NULL) {
-        printf("Print: The nodea is empty.\n");
-        exit(EXIT_FAILURE);
+    if (node->nodea == SYNTAX_NONE) {
+        syntax_fail("Print: The nodea is empty.");
     }
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+
+    // Update nodes.
+    SYNTAX_RUN(nodea);
 
     // Get the data of the node.
-    data_value * nodea_value = node->nodea->value;
-    char numtype = nodea_value->numtype;
+    data_value nodea_value = nodea->value;
+    char numtype = nodea_value.numtype;
 
     // Decide how to scan.
     if (numtype == DATA_INTEGER)
-        printf("\nThe value is %d\n", nodea_value->number.int_value);
+        stream_print_integer(nodea_value.number.int_value);
     else if (numtype == DATA_FLOAT)
-        printf("\nThe value is %f\n", nodea_value->number.float_value);
+        stream_print_float(nodea_value.number.float_value);
     else {
-        printf("Print: The nodea is of type unknown.\n");
-        exit(EXIT_FAILURE);
+        syntax_fail("Print: The nodea is of type unknown.");
     }
 }
 
@@ -800,32 +1422,31 @@ void syntax_evaluate_expression(syntax_node * node) {
     // Decide what to do depending on the operation.
     if (node->operation == DATA_ZERO) {
         // Check if the children nodes are null.
-        if (node->nodea == NULL) {
-            printf("Expression: The nodea is empty.\n");
-            exit(EXIT_FAILURE);
+        if (node->nodea == SYNTAX_NONE) {
+            syntax_fail("Expression: The nodea is empty.");
         }
 
         // Update nodes.
-        syntax_execute_nodetype(node->nodea);
+        syntax_execute_nodetype(SYNTAX_NODEA(node));
 
         // Evaluate to zero.
-        node->evaluation = !data_zero(node->nodea->value);
+        node->evaluation = !data_zero(SYNTAX_NODEA(node)->value);
     } else {
         // Check if the children nodes are null.
-        if (node->nodea == NULL) {
-            printf("Expression: The nodea is empty.\n");
-            exit(EXIT_FAILURE);
-        } else if (node->nodeb == NULL) {
-            printf("Expression: The nodeb is empty.\n");
-            exit(EXIT_FAILURE);
+        if (node->nodea == SYNTAX_NONE) {
+            syntax_fail("Expression: The nodea is empty.");
+        } else if (node->nodeb == SYNTAX_NONE) {
+            syntax_fail("Expression: The nodeb is empty.");
         }
 
         // Update nodes.
-        syntax_execute_nodetype(node->nodea);
-        syntax_execute_nodetype(node->nodeb);
+        syntax_execute_nodetype(SYNTAX_NODEA(node));
+        data_value left = SYNTAX_NODEA(node)->value;
+        syntax_execute_nodetype(SYNTAX_NODEB(node));
 
         // Evaluate to whichever found.
-        node->evaluation = data_evaluation(node->nodea->value, node->nodeb->value, node->operation);
+        node->evaluation = data_evaluation(
+            left, SYNTAX_NODEB(node)->value, node->operation);
     }
 }
 
@@ -841,32 +1462,31 @@ void syntax_operate_expr(syntax_node * node) {
     // Decide what to do depending on the operation.
     if (node->operation == DATA_NEGATIVE) {
         // Check if the children nodes are null.
-        if (node->nodea == NULL) {
-            printf("Expr: The nodea is empty.\n");
-            exit(EXIT_FAILURE);
+        if (node->nodea == SYNTAX_NONE) {
+            syntax_fail("Expr: The nodea is empty.");
         }
 
         // Update nodes.
-        syntax_execute_nodetype(node->nodea);
+        syntax_execute_nodetype(SYNTAX_NODEA(node));
 
         // Update the value with its negative.
-        node->value = data_negative(node->nodea->value);
+        node->value = data_negative(SYNTAX_NODEA(node)->value);
     } else {
         // Check if the children are null.
-        if (node->nodea == NULL) {
-            printf("Expr: The nodea is empty.\n");
-            exit(EXIT_FAILURE);
-        } else if (node->nodeb == NULL) {
-            printf("Expr: The nodeb is empty.\n");
-            exit(EXIT_FAILURE);
+        if (node->nodea == SYNTAX_NONE) {
+            syntax_fail("Expr: The nodea is empty.");
+        } else if (node->nodeb == SYNTAX_NONE) {
+            syntax_fail("Expr: The nodeb is empty.");
         }
 
         // Update nodes.
-        syntax_execute_nodetype(node->nodea);
-        syntax_execute_nodetype(node->nodeb);
+        syntax_execute_nodetype(SYNTAX_NODEA(node));
+        data_value left = SYNTAX_NODEA(node)->value;
+        syntax_execute_nodetype(SYNTAX_NODEB(node));
 
         // Operate the contents.
-        node->value = data_operation(node->nodea->value, node->nodeb->value, node->operation);
+        node->value = data_operation(
+            left, SYNTAX_NODEB(node)->value, node->operation);
     }
 }
 
@@ -880,25 +1500,25 @@ void syntax_operate_term(syntax_node * node) {
     if (node == NULL) return;
 
     // Check if the children are null.
-    if (node->nodea == NULL) {
-        printf("Term: The nodea is empty.\n");
-        exit(EXIT_FAILURE);
-    } else if (node->nodeb == NULL) {
-        printf("Term: The nodeb is empty.\n");
-        exit(EXIT_FAILURE);
+    if (node->nodea == SYNTAX_NONE) {
+        syntax_fail("Term: The nodea is empty.");
+    } else if (node->nodeb == SYNTAX_NONE) {
+        syntax_fail("Term: The nodeb is empty.");
     }
 
     // Update nodes.
-    syntax_execute_nodetype(node->nodea);
-    syntax_execute_nodetype(node->nodeb);
+    syntax_execute_nodetype(SYNTAX_NODEA(node));
+    data_value left = SYNTAX_NODEA(node)->value;
+    syntax_execute_nodetype(SYNTAX_NODEB(node));
 
     // Operate the contents.
-    node->value = data_operation(node->nodea->value, node->nodeb->value, node->operation);
+    node->value = data_operation(
+        left, SYNTAX_NODEB(node)->value, node->operation);
 }
 
 /**
- * Interpretation of return. While not a good practice, the return updates
- * a global data_value object that is used for all functions.
+ * Interpretation of return. The return updates a global pointer to its own
+ * value, which stops the statements of the function until the call reads it.
  * @param   node    Node to run
  */
 void syntax_execute_return(syntax_node * node) {
@@ -906,86 +1526,169 @@ void syntax_execute_return(syntax_node * node) {
     if (node == NULL) return;
 
     // Check if the children are null.
-    if (node->nodea == NULL) {
-        printf("Return: The nodea is empty.\n");
-        exit(EXIT_FAILURE);
+    if (node->nodea == SYNTAX_NONE) {
+        syntax_fail("Return: The nodea is empty.");
     }
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
 
     // Update nodes.
-    syntax_execute_nodetype(node->nodea);
+    SYNTAX_RUN(nodea);
 
     // Operate the contents.
-    node->value = node->nodea->value;
-    global_value = node->nodea->value;
+    node->value = nodea->value;
+    global_value = &node->value;
 }
 
 /**
- * Interpretation of function. It updates the table as it runs through the
- * param_list, and then executes the nodes inside of it. Finally, it updates
- * the value so that it can be used like an identifier or a value.
+ * Interpretation of function. It pushes a frame on the call stack with the
+ * arguments at the offsets of the parameters and the locals at zero, and then
+ * executes the nodes inside of it. Finally, it pops the frame and updates
+ * the value so that it can be used like an identifier or a value. A memoized
+ * function that was already called with the same arguments takes the result
+ * from its memo instead of running.
  * @param   node    Node to run
  */
 void syntax_execute_function(syntax_node * node) {
+    int i;
+    param_list * param;
+    data_value * key = NULL;
+    data_value * entry = NULL;
+
     // Check if the node is null.
     if (node == NULL) return;
 
-    // Check if the children are null.
-    if (node->nodea == NULL) {
-        printf("Function: The nodea is empty.\n");
-        exit(EXIT_FAILURE);
+    // Push the frame, the arguments are evaluated in the frame of the caller.
+    // A memoized call keeps its arguments right above the frame, on the call
+    // stack instead of the one of C, whose frames every nested call adds up.
+    symbol_function * function = node->function;
+    data_value * frame = global_top;
+    int size = function->size + (function->memoize ? function->args : 0);
+    if (frame + size > global_stack + SYNTAX_STACK) {
+        syntax_fail("Function: The call stack is full.");
+    }
+    global_top = frame + size;
+    syntax_update_args(SYNTAX_NODEA(node), function->list, frame);
+
+    // Look for the arguments in the memo, the body may change its parameters
+    // so they are kept aside until the result is stored.
+    if (function->memoize) {
+        if (syntax_memo_find(function, frame, &entry)) {
+            global_memo_hits ++;
+            global_top = frame;
+            node->value = entry[0];
+            global_table->values[node->slot] = node->value;
+            return;
+        }
+        global_memo_misses ++;
+        key = frame + function->size;
+        for (i=0, param = function->list; param != NULL;
+            i++, param = param->next)
+            key[i] = frame[param->offset];
     }
 
-    // Update params.
-    syntax_node * function_node;
-    param_list * function_list;
-    function_node = symbol_get_node(global_table, node->identifier);
-    function_list = symbol_get_list(global_table, node->identifier);
-    syntax_update_args(node->nodea, function_list);
+    param_list * local;
+    for (local = function->locals; local != NULL; local = local->next)
+        frame[local->offset] = local->value;
 
     // Execute nodes.
-    syntax_execute_nodetype(function_node);
+    data_value * caller = global_frame;
+    global_frame = frame;
+    syntax_execute_nodetype(function->node);
+    global_frame = caller;
+    global_top = frame;
+
+    // Update the contents, functions that do not return give zero.
+    if (global_value != NULL) node->value = *global_value;
+    else node->value = function->value;
+    global_value = NULL;
+    global_table->values[node->slot] = node->value;
+
+    // Store the result, calls inside may have used the same entry meanwhile.
+    if (entry != NULL) {
+        entry[0] = node->value;
+        for (i=0; i<function->args; i++) entry[i + 1] = key[i];
+    }
+}
 
-    // Update the contents.
-    if (global_value != NULL) node->value = global_value;
-    symbol_assign(global_table, node->identifier, node->value);
+/**
+ * Syntax Memo Find looks for the arguments of a call in the memo of its
+ * function, which is taken from the arena on the first call. The arguments
+ * hash to a single entry, which holds the last result stored there first and
+ * then the arguments it was given for.
+ * @param   function    Function called, with memoize set.
+ * @param   frame       Frame of the call, with the arguments.
+ * @param   entry       Where to store the entry of the arguments.
+ * @return  True if the entry has the result for these arguments.
+ */
+bool syntax_memo_find(
+    symbol_function * function, data_value * frame, data_value ** entry
+) {
+    int i;
+    param_list * param;
+    int width = function->args + 1;
+    if (function->memo == NULL)
+        function->memo = (data_value *)arena_allocate(global_arena,
+            ARENA_FUNCTION, SYNTAX_MEMO_SIZE * width * sizeof(data_value));
+
+    // Hash the bits of the arguments with the 32 bit FNV-1a.
+    unsigned int hash = 2166136261u;
+    for (param = function->list; param != NULL; param = param->next)
+        hash = (hash ^ (unsigned int)frame[param->offset].number.int_value)
+            * 16777619u;
+    hash ^= hash >> 16;
+    *entry = function->memo + (hash & (SYNTAX_MEMO_SIZE - 1)) * width;
+
+    // An empty entry has no type, floats are compared by their bits.
+    if ((*entry)[0].numtype == SYNTAX_NULLT) return false;
+    for (i=1, param = function->list; param != NULL; i++, param = param->next)
+        if ((*entry)[i].numtype != frame[param->offset].numtype
+            || (*entry)[i].number.int_value
+                != frame[param->offset].number.int_value) return false;
+    return true;
 }
 
 /**
  * Interpretation of the argument nodes. It is an auxiliar for function that
- * updates the values inside of the symbol table in real time for the function
- * to use them.
+ * stores the value of each argument in the new frame at the offset of its
+ * parameter.
  * @param   node    Node to run
  * @param   list    List of the parameters used.
+ * @param   frame   Frame of the call.
  */
-void syntax_update_args(syntax_node * node, param_list * list) {
+void syntax_update_args(
+    syntax_node * node, param_list * list, data_value * frame
+) {
     // Check if the node is null.
     if (node == NULL) return;
 
     // Check if the children are null.
-    if (node->nodea == NULL) {
-        printf("Args: The nodea is empty.\n");
-        exit(EXIT_FAILURE);
+    if (node->nodea == SYNTAX_NONE) {
+        syntax_fail("Args: The nodea is empty.");
     }
     
     // Check if the list is null.
     if (list == NULL) {
-        printf("Args: The list is empty. This means there are not enough parameters inserted.\n");
-        exit(EXIT_FAILURE);
+        syntax_fail("Args: The list is empty. This means there are not enough "
+            "parameters inserted.");
     }
 
+    syntax_node * nodes = global_nodes;
+    syntax_node * nodea = SYNTAX_CHILDA(nodes, node);
+
     // Update nodes.
-    syntax_execute_nodetype(node->nodea);
+    SYNTAX_RUN(nodea);
 
-    // Update param in the symbol table.
-    symbol_assign(global_table, list->identifier, node->nodea->value);
+    // Update param in the frame.
+    frame[list->offset] = nodea->value;
 
     // Execute next args.
-    syntax_update_args(node->nodeb, list->next);
+    syntax_update_args(SYNTAX_NODEB(node), list->next, frame);
 }
 
 /**
  * Syntax Operate ID updates the value in the node with the one
- * from the symbol table.
+ * from the slot of the symbol table it was bound to while parsing.
  * @param   node    Node to run
  */
 void syntax_operate_identifier(syntax_node * node) {
@@ -993,5 +1696,13 @@ void syntax_operate_identifier(syntax_node * node) {
     if (node == NULL) return;
 
     // Update the value with the one from the symbol table.
-    node->value = symbol_get_value(global_table, node->identifier);
-}
\ No newline at end of file
+    node->value = global_table->values[node->slot];
+}
+/**
+ * Syntax Operate Local updates the value in the node with the one from the
+ * frame of the current call, at the offset it was bound to while parsing.
+ * @param   node    Node to run
+ */
+void syntax_operate_local(syntax_node * node) {
+    node->value = global_frame[node->slot];
+}
@@ -5,18 +5,49 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include "arena.h"
 #include "data.h"
+#include "stream.h"
 
 // Definitions
 // Node Types
 #define SYNTAX_INSTRUCTION  '0'
 #define SYNTAX_IDENTIFIER   '1'
 #define SYNTAX_VALUE        '2'
+#define SYNTAX_LOCAL        '3'
 
 // NULL Types
 #define SYNTAX_NULLV        NULL
 #define SYNTAX_NULLT        '\0'
 #define SYNTAX_NULLB        false
+#define SYNTAX_NULLD        ((data_value){ SYNTAX_NULLT })
+#define SYNTAX_NULLS        -1
+
+// Call Stack
+#define SYNTAX_STACK        65536
+
+// Memoization. Results kept per function, and the most arguments it keys.
+#define SYNTAX_MEMO_SIZE    256
+#define SYNTAX_MEMO_ARGS    8
+
+// Node Pool. Index 0 is taken by a node that is never used, so it means NULL.
+#define SYNTAX_NONE         0
+#define SYNTAX_AT(index)    \
+    ((index) == SYNTAX_NONE ? NULL : &global_nodes[index])
+#define SYNTAX_NODEA(node)  SYNTAX_AT((node)->nodea)
+#define SYNTAX_NODEB(node)  SYNTAX_AT((node)->nodeb)
+#define SYNTAX_NODEC(node)  SYNTAX_AT((node)->nodec)
+#define SYNTAX_LINE(node)   global_lines[(node) - global_nodes]
+// Children that are never NONE, such as the checked ones in the kernels, and
+// running a node that is never NULL. A handler takes the pool base once and
+// finds every child from it before running any of them.
+#define SYNTAX_CHILD(nodes, index) (&(nodes)[index])
+#define SYNTAX_CHILDA(nodes, node) SYNTAX_CHILD(nodes, (node)->nodea)
+#define SYNTAX_CHILDB(nodes, node) SYNTAX_CHILD(nodes, (node)->nodeb)
+#define SYNTAX_CHILDC(nodes, node) SYNTAX_CHILD(nodes, (node)->nodec)
+#define SYNTAX_RUN(node)    ((node)->handler(node))
 
 // Instructions
 #define SYNTAX_STMT         'S'
@@ -35,45 +66,79 @@
 
 // Declarations
 typedef struct param_list {
+    int offset;
     char * identifier;
-    data_value * value;
+    data_value value;
     struct param_list * next;
 } param_list;
-typedef struct symbol_item {
-    int key;
+typedef struct symbol_function {
     int args;
+    int size;
+    bool writes;
+    bool pure;
+    bool memoize;
+    data_value value;
+    struct param_list * list;
+    struct param_list * locals;
+    struct syntax_node * node;
+    struct data_value * memo;
+} symbol_function;
+typedef struct symbol_item {
+    unsigned int key;
+    int slot;
     char symtype;
     char * identifier;
-    struct data_value * value;
     struct param_list * list;
-    struct syntax_node * node;
+    struct symbol_function * function;
 } symbol_item;
 typedef struct symbol_table {
     int size;
+    int buckets;
+    int slots;
+    int capacity;
     char symtype;
+    struct data_value * values;
     struct symbol_item * items;
 } symbol_table;
+typedef void (* syntax_handler)(struct syntax_node *);
+typedef uint32_t syntax_index;
 typedef struct syntax_node {
+    syntax_handler handler;
+    struct data_value value;
+    syntax_index nodea;
+    syntax_index nodeb;
+    syntax_index nodec;
+    int slot;
+    bool evaluation;
     char nodetype;
     char operation;
-    bool evaluation;
     char instruction;
+    int count;
+    syntax_index * list;
+    struct symbol_function * function;
     char * identifier;
-    struct data_value * value;
-    struct syntax_node * nodea;
-    struct syntax_node * nodeb;
-    struct syntax_node * nodec;
 } syntax_node;
 
 // Global Values.
-data_value * global_value;
-symbol_table * global_table;
+extern _Thread_local syntax_node * global_nodes;
+extern _Thread_local int * global_lines;
+extern _Thread_local data_value * global_value;
+extern _Thread_local data_value * global_frame;
+extern _Thread_local data_value * global_top;
+extern _Thread_local symbol_table * global_table;
+extern _Thread_local long global_memo_hits;
+extern _Thread_local long global_memo_misses;
+extern _Thread_local jmp_buf * global_recover;
+extern _Thread_local FILE * global_errors;
 
+void syntax_arena(arena *);
+syntax_node * syntax_allocate(int);
+syntax_index syntax_locate(syntax_node *);
 void syntax_print_node(syntax_node*);
 bool syntax_check_types(syntax_node*, syntax_node*);
 syntax_node * syntax_initialize();
 syntax_node * syntax_create_node(
-    char, char, bool, char, char*, data_value*,
+    char, char, bool, char, char*, data_value,
     syntax_node*, syntax_node*, syntax_node*
 );
 syntax_node * syntax_create_expression(
@@ -86,12 +151,19 @@ syntax_node * syntax_create_term(
     char, syntax_node*, syntax_node*, syntax_node*
 );
 syntax_node * syntax_create_value(
-    char, char*, data_value*
+    char, char*, data_value
+);
+syntax_node * syntax_create_identifier(
+    char *, int, data_value
+);
+syntax_node * syntax_create_local(
+    char *, int, data_value
 );
 syntax_node * syntax_create_function(
-    char *, data_value *, syntax_node *
+    char *, int, data_value, symbol_function *, syntax_node *
 );
-syntax_node * syntax_create_stmt(syntax_node*, syntax_node*, syntax_node*);
+syntax_node * syntax_create_stmt(syntax_node*);
+syntax_node * syntax_append_stmt(syntax_node*, syntax_node*);
 syntax_node * syntax_create_assign(syntax_node*, syntax_node*, syntax_node*);
 syntax_node * syntax_create_if(syntax_node*, syntax_node*, syntax_node*);
 syntax_node * syntax_create_ifelse(syntax_node*, syntax_node*, syntax_node*);
@@ -101,10 +173,40 @@ syntax_node * syntax_create_print(syntax_node*, syntax_node*, syntax_node*);
 syntax_node * syntax_create_return(syntax_node*, syntax_node*, syntax_node*);
 syntax_node * syntax_create_arg(syntax_node*, syntax_node*, syntax_node*);
 
+void syntax_prepare(symbol_table*);
+void syntax_recover(jmp_buf*, FILE*);
+_Noreturn void syntax_fail(char*);
 void syntax_execute_nodetype(syntax_node*);
-void syntax_execute_instruction(syntax_node*);
+syntax_handler syntax_resolve_handler(char, char);
+void syntax_execute_value(syntax_node*);
+syntax_handler syntax_resolve_kernel(char, char, char);
+void syntax_operate_addi(syntax_node*);
+void syntax_operate_addf(syntax_node*);
+void syntax_operate_subi(syntax_node*);
+void syntax_operate_subf(syntax_node*);
+void syntax_operate_muli(syntax_node*);
+void syntax_operate_mulf(syntax_node*);
+void syntax_operate_divi(syntax_node*);
+void syntax_operate_divf(syntax_node*);
+void syntax_operate_negi(syntax_node*);
+void syntax_operate_negf(syntax_node*);
+void syntax_evaluate_lessi(syntax_node*);
+void syntax_evaluate_lessf(syntax_node*);
+void syntax_evaluate_greateri(syntax_node*);
+void syntax_evaluate_greaterf(syntax_node*);
+void syntax_evaluate_equalsi(syntax_node*);
+void syntax_evaluate_equalsf(syntax_node*);
+void syntax_evaluate_ltei(syntax_node*);
+void syntax_evaluate_ltef(syntax_node*);
+void syntax_evaluate_gtei(syntax_node*);
+void syntax_evaluate_gtef(syntax_node*);
+void syntax_evaluate_zeroi(syntax_node*);
+void syntax_evaluate_zerof(syntax_node*);
+void syntax_print_integer(syntax_node*);
+void syntax_print_float(syntax_node*);
 void syntax_execute_stmt(syntax_node*);
 void syntax_execute_assign(syntax_node*);
+void syntax_execute_assign_local(syntax_node*);
 void syntax_execute_if(syntax_node*);
 void syntax_execute_ifelse(syntax_node*);
 void syntax_execute_while(syntax_node*);
@@ -114,13 +216,16 @@ void syntax_evaluate_expression(syntax_node*);
 void syntax_operate_expr(syntax_node*);
 void syntax_operate_term(syntax_node*);
 void syntax_operate_identifier(syntax_node *);
+void syntax_operate_local(syntax_node *);
 void syntax_execute_function(syntax_node*);
 void syntax_execute_return(syntax_node*);
-void syntax_update_args(syntax_node*, param_list*);
+void syntax_update_args(syntax_node*, param_list*, data_value*);
+bool syntax_memo_find(symbol_function*, data_value*, data_value**);
 
-bool symbol_assign(symbol_table *, char *, data_value *);
-data_value * symbol_get_value(symbol_table *, char *);
+bool symbol_assign(symbol_table *, char *, data_value);
+data_value symbol_get_value(symbol_table *, char *);
 param_list * symbol_get_list(symbol_table *, char *);
 syntax_node * symbol_get_node(symbol_table *, char *);
+symbol_function * symbol_get_function(symbol_table *, char *);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Definitions
+// Each statement of the list takes five nodes, so the tree has more than
+// 2^31 / 64 nodes, more than fit in 2 GiB of the node pool.
+#define LARGE_STATEMENTS    7000000
+#define LARGE_LOOPS         10
+#define LARGE_LINE          256
+
+// Global Values.
+char large_program[] = "/tmp/large_treeXXXXXX";
+
+/**
+ * Large Write generates the program, a loop with an invariant product
+ * followed by a single list of LARGE_STATEMENTS statements. The optimizer
+ * hoists the product once the whole list is parsed, so the nodes it creates
+ * at the end of the pool link children from its start. It is generated
+ * instead of kept in the repository because of its size.
+ */
+void large_write() {
+    int descriptor = mkstemp(large_program);
+    FILE * file = descriptor < 0 ? NULL : fdopen(descriptor, "w");
+    if (file == NULL) {
+        printf("Large: Failed to create the program.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int i;
+    fprintf(file, "var i : int;\nvar a : int;\nvar b : int;\nvar c : int\n");
+    fprintf(file, "begin\n   a <- 3;\n   b <- 4;\n   i <- 0;\n   c <- 0;\n");
+    fprintf(file, "   while (i < %d)\n   begin\n", LARGE_LOOPS);
+    fprintf(file, "      c <- c + a * b;\n      i <- i + 1\n   end;\n");
+    for (i=0; i<LARGE_STATEMENTS; i++) fprintf(file, "   c <- c + 1;\n");
+    fprintf(file, "   print c\nend\n");
+    fclose(file);
+}
+
+/**
+ * Large Main optimizes and runs the generated program with the interpreter
+ * and checks the value it prints.
+ *
+ *   large_tree.out [interpreter]
+ */
+int main(int argc, char * argv[]) {
+    char * interpreter = argc > 1 ? argv[1] : "./run.out";
+    char command[LARGE_LINE + sizeof(large_program)];
+    char expected[LARGE_LINE];
+    char line[LARGE_LINE];
+    int found = 0;
+
+    large_write();
+    snprintf(command, sizeof(command), "%s %s 2>&1", interpreter,
+        large_program);
+    snprintf(expected, sizeof(expected), "The value is %d\n",
+        LARGE_STATEMENTS + LARGE_LOOPS * 12);
+
+    FILE * output = popen(command, "r");
+    if (output == NULL) {
+        printf("Large: Failed to start the interpreter.\n");
+        unlink(large_program);
+        return 1;
+    }
+    while (fgets(line, sizeof(line), output) != NULL) {
+        if (strcmp(line, expected) == 0) found = 1;
+        else if (!found) fputs(line, stdout);
+    }
+    int status = pclose(output);
+    unlink(large_program);
+
+    if (status != 0 || !found) {
+        printf("Large: The program of %d statements failed.\n",
+            LARGE_STATEMENTS);
+        return 1;
+    }
+    printf("Large: The program of %d statements passed.\n", LARGE_STATEMENTS);
+    return 0;
+}